@@ -1,9 +1,45 @@
 #version 450
 
-layout(location = 0) in vec4 fragColor;
+// Must match ShadingMode in include/renderer.h.
+#define SHADING_MODE_SHADED     0
+#define SHADING_MODE_WIREFRAME  1
+#define SHADING_MODE_NORMALS    2
+#define SHADING_MODE_XRAY       3
+#define SHADING_MODE_FACE_COLOR 4
+
+// Set per pipeline variant, the branches on it are compiled out.
+layout(constant_id = 0) const int SHADING_MODE = SHADING_MODE_NORMALS;
+
+layout(location = 0) in vec4 fragColor; // Absolute value of the face normal.
+layout(location = 1) flat in uint fragFaceId;
 
 layout(location = 0) out vec4 outColor;
 
+vec3 hashColor(uint id) {
+    id ^= id >> 16;
+    id *= 0x7feb352du;
+    id ^= id >> 15;
+    id *= 0x846ca68bu;
+    id ^= id >> 16;
+    return vec3(uvec3(id, id >> 8, id >> 16) & 0xffu) / 255.0;
+}
+
 void main() {
-    outColor = fragColor;
+    if (SHADING_MODE == SHADING_MODE_SHADED) {
+        // Headlight along the view axis, the model is projected onto the XY plane.
+        outColor = vec4(vec3(0.15 + 0.75 * fragColor.z), 1.0);
+    }
+    else if (SHADING_MODE == SHADING_MODE_WIREFRAME) {
+        outColor = vec4(0.05, 0.05, 0.05, 1.0);
+    }
+    else if (SHADING_MODE == SHADING_MODE_XRAY) {
+        // Blended additively, overlapping layers get brighter.
+        outColor = vec4(0.9, 0.95, 1.0, 0.08);
+    }
+    else if (SHADING_MODE == SHADING_MODE_FACE_COLOR) {
+        outColor = vec4(hashColor(fragFaceId), 1.0);
+    }
+    else {
+        outColor = fragColor;
+    }
 }
@@ -4,8 +4,12 @@ layout(location = 0) in vec2 inPosition;
 layout(location = 1) in vec4 inColor;
 
 layout(location = 0) out vec4 fragColor;
+layout(location = 1) flat out uint fragFaceId;
 
 void main() {
     gl_Position = vec4(inPosition, 0.0, 1.0);
     fragColor = inColor;
+    // The meshes are drawn without an index buffer, three vertices per triangle. Reading gl_PrimitiveID in the
+    // fragment shader would need the geometry shader feature.
+    fragFaceId = uint(gl_VertexIndex) / 3u;
 }
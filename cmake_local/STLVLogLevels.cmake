@@ -0,0 +1,34 @@
+set(STLV_LOG_LEVEL_NAMES TRACE DEBUG INFO WARN ERR FATAL)
+set(STLV_LOG_TAG_NAMES APP INPUT_EVENTS RENDERER VULKAN_VALIDATION X11_PLATFORM LOADER)
+
+# Converts a level name to the AsyncLogger::Level value the code expects.
+function(stlv_log_level_to_index level_name out_var)
+    string(TOUPPER "${level_name}" level_name)
+    list(FIND STLV_LOG_LEVEL_NAMES "${level_name}" level_idx)
+    if(level_idx LESS 0)
+        log_fatal("Unknown log level: ${level_name}. Expected one of: ${STLV_LOG_LEVEL_NAMES}")
+    endif()
+    set(${out_var} ${level_idx} PARENT_SCOPE)
+endfunction()
+
+# Compiles out log calls below the configured levels. STLV_LOG_MIN_LEVEL applies to every tag and
+# STLV_LOG_MIN_LEVEL_<TAG> overrides it for one tag.
+macro(stlv_target_set_log_levels target is_debug)
+    if(STLV_LOG_MIN_LEVEL)
+        set(_stlv_default_level ${STLV_LOG_MIN_LEVEL})
+    elseif(${is_debug})
+        set(_stlv_default_level TRACE)
+    else()
+        set(_stlv_default_level INFO)
+    endif()
+
+    stlv_log_level_to_index(${_stlv_default_level} _stlv_level_idx)
+    target_compile_definitions(${target} PRIVATE STLV_LOG_MIN_LEVEL=${_stlv_level_idx})
+
+    foreach(_stlv_tag ${STLV_LOG_TAG_NAMES})
+        if(STLV_LOG_MIN_LEVEL_${_stlv_tag})
+            stlv_log_level_to_index(${STLV_LOG_MIN_LEVEL_${_stlv_tag}} _stlv_level_idx)
+            target_compile_definitions(${target} PRIVATE STLV_LOG_MIN_LEVEL_${_stlv_tag}=${_stlv_level_idx})
+        endif()
+    endforeach()
+endmacro()
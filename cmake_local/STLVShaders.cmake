@@ -0,0 +1,63 @@
+# Per shader build rules. Every shader is its own custom command, so only the shaders whose source or #include-d files
+# changed are rebuilt, and the generator runs them in parallel. For each <name> in the output directory:
+#   <name>.spirv      - loaded at runtime with --shader-dir, or when the shaders are not embedded
+#   <name>.spirv.inc  - the same SPIR-V as comma separated words, included by src/embedded_shaders.cpp
+#   <name>.debug.src  - copy of the source, logged in debug builds
+
+# Ninja understands glslc's depfiles natively, the other generators only from the versions below.
+if(POLICY CMP0116)
+    cmake_policy(SET CMP0116 NEW)
+endif()
+
+find_program(GLSLC_EXECUTABLE glslc HINTS "$ENV{VULKAN_SDK}/bin" "$ENV{VULKAN_SDK}/Bin")
+if(NOT GLSLC_EXECUTABLE)
+    log_fatal("glslc not found. Install the Vulkan SDK or add glslc to the PATH.")
+endif()
+
+if(CMAKE_GENERATOR MATCHES "Ninja" OR
+   (CMAKE_GENERATOR MATCHES "Makefiles" AND NOT CMAKE_VERSION VERSION_LESS 3.20) OR
+   NOT CMAKE_VERSION VERSION_LESS 3.21)
+    set(STLV_SHADER_DEPFILES ON)
+else()
+    set(STLV_SHADER_DEPFILES OFF)
+    log_info("Shader #include dependencies are not tracked with the ${CMAKE_GENERATOR} generator on CMake ${CMAKE_VERSION}")
+endif()
+
+# Adds a target that builds the given shader sources into out_dir.
+function(stlv_add_shaders target out_dir)
+    set(shader_outputs)
+
+    foreach(shader_src ${ARGN})
+        get_filename_component(shader_src "${shader_src}" ABSOLUTE)
+        get_filename_component(shader_name "${shader_src}" NAME)
+
+        set(spirv "${out_dir}/${shader_name}.spirv")
+        set(spirv_inc "${out_dir}/${shader_name}.spirv.inc")
+        set(debug_src "${out_dir}/${shader_name}.debug.src")
+        set(depfile "${out_dir}/${shader_name}.d")
+
+        if(STLV_SHADER_DEPFILES)
+            set(depfile_args -MD -MF "${depfile}" -MT "${spirv}")
+            set(depfile_option DEPFILE "${depfile}")
+        else()
+            set(depfile_args)
+            set(depfile_option)
+        endif()
+
+        add_custom_command(
+            OUTPUT "${spirv}" "${spirv_inc}" "${debug_src}"
+            COMMAND ${CMAKE_COMMAND} -E make_directory "${out_dir}"
+            COMMAND ${GLSLC_EXECUTABLE} ${depfile_args} "${shader_src}" -o "${spirv}"
+            COMMAND ${GLSLC_EXECUTABLE} "${shader_src}" -mfmt=num -o "${spirv_inc}"
+            COMMAND ${CMAKE_COMMAND} -E copy "${shader_src}" "${debug_src}"
+            MAIN_DEPENDENCY "${shader_src}"
+            ${depfile_option}
+            COMMENT "Compiling shader ${shader_name}"
+            VERBATIM
+        )
+
+        list(APPEND shader_outputs "${spirv}" "${spirv_inc}" "${debug_src}")
+    endforeach()
+
+    add_custom_target(${target} ALL DEPENDS ${shader_outputs})
+endfunction()
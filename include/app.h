@@ -2,12 +2,24 @@
 
 #include <basic.h>
 #include <app_error.h>
+#include <frame_pacer.h>
 
 struct ApplicationInfo {
     const char* appName;
     const char* windowTitle;
     i32 initWindowWidth;
     i32 initWindowHeight;
+    const char* stlFilePath; // Optional, the model to open and watch for changes.
+    bool measureLatency; // Collect input to present latency histograms.
+    PacingMode pacingMode;
+    u32 frameLimitFps; // 0 means no limit.
+    u32 framesInFlight; // 1 to 3.
+    u32 msaaSamples; // 1 disables MSAA.
+    bool assertNoFrameAllocs; // Fail when the frame loop allocates in steady state.
+    const char* logFilePath; // Optional, logs go to stdout and this file.
+    bool fastExit; // Skip the teardown on exit, see Application::fastExit.
+    const char* shaderDir; // Optional, compiled shaders to load instead of the embedded ones.
+    bool hotReloadShaders; // Recompile and swap in the shaders when their sources change. Development only.
 };
 
 struct Application {
@@ -15,4 +27,9 @@ struct Application {
     [[nodiscard]] static core::expected<AppError> init(const ApplicationInfo& appInfo);
     [[nodiscard]] static core::expected<AppError> start();
     static void shutdown();
+
+    // Flushes everything that has to reach the disk or the terminal and terminates the process without destroying
+    // anything. The OS and the driver reclaim the memory and the GPU objects much faster than tearing them down one by
+    // one. The validation layers only report leaks on a full shutdown, so debug builds default to it.
+    [[noreturn]] static void fastExit(i32 exitCode);
 };
@@ -9,6 +9,11 @@ struct PlatformError {
     enum struct Type : i32 {
         FAILED_TO_INITIALIZE_CORE_LOGGER,
         FAILED_TO_LOAD_SHADER,
+        FAILED_TO_LOAD_STL_FILE,
+        FAILED_TO_PARSE_STL_FILE,
+        FAILED_TO_INITIALIZE_FILE_WATCHER,
+        FAILED_TO_WATCH_FILE,
+        HEAP_ALLOCATION_IN_FRAME_LOOP,
 
         FAILED_TO_CREATE_X11_DISPLAY,
         FAILED_TO_CREATE_X11_WINDOW,
@@ -59,6 +64,7 @@ enum struct RendererError : i32 {
     FAILED_TO_ALLOCATE_VULKAN_COMMAND_BUFFER,
     FAILED_TO_ALLOCATE_VULKAN_SEMAPHORE,
     FAILED_TO_ALLOCATE_VULKAN_FENCE,
+    FAILED_TO_CREATE_VULKAN_COMPUTE_PIPELINE,
 };
 
 struct AppError {
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <async_logger.h>
 #include <basic.h>
+#include <core_logger.h>
 
 // Logger tags for the different subsystems.
 enum AppLogTags : u8 {
@@ -8,7 +10,8 @@ enum AppLogTags : u8 {
     INPUT_EVENTS_TAG = 1,
     RENDERER_TAG = 2,
     VULKAN_VALIDATION_TAG = 3,
-    X11_PLATFORM_TAG = 4
+    X11_PLATFORM_TAG = 4,
+    LOADER_TAG = 5,
 };
 
 constexpr core::StrView appLogTagsToCStr(AppLogTags t) {
@@ -18,7 +21,90 @@ constexpr core::StrView appLogTagsToCStr(AppLogTags t) {
         case RENDERER_TAG:          return "RENDERER"_sv;
         case VULKAN_VALIDATION_TAG: return "VK_VALIDATION"_sv;
         case X11_PLATFORM_TAG:      return "X11_PLATFORM_TAG"_sv;
+        case LOADER_TAG:            return "LOADER"_sv;
     }
 
     return "UNKNOWN"_sv;
 }
+
+// Compile time minimum level per tag, as AsyncLogger::Level values. Calls below it compile to nothing, the evaluation
+// of their arguments included. Set from CMake with STLV_LOG_MIN_LEVEL and the per tag STLV_LOG_MIN_LEVEL_<TAG>
+// overrides. The runtime level and tag filters still apply on top of this.
+#ifndef STLV_LOG_MIN_LEVEL
+    #define STLV_LOG_MIN_LEVEL 0
+#endif
+#ifndef STLV_LOG_MIN_LEVEL_APP
+    #define STLV_LOG_MIN_LEVEL_APP STLV_LOG_MIN_LEVEL
+#endif
+#ifndef STLV_LOG_MIN_LEVEL_INPUT_EVENTS
+    #define STLV_LOG_MIN_LEVEL_INPUT_EVENTS STLV_LOG_MIN_LEVEL
+#endif
+#ifndef STLV_LOG_MIN_LEVEL_RENDERER
+    #define STLV_LOG_MIN_LEVEL_RENDERER STLV_LOG_MIN_LEVEL
+#endif
+#ifndef STLV_LOG_MIN_LEVEL_VULKAN_VALIDATION
+    #define STLV_LOG_MIN_LEVEL_VULKAN_VALIDATION STLV_LOG_MIN_LEVEL
+#endif
+#ifndef STLV_LOG_MIN_LEVEL_X11_PLATFORM
+    #define STLV_LOG_MIN_LEVEL_X11_PLATFORM STLV_LOG_MIN_LEVEL
+#endif
+#ifndef STLV_LOG_MIN_LEVEL_LOADER
+    #define STLV_LOG_MIN_LEVEL_LOADER STLV_LOG_MIN_LEVEL
+#endif
+
+constexpr AsyncLogger::Level appLogTagMinLevel(AppLogTags t) {
+    switch (t) {
+        case APP_TAG:               return AsyncLogger::Level(STLV_LOG_MIN_LEVEL_APP);
+        case INPUT_EVENTS_TAG:      return AsyncLogger::Level(STLV_LOG_MIN_LEVEL_INPUT_EVENTS);
+        case RENDERER_TAG:          return AsyncLogger::Level(STLV_LOG_MIN_LEVEL_RENDERER);
+        case VULKAN_VALIDATION_TAG: return AsyncLogger::Level(STLV_LOG_MIN_LEVEL_VULKAN_VALIDATION);
+        case X11_PLATFORM_TAG:      return AsyncLogger::Level(STLV_LOG_MIN_LEVEL_X11_PLATFORM);
+        case LOADER_TAG:            return AsyncLogger::Level(STLV_LOG_MIN_LEVEL_LOADER);
+    }
+
+    return AsyncLogger::Level(STLV_LOG_MIN_LEVEL);
+}
+
+// Fatal messages are never compiled out.
+constexpr bool appLogIsCompiledIn(AsyncLogger::Level level, AppLogTags tag) {
+    return level == AsyncLogger::Level::FATAL || u8(level) >= u8(appLogTagMinLevel(tag));
+}
+
+#define STLV_LOG_TAGGED(level, tag, ...)                                  \
+    do {                                                                  \
+        if constexpr (appLogIsCompiledIn(level, tag)) {                   \
+            AsyncLogger::log(level, u8(tag), __VA_ARGS__);                \
+        }                                                                 \
+    } while (0)
+
+// The core logging macros, routed through the async backend. Logging inside core itself is unaffected.
+#undef logTrace
+#undef logDebug
+#undef logInfo
+#undef logWarn
+#undef logErr
+#undef logFatal
+#undef logTraceTagged
+#undef logDebugTagged
+#undef logInfoTagged
+#undef logWarnTagged
+#undef logErrTagged
+#undef logFatalTagged
+#undef logSectionTitleInfoTagged
+
+#define logTraceTagged(tag, ...) STLV_LOG_TAGGED(AsyncLogger::Level::TRACE, tag, __VA_ARGS__)
+#define logDebugTagged(tag, ...) STLV_LOG_TAGGED(AsyncLogger::Level::DEBUG, tag, __VA_ARGS__)
+#define logInfoTagged(tag, ...)  STLV_LOG_TAGGED(AsyncLogger::Level::INFO,  tag, __VA_ARGS__)
+#define logWarnTagged(tag, ...)  STLV_LOG_TAGGED(AsyncLogger::Level::WARN,  tag, __VA_ARGS__)
+#define logErrTagged(tag, ...)   STLV_LOG_TAGGED(AsyncLogger::Level::ERR,   tag, __VA_ARGS__)
+#define logFatalTagged(tag, ...) STLV_LOG_TAGGED(AsyncLogger::Level::FATAL, tag, __VA_ARGS__)
+
+#define logTrace(...) logTraceTagged(APP_TAG, __VA_ARGS__)
+#define logDebug(...) logDebugTagged(APP_TAG, __VA_ARGS__)
+#define logInfo(...)  logInfoTagged(APP_TAG, __VA_ARGS__)
+#define logWarn(...)  logWarnTagged(APP_TAG, __VA_ARGS__)
+#define logErr(...)   logErrTagged(APP_TAG, __VA_ARGS__)
+#define logFatal(...) logFatalTagged(APP_TAG, __VA_ARGS__)
+
+#define logSectionTitleInfoTagged(tag, title) \
+    logInfoTagged(tag, "-------------------- {} --------------------", title)
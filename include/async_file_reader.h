@@ -0,0 +1,45 @@
+#pragma once
+
+#include <basic.h>
+
+struct WorkerPool;
+
+// Batched whole-file reads for the loader. On Linux the reads go through io_uring, which keeps many large chunked reads
+// in flight across files from a single thread. Everywhere else, or when io_uring is not available, every file is read
+// with pread on a pool of I/O threads. In both cases each completed buffer is handed to the parser pool as soon as its
+// last chunk lands.
+struct AsyncFileReader {
+    enum struct Backend : u8 {
+        IO_URING,
+        THREAD_POOL,
+    };
+
+    struct Completion {
+        const char* path = nullptr;
+        void* userData = nullptr;
+        core::ArrList<u8> data; // Owned by the completion callback, move it out to keep it.
+        i32 errCode = 0; // errno style error code, 0 on success.
+    };
+
+    // Runs on a parser pool thread.
+    using CompletionCallback = void (*)(Completion& completion);
+
+    struct ReadRequest {
+        const char* path = nullptr;
+        void* userData = nullptr;
+    };
+
+    struct BatchInfo {
+        core::Memory<const ReadRequest> requests;
+        CompletionCallback onComplete = nullptr;
+        WorkerPool* parserPool = nullptr;
+        Backend preferredBackend = Backend::IO_URING;
+        u32 maxReadsInFlight = 64;
+        u32 chunkSize = 1024 * 1024;
+    };
+
+    // Blocks until every file is read and every completion callback has returned. Returns the backend that did the reads.
+    static Backend readBatch(const BatchInfo& info);
+
+    static const char* backendToCStr(Backend backend);
+};
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <basic.h>
+
+#include <type_traits>
+
+// Logging backend that keeps the writes off the threads that log. A call checks the level and the tag, formats the
+// message into a fixed size record on the stack, and pushes the record into a preallocated lock-free ring. A
+// background thread drains the ring and writes to stdout and, optionally, a file. When the ring is full the message
+// is dropped and counted instead of blocking the caller, and the writer reports the count.
+//
+// Until start() is called, and after stop(), messages are written synchronously on the calling thread. Fatal messages
+// are always written synchronously after everything queued before them.
+//
+// The app_logger.h macros route through here. Formatting understands "{}" placeholders only.
+struct AsyncLogger {
+    enum struct Level : u8 {
+        TRACE,
+        DEBUG,
+        INFO,
+        WARN,
+        ERR,
+        FATAL,
+
+        COUNT
+    };
+
+    static constexpr u32 RING_CAPACITY = 2048;
+    static constexpr u32 MAX_MESSAGE_LEN = 480; // Longer messages are truncated.
+    static constexpr u32 MAX_TAGS = 64;
+    static constexpr u32 IDLE_SLEEP_MS = 2;
+
+    struct Record {
+        u64 timestampNs;
+        Level level;
+        u8 tag;
+        u16 len;
+        char msg[MAX_MESSAGE_LEN];
+    };
+
+    // filePath is optional. Main thread only.
+    static void start(const char* filePath, bool useAnsi);
+    static void stop(); // Writes everything still queued.
+    static bool isRunning();
+
+    // Blocks until everything logged before the call is written.
+    static void flush();
+
+    static u64 droppedCount();
+
+    static void setLevel(Level level);
+    static void setTagEnabled(u8 tag, bool enabled);
+    static bool isEnabled(Level level, u8 tag);
+
+    template <typename... Args>
+    static void log(Level level, u8 tag, const char* fmt, const Args&... args) {
+        if (!isEnabled(level, tag)) return;
+
+        Record r;
+        r.level = level;
+        r.tag = tag;
+        FormatBuffer out = { r.msg, 0 };
+        formatImpl(out, fmt, args...);
+        r.len = u16(out.len);
+        submit(r);
+    }
+
+private:
+    struct FormatBuffer {
+        char* data;
+        addr_size len;
+
+        void put(char c) {
+            if (len < MAX_MESSAGE_LEN) data[len++] = c;
+        }
+        void put(const char* s, addr_size n) {
+            for (addr_size i = 0; i < n && len < MAX_MESSAGE_LEN; i++) data[len++] = s[i];
+        }
+    };
+
+    static void submit(Record& r);
+
+    static void writeStr(FormatBuffer& out, const char* s);
+    static void writeU64(FormatBuffer& out, u64 v);
+    static void writeI64(FormatBuffer& out, i64 v);
+    static void writeF64(FormatBuffer& out, f64 v);
+    static void writePtr(FormatBuffer& out, const void* p);
+
+    template <typename T>
+    static void writeArg(FormatBuffer& out, const T& v) {
+        using U = std::decay_t<T>;
+        if constexpr (std::is_same_v<U, bool>) {
+            writeStr(out, v ? "true" : "false");
+        }
+        else if constexpr (std::is_same_v<U, char>) {
+            out.put(v);
+        }
+        else if constexpr (std::is_convertible_v<const T&, const char*>) {
+            writeStr(out, static_cast<const char*>(v));
+        }
+        else if constexpr (std::is_same_v<U, core::StrView>) {
+            out.put(v.data(), v.len());
+        }
+        else if constexpr (std::is_enum_v<U>) {
+            writeArg(out, static_cast<std::underlying_type_t<U>>(v));
+        }
+        else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+            writeI64(out, i64(v));
+        }
+        else if constexpr (std::is_integral_v<U>) {
+            writeU64(out, u64(v));
+        }
+        else if constexpr (std::is_floating_point_v<U>) {
+            writeF64(out, f64(v));
+        }
+        else if constexpr (std::is_pointer_v<U>) {
+            writePtr(out, static_cast<const void*>(v));
+        }
+        else {
+            static_assert(sizeof(T) == 0, "Unsupported log argument type");
+        }
+    }
+
+    static const char* copyUntilPlaceholder(FormatBuffer& out, const char* fmt);
+
+    static void formatImpl(FormatBuffer& out, const char* fmt) {
+        while (*fmt) out.put(*fmt++);
+    }
+
+    template <typename T, typename... Rest>
+    static void formatImpl(FormatBuffer& out, const char* fmt, const T& first, const Rest&... rest) {
+        fmt = copyUntilPlaceholder(out, fmt);
+        if (*fmt == '\0') return; // More arguments than placeholders.
+        writeArg(out, first);
+        formatImpl(out, fmt + 2, rest...);
+    }
+};
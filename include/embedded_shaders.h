@@ -0,0 +1,11 @@
+#pragma once
+
+#include <basic.h>
+
+// SPIR-V of the shaders in assets/shaders, compiled by the CompileShaders target and built into the executable. Creating
+// the shader modules does not touch the disk, and the executable does not depend on the build directory.
+struct EmbeddedShaders {
+    // The name is the source file name, e.g. "mesh_shader.vert". Empty when the shader is unknown or the build does not
+    // embed shaders (STLV_EMBED_SHADERS=OFF).
+    static core::Memory<const u32> find(const char* name);
+};
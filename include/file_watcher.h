@@ -0,0 +1,27 @@
+#pragma once
+
+#include <basic.h>
+#include <app_error.h>
+
+// Watches files for changes from a background thread. The parent directory is watched instead of the file itself, so
+// editors and exporters that save by writing a temporary file and renaming it over the original are picked up as well.
+// Bursts of writes are coalesced and the callback fires once the file has been quiet for DEBOUNCE_MS.
+//
+// init and shutdown are counted, so independent users can share the watcher thread. Only the last shutdown stops it,
+// so every user has to unwatch its files before it tears down whatever its callback uses.
+//
+// Only implemented on Linux (inotify), on other platforms watch() always fails.
+struct FileWatcher {
+    // Runs on the watcher thread.
+    using ChangeCallback = void (*)(const char* path, void* userData);
+
+    static constexpr u32 MAX_WATCHED_FILES = 16;
+    static constexpr u32 MAX_PATH_LEN = 1024;
+    static constexpr u32 DEBOUNCE_MS = 100;
+
+    [[nodiscard]] static core::expected<AppError> init();
+    static bool watch(const char* path, ChangeCallback cb, void* userData);
+    // Once this returns the callback is not running for the path and will not be called for it again.
+    static void unwatch(const char* path, ChangeCallback cb);
+    static void shutdown();
+};
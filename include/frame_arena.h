@@ -0,0 +1,44 @@
+#pragma once
+
+#include <basic.h>
+
+#include <type_traits>
+
+// Bump allocator for data that lives for a single frame: draw lists, culling results, the scratch arrays Vulkan
+// queries are read into. There is one arena per frame in flight, reset once the GPU is done with that frame, so
+// anything allocated while recording a frame stays valid until the frame's work has completed.
+//
+// Nothing is freed individually and nothing is constructed or destroyed, only trivial types go in. When a frame needs
+// more than the arena holds the rest comes from the heap, and the next reset grows the arena to the high water mark, so
+// after the first few frames of a new workload the arena never touches the heap.
+struct FrameArena {
+    static constexpr addr_size DEFAULT_CAPACITY = 64 * core::CORE_KILOBYTE;
+    static constexpr addr_size MAX_ALIGNMENT = 16;
+
+    struct OverflowBlock;
+
+    u8* data = nullptr;
+    addr_size capacity = 0;
+    addr_size used = 0;
+    addr_size highWater = 0; // Including the overflow, since the last reset.
+    u64 overflowCount = 0; // Heap allocations made since the arena was created.
+    OverflowBlock* overflow = nullptr;
+
+    [[nodiscard]] static FrameArena create(addr_size capacity = DEFAULT_CAPACITY);
+    static void destroy(FrameArena& arena);
+
+    // Invalidates everything allocated since the previous reset.
+    static void reset(FrameArena& arena);
+
+    [[nodiscard]] static void* alloc(FrameArena& arena, addr_size size, addr_size alignment);
+
+    template <typename T>
+    [[nodiscard]] static core::Memory<T> allocArr(FrameArena& arena, addr_size count) {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+                      "The arena does not run constructors or destructors");
+        static_assert(alignof(T) <= MAX_ALIGNMENT);
+        if (count == 0) return {};
+        T* ptr = reinterpret_cast<T*>(alloc(arena, count * sizeof(T), alignof(T)));
+        return { ptr, count };
+    }
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <basic.h>
+
+// How frames are paced against the display. Maps to a swapchain present mode, falling back to FIFO, which every
+// driver supports.
+enum struct PacingMode : u8 {
+    UNCAPPED,     // IMMEDIATE. As fast as possible, tears.
+    LOW_LATENCY,  // MAILBOX. Renders unthrottled, the newest image replaces the queued one on every vertical blank.
+    POWER_SAVING, // FIFO with the CPU frame limiter on, so the GPU idles between frames.
+    ADAPTIVE,     // FIFO_RELAXED. Synced, but a late frame is shown right away instead of waiting for the next blank.
+
+    COUNT
+};
+
+const char* pacingModeToCStr(PacingMode mode);
+bool pacingModeFromCStr(const char* str, PacingMode& out);
+
+// CPU side frame limiter. waitForNextFrame is called at the top of the frame loop, before input is sampled, so the
+// time spent waiting does not add to the input latency of the frame that follows.
+//
+// Sleeping alone overshoots by the scheduler granularity (~50us on Linux, up to 15ms on Windows). The limiter sleeps
+// until a margin before the deadline and spins the rest, learning the margin from the overshoot it observes.
+struct FramePacer {
+    static constexpr u32 POWER_SAVING_DEFAULT_FPS = 30;
+    static constexpr u64 MAX_SLEEP_MARGIN_NS = 4 * 1000 * 1000;
+
+    // frameLimitFps = 0 disables the limiter, except in POWER_SAVING mode where it falls back to the default.
+    static void init(PacingMode mode, u32 frameLimitFps);
+
+    // Runtime settings, main thread only. Changing the mode recreates the swapchain with the new present mode.
+    static void setMode(PacingMode mode);
+    static void setFrameLimit(u32 fps);
+    static PacingMode mode();
+    static u32 effectiveFrameLimit(); // 0 when the limiter is off.
+
+    static void waitForNextFrame();
+};
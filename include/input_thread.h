@@ -0,0 +1,27 @@
+#pragma once
+
+#include <basic.h>
+#include <user_input.h>
+
+// Pumps the OS event queue on a dedicated thread and hands the events to the render thread through a lock-free single
+// producer, single consumer queue. A long frame then no longer delays input handling, window close, or the replies the
+// window manager expects.
+//
+// Only X11 allows pumping events away from the thread that owns the window. On other platforms SUPPORTED is false and
+// the application keeps calling Platform::pollEvents from its frame loop.
+struct InputThread {
+#if defined(USE_X11)
+    static constexpr bool SUPPORTED = true;
+#else
+    static constexpr bool SUPPORTED = false;
+#endif
+
+    static constexpr u32 CHANNEL_CAPACITY = 2048;
+
+    static void start();
+    static void stop();
+
+    // Render thread only.
+    static bool pop(InputEvent& out);
+    static u64 droppedCount();
+};
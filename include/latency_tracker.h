@@ -0,0 +1,49 @@
+#pragma once
+
+#include <basic.h>
+#include <user_input.h>
+
+// Input to photon latency measurement. Every input event is stamped when the platform layer reads it. The frame that
+// first consumes it records when vkQueuePresentKHR returned and, with VK_KHR_present_wait, when the image was actually
+// presented. Latencies are collected into per-kind histograms, summarized periodically, and dumped in full on shutdown.
+//
+// Disabled by default. Everything is a no-op until init(true) is called.
+struct LatencyTracker {
+    enum struct InputKind : u8 {
+        CLICK, // Mouse button press.
+        DRAG,  // Mouse move while a button is held.
+        KEY,   // Key press.
+
+        COUNT
+    };
+
+    enum struct Stage : u8 {
+        PRESENT_RETURNED,  // vkQueuePresentKHR returned, the image is queued for presentation.
+        PRESENT_COMPLETED, // vkWaitForPresentKHR returned, the image is on screen.
+
+        COUNT
+    };
+
+    static constexpr u32 MAX_SAMPLES_PER_FRAME = 64;
+    static constexpr u32 MAX_FRAMES_AWAITING_PRESENT = 16;
+    static constexpr u32 HISTOGRAM_BUCKET_US = 500;
+    static constexpr u32 HISTOGRAM_BUCKETS = 256; // The last bucket collects everything above ~128ms.
+    static constexpr u32 REPORT_INTERVAL_SEC = 5;
+
+    static void init(bool enabled);
+    static void shutdown(); // Logs the full histograms.
+    static bool isEnabled();
+
+    // Called for every event the application consumes before drawing the next frame.
+    static void recordInput(const InputEvent& ev);
+
+    // Called right after vkQueuePresentKHR returned for a frame. presentId is 0 when present wait is not available.
+    // Returns true when the frame carried input and its present completion should be reported.
+    static bool framePresented(u64 presentId);
+
+    // Called from the present wait thread. Images are presented in order, so ids arrive in increasing order.
+    static void framePresentCompleted(u64 presentId, u64 timestampNs);
+
+    static const char* inputKindToCStr(InputKind kind);
+    static const char* stageToCStr(Stage stage);
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <basic.h>
+
+// Subsystems heap allocations are attributed to. Every thread starts in GENERAL and switches with a MemoryScope.
+enum struct MemSubsystem : u8 {
+    GENERAL,
+    PLATFORM,
+    RENDERER,
+    LOADER,
+    MESH_PROCESSING,
+
+    COUNT
+};
+
+const char* memSubsystemToCStr(MemSubsystem subsystem);
+
+// Allocator registered as the core default allocator. Every block carries a small header with its size and the
+// subsystem that allocated it, so a block freed by another subsystem (a mesh parsed by the loader and released by the
+// renderer) is still taken off the right counters.
+//
+// Only allocations that go through core are seen. std containers and the Vulkan driver allocate on their own.
+struct TaggedStatsAllocator {
+    static constexpr addr_size HEADER_SIZE = 16; // Keeps the malloc alignment of the returned pointer.
+
+    void* alloc(addr_size count, addr_size size) noexcept;
+    void* calloc(addr_size count, addr_size size) noexcept;
+    void free(void* ptr, addr_size count, addr_size size) noexcept;
+    void clear() noexcept;
+    addr_size totalMemoryAllocated() noexcept;
+    addr_size inUseMemory() noexcept;
+};
+
+// Sets the subsystem of the calling thread for as long as it is alive. Scopes nest.
+struct MemoryScope {
+    explicit MemoryScope(MemSubsystem subsystem);
+    ~MemoryScope();
+
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+
+private:
+    MemSubsystem m_previous;
+};
+
+struct MemoryTracker {
+    struct Stats {
+        addr_size inUse;
+        addr_size peak;
+        addr_size totalAllocated;
+        u64 allocationsCount;
+    };
+
+    static constexpr u32 REPORT_INTERVAL_SEC = 10;
+    static constexpr u32 NO_ALLOC_WARMUP_FRAMES = 120;
+
+    static TaggedStatsAllocator& allocator();
+
+    static Stats stats(MemSubsystem subsystem);
+    static void logReport();
+
+    // Allocations made by the calling thread, in any subsystem.
+    static u64 threadAllocationsCount();
+
+    // Called once per frame from the frame loop. Logs a report every REPORT_INTERVAL_SEC.
+    static void update();
+
+    // No allocation mode for the frame loop. Once NO_ALLOC_WARMUP_FRAMES frames in a row ran without a resize, mesh
+    // swap or any other expected reallocation, frameEnd returns false for a frame that allocated on the main thread.
+    static void enableNoAllocCheck(bool enabled);
+    static bool isNoAllocCheckEnabled();
+    static void frameBegin();
+    [[nodiscard]] static bool frameEnd();
+    static void restartSteadyState(); // The current frame is expected to allocate.
+};
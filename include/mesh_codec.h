@@ -0,0 +1,46 @@
+#pragma once
+
+#include <basic.h>
+
+struct StlMesh;
+
+// Compact encodings for preprocessed meshes in the on-disk cache.
+//
+// Positions are quantized to 16 bits per axis over the mesh bounds. Each axis is delta encoded against the previous
+// vertex, zigzag encoded and split into a low and a high byte plane. Every plane is stored in groups of 16 bytes, where
+// each group uses 0, 2, 4 or 8 bits per byte, selected by a 2 bit header.
+//
+// Indices are stored as LEB128 varints. Since welding emits vertices in first-use order, an index is either the next
+// unseen vertex (encoded as 0) or a zigzag delta from the previous index.
+struct MeshCodec {
+    static constexpr u32 POSITIONS_MAGIC = 0x50564C53; // "SLVP"
+    static constexpr u32 INDICES_MAGIC = 0x49564C53; // "SLVI"
+    static constexpr addr_size BLOCK_SIZE = 256;
+    static constexpr addr_size GROUP_SIZE = 16;
+
+    struct QuantizedMesh {
+        core::ArrList<u16> positions; // x, y, z per vertex.
+        core::ArrList<u32> indices; // 3 per triangle.
+        f32 offset[3] = {};
+        f32 scale[3] = {}; // position = offset + quantized * scale
+
+        inline addr_size vertexCount() const {
+            return positions.len() / 3;
+        }
+    };
+
+    // Welds identical vertices after quantization and builds the index buffer.
+    [[nodiscard]] static QuantizedMesh quantize(const StlMesh& mesh);
+
+    [[nodiscard]] static addr_size encodePositionsBound(addr_size vertexCount);
+    [[nodiscard]] static addr_size encodePositions(core::Memory<u8> out, core::Memory<const u16> positions);
+    [[nodiscard]] static bool      decodePositions(core::Memory<u16> out, core::Memory<const u8> encoded);
+
+    [[nodiscard]] static addr_size encodeIndicesBound(addr_size indexCount);
+    [[nodiscard]] static addr_size encodeIndices(core::Memory<u8> out, core::Memory<const u32> indices);
+    [[nodiscard]] static bool      decodeIndices(core::Memory<u32> out, core::Memory<const u8> encoded);
+
+    // Reads the element count from the header of an encoded stream. Returns false if the magic does not match.
+    [[nodiscard]] static bool readPositionsCount(core::Memory<const u8> encoded, addr_size& outVertexCount);
+    [[nodiscard]] static bool readIndicesCount(core::Memory<const u8> encoded, addr_size& outIndexCount);
+};
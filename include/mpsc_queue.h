@@ -0,0 +1,74 @@
+#pragma once
+
+#include <core_types.h>
+
+#include <atomic>
+
+using namespace coretypes;
+
+// Bounded lock-free queue for any number of producer threads and exactly one consumer thread. Every slot carries a
+// sequence number that tells whose turn it is: producers claim a position with a CAS on the tail and publish the slot
+// by bumping its sequence, the consumer waits for that sequence and hands the slot back one lap later. A producer that
+// is preempted between the two only holds up the consumer at its slot, never the other producers.
+template <typename T, u32 Capacity>
+struct MpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    static constexpr u32 CAPACITY = Capacity;
+    static constexpr addr_size CACHE_LINE_SIZE = 64;
+
+    MpscQueue() {
+        for (u32 i = 0; i < Capacity; i++) {
+            m_slots[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Producer side, any thread. Returns false when the queue is full.
+    bool push(const T& v) {
+        u32 pos = m_tail.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &m_slots[pos & (Capacity - 1)];
+            u32 seq = slot->seq.load(std::memory_order_acquire);
+            i32 diff = i32(seq - pos);
+            if (diff == 0) {
+                if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            }
+            else if (diff < 0) {
+                return false; // The consumer has not released this slot from the previous lap.
+            }
+            else {
+                pos = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->value = v;
+        slot->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false when the queue is empty, or when the next slot is claimed but not yet written.
+    bool pop(T& out) {
+        Slot& slot = m_slots[m_head & (Capacity - 1)];
+        u32 seq = slot.seq.load(std::memory_order_acquire);
+        if (seq != m_head + 1) return false;
+
+        out = slot.value;
+        slot.seq.store(m_head + Capacity, std::memory_order_release);
+        m_head++;
+        return true;
+    }
+
+private:
+    struct Slot {
+        std::atomic<u32> seq;
+        T value;
+    };
+
+    alignas(CACHE_LINE_SIZE) std::atomic<u32> m_tail = 0;
+    alignas(CACHE_LINE_SIZE) u32 m_head = 0; // Consumer owned.
+    alignas(CACHE_LINE_SIZE) Slot m_slots[Capacity];
+};
@@ -12,35 +12,24 @@ using namespace coretypes;
 typedef struct VkInstance_T* VkInstance;
 typedef struct VkSurfaceKHR_T* VkSurfaceKHR;
 
-using WindowCloseCallback = void (*)();
-using WindowResizeCallback = void (*)(i32 w, i32 h);
-using WindowFocusCallback = void (*)(bool gain);
-
-using KeyCallback = void (*)(bool isPress, u32 vkcode, u32 scancode, KeyboardModifiers mods);
-
-using MouseClickCallback = void (*)(bool isPress, MouseButton button, i32 x, i32 y, KeyboardModifiers mods);
-using MouseMoveCallback = void (*)(i32 x, i32 y);
-using MouseScrollCallback = void (*)(MouseScrollDirection direction, i32 x, i32 y);
-using MouseEnterOrLeaveCallback = void (*)(bool enter);
-
 struct Platform {
-    static void registerWindowCloseCallback(WindowCloseCallback cb);
-    static void registerWindowResizeCallback(WindowResizeCallback cb);
-    static void registerWindowFocusCallback(WindowFocusCallback cb);
-
-    static void registerKeyCallback(KeyCallback cb);
-
-    static void registerMouseClickCallback(MouseClickCallback cb);
-    static void registerMouseMoveCallback(MouseMoveCallback cb);
-    static void registerMouseScrollCallback(MouseScrollCallback cb);
-    static void registerMouseEnterOrLeaveCallback(MouseEnterOrLeaveCallback cb);
-
     [[nodiscard]] static AppError init(const char* windowTitle, i32 windowWidth, i32 windowHeight);
-    [[nodiscard]] static AppError pollEvents(bool block = false);
+    // Pumps the OS event queue and appends the translated events to queue. The caller owns the queue and drains it.
+    [[nodiscard]] static AppError pollEvents(InputEventQueue& queue, bool block = false);
     static void shutdown();
 
     static bool getFrameBufferSize(u32& width, u32& height);
 
+#if defined(USE_X11)
+    // For tools that talk to the X server directly, e.g. to inject synthetic events. Display* and Window.
+    static void getX11Handles(void*& display, unsigned long& window);
+
+    // Blocks until there are events to poll, wakeEventWait is called, or timeoutMs passes (-1 waits forever). Lets a
+    // dedicated input thread sleep on the X connection instead of spinning on pollEvents.
+    static void waitForEvents(i32 timeoutMs);
+    static void wakeEventWait();
+#endif
+
     static void requiredVulkanExtsCount(i32& count);
     static void requiredVulkanExts(const char** extensions);
     [[nodiscard]] static AppError createVulkanSurface(VkInstance instance, VkSurfaceKHR& surface);
@@ -2,6 +2,20 @@
 
 #include <basic.h>
 #include <app_error.h>
+#include <frame_pacer.h>
+
+struct StlMesh;
+
+// Must match the SHADING_MODE_* values in assets/shaders/mesh_shader.frag.
+enum struct ShadingMode : u8 {
+    SHADED,
+    WIREFRAME,
+    NORMALS, // Colored by the absolute face normal.
+    XRAY,
+    FACE_COLOR, // A distinct color per triangle.
+
+    COUNT
+};
 
 enum RendererBackendType : u8 {
     NONE,
@@ -18,18 +32,40 @@ struct RendererInitInfo {
     };
 
     const char* appName = nullptr;
-    bool vSyncOn = false;
+    PacingMode pacingMode = PacingMode::UNCAPPED;
+    u32 framesInFlight = 2; // 1 to 3. Fewer frames queued is lower latency, more hides CPU and GPU spikes better.
+    u32 msaaSamples = 4; // Power of two, 1 disables MSAA. Lowered to what the device supports.
+    const char* shaderDir = nullptr; // Optional, loads <name>.spirv files from here instead of the embedded shaders.
     RendererBackendType backendType = RendererBackendType::NONE;
     union {
         VulkanInfo vk;
     } backend;
 
-    static RendererInitInfo create(const char* appName, bool vSyncOn);
+    static RendererInitInfo create(const char* appName, PacingMode pacingMode);
 };
 
 struct Renderer {
+    // Starts the startup work that does not need a window on background threads: instance creation and reading the
+    // shader binaries. Optional, init does the same work inline when this was not called. The info must stay
+    // alive until init or abortInit returns.
+    static void beginInit(const RendererInitInfo& info);
+    static void abortInit(); // Undoes beginInit when init is never called, e.g. the window failed to open.
     [[nodiscard]] static core::expected<AppError> init(const RendererInitInfo& info);
     static void drawFrame();
+    static bool isMinimized(); // The last drawFrame had a zero sized surface and drew nothing.
     static void resizeTarget(i32 width, i32 height);
+    static void setPacingMode(PacingMode mode); // Recreates the swapchain before the next frame.
+    // The first use of a mode compiles its pipeline in the background, the previous mode is drawn until it is ready.
+    static void setShadingMode(ShadingMode mode);
     static void shutdown();
+
+    // Thread safe. Creates the GPU buffers on the calling thread and replaces the scene at the start of the next frame.
+    // The replaced buffers are destroyed once the frames that used them have finished.
+    static void submitMesh(const StlMesh& mesh);
+
+    // Thread safe. Builds the base pipeline from the given SPIR-V files on the calling thread, through the pipeline cache,
+    // and swaps the shaders in at the start of the next frame. The other variants are rebuilt on demand. The meshes are
+    // not touched. On error the current pipelines stay in use.
+    [[nodiscard]] static core::expected<AppError> submitShaders(core::StrView vertexShaderPath,
+                                                                core::StrView fragmentShaderPath);
 };
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <basic.h>
+#include <app_error.h>
+
+// Loads the model shown by the viewer and keeps it in sync with the file on disk. When the file changes it is re-read
+// and re-parsed on a worker thread and the new mesh is handed to the renderer, which swaps it in between frames.
+struct SceneLoader {
+    // Starts reading and parsing the file on the loader thread, so it overlaps window and device creation. Optional,
+    // init waits for it and reports its errors.
+    static void prefetch(const char* stlPath);
+    [[nodiscard]] static core::expected<AppError> init(const char* stlPath);
+    static void shutdown();
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <basic.h>
+#include <app_error.h>
+
+// Development mode that keeps the shaders in sync with their sources. When a source in assets/shaders changes, both
+// shaders are recompiled with glslc on a worker thread, written over the build's SPIR-V files and handed to the
+// renderer, which rebuilds the pipeline in the background and swaps it in between frames. Loaded meshes stay as they
+// are. A shader that fails to compile leaves the current pipeline in use, the compiler errors go to stderr.
+//
+// Needs glslc at the path the build found it and a file watcher, so only Linux for now.
+struct ShaderHotReload {
+    [[nodiscard]] static core::expected<AppError> init();
+    static void shutdown();
+};
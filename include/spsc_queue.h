@@ -0,0 +1,60 @@
+#pragma once
+
+#include <core_types.h>
+
+#include <atomic>
+
+using namespace coretypes;
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread. Every slot is written by the
+// producer before the tail is published with release semantics, and read by the consumer before the head is published,
+// so neither side ever waits on the other. The indices run freely and are masked on access.
+template <typename T, u32 Capacity>
+struct SpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    static constexpr u32 CAPACITY = Capacity;
+    static constexpr addr_size CACHE_LINE_SIZE = 64;
+
+    // Producer side. Returns false when the queue is full.
+    bool push(const T& v) {
+        u32 tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead == Capacity) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead == Capacity) return false;
+        }
+
+        m_items[tail & (Capacity - 1)] = v;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producer side. A lower bound, the consumer can only make more room.
+    u32 freeSlots() const {
+        return Capacity - (m_tail.load(std::memory_order_relaxed) - m_head.load(std::memory_order_acquire));
+    }
+
+    // Consumer side. Returns false when the queue is empty.
+    bool pop(T& out) {
+        u32 head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail) return false;
+        }
+
+        out = m_items[head & (Capacity - 1)];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    // Each side keeps a stale copy of the other side's index, so the shared cache lines are only touched when the
+    // queue looks full or empty.
+    alignas(CACHE_LINE_SIZE) std::atomic<u32> m_head = 0;
+    u32 m_cachedTail = 0; // Consumer owned.
+
+    alignas(CACHE_LINE_SIZE) std::atomic<u32> m_tail = 0;
+    u32 m_cachedHead = 0; // Producer owned.
+
+    alignas(CACHE_LINE_SIZE) T m_items[Capacity];
+};
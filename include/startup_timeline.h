@@ -0,0 +1,34 @@
+#pragma once
+
+#include <basic.h>
+
+// Records when each startup phase began and ended, and on which thread, up to the first presented frame. The report
+// lays the phases out on a common time axis, so overlapping work and the critical path to the first frame are visible
+// at a glance.
+//
+// Thread safe. Phases recorded after the report was logged are ignored.
+struct StartupTimeline {
+    static constexpr u32 MAX_PHASES = 32;
+    static constexpr u32 REPORT_BAR_WIDTH = 40;
+
+    // RAII phase, ends when it goes out of scope.
+    struct Scope {
+        explicit Scope(const char* name);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        i32 m_idx;
+    };
+
+    // Called first thing in main. The time origin of the report and the thread reported as "main".
+    static void start();
+
+    static i32 phaseBegin(const char* name); // Returns -1 when the timeline is full or already reported.
+    static void phaseEnd(i32 idx);
+
+    // Called after the first frame was presented. Logs the report once.
+    static void firstFramePresented();
+};
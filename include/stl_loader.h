@@ -0,0 +1,26 @@
+#pragma once
+
+#include <basic.h>
+#include <app_error.h>
+
+// Triangle soup as stored in the STL file. Both binary and ASCII STL files are supported.
+struct StlMesh {
+    static constexpr addr_size BINARY_HEADER_SIZE = 80;
+    static constexpr addr_size BINARY_TRIANGLE_SIZE = 50;
+
+    core::ArrList<f32> positions; // 3 vertices per triangle, 3 floats per vertex.
+    core::ArrList<f32> normals; // 1 normal per triangle, 3 floats per normal.
+    f32 boundsMin[3] = {};
+    f32 boundsMax[3] = {};
+
+    inline addr_size triangleCount() const {
+        return normals.len() / 3;
+    }
+
+    inline addr_size vertexCount() const {
+        return positions.len() / 3;
+    }
+
+    [[nodiscard]] static core::expected<StlMesh, AppError> parse(core::Memory<const u8> bytes);
+    [[nodiscard]] static core::expected<StlMesh, AppError> loadFromFile(core::StrView path);
+};
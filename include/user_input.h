@@ -54,3 +54,73 @@ enum struct MouseScrollDirection : u8 {
     UP,
     DOWN,
 };
+
+enum struct InputEventType : u8 {
+    NONE,
+
+    WINDOW_CLOSE,
+    WINDOW_RESIZE,
+    WINDOW_FOCUS,
+
+    KEY,
+
+    MOUSE_CLICK,
+    MOUSE_MOVE,
+    MOUSE_SCROLL,
+    MOUSE_ENTER_OR_LEAVE,
+};
+
+const char* inputEventTypeToCptr(InputEventType t);
+
+struct InputEvent {
+    InputEventType type = InputEventType::NONE;
+    u64 timestampNs = 0; // Monotonic, see inputTimestampNs().
+
+    union {
+        struct { i32 w, h; } resize;
+        struct { bool gain; } focus;
+        struct { bool isPress; u32 vkcode; u32 scancode; KeyboardModifiers mods; } key;
+        struct { bool isPress; MouseButton button; i32 x, y; KeyboardModifiers mods; } click;
+        struct { i32 x, y; } move;
+        struct { MouseScrollDirection direction; i32 x, y; } scroll;
+        struct { bool enter; } enterOrLeave;
+    };
+
+    InputEvent() : resize{} {}
+
+    // All of these stamp the event with the current time.
+    static InputEvent createWindowClose();
+    static InputEvent createWindowResize(i32 w, i32 h);
+    static InputEvent createWindowFocus(bool gain);
+    static InputEvent createKey(bool isPress, u32 vkcode, u32 scancode, KeyboardModifiers mods);
+    static InputEvent createMouseClick(bool isPress, MouseButton button, i32 x, i32 y, KeyboardModifiers mods);
+    static InputEvent createMouseMove(i32 x, i32 y);
+    static InputEvent createMouseScroll(MouseScrollDirection direction, i32 x, i32 y);
+    static InputEvent createMouseEnterOrLeave(bool enter);
+};
+
+// Monotonic clock in nanoseconds used to timestamp input events.
+u64 inputTimestampNs();
+
+// Fixed-capacity ring of input events. The platform layer pushes while pumping the OS queue and the application pops
+// everything once per frame. It never allocates, so a recorded sequence can be replayed through it as well.
+struct InputEventQueue {
+    static constexpr u32 CAPACITY = 1024;
+
+    // Returns false when the queue is full and the event was dropped. A mouse move into a full queue whose newest event
+    // is also a mouse move updates that event's position instead, since only the latest position matters. The older
+    // timestamp is kept.
+    bool push(const InputEvent& ev);
+    bool pop(InputEvent& out);
+    void clear();
+
+    u32 len() const { return m_count; }
+    bool empty() const { return m_count == 0; }
+    u64 droppedCount() const { return m_dropped; }
+
+private:
+    InputEvent m_events[CAPACITY];
+    u32 m_head = 0;
+    u32 m_count = 0;
+    u64 m_dropped = 0;
+};
@@ -1,6 +1,9 @@
 
 #include <app_error.h>
 #include <basic.h>
+#include <frame_arena.h>
+#include <frame_pacer.h>
+#include <renderer.h>
 #include <vulkan_include.h>
 
 #define VK_MUST(expr) Assert((expr) == VK_SUCCESS)
@@ -11,7 +14,9 @@ struct VulkanDevice;
 struct VulkanSwapchain;
 struct VulkanShaderStage;
 struct VulkanShader;
+struct VulkanDeletionQueue;
 struct VulkanContext;
+struct Mesh2D;
 
 struct VulkanQueue {
     VkQueue handle = VK_NULL_HANDLE;
@@ -19,10 +24,11 @@ struct VulkanQueue {
 };
 
 struct VulkanSurface {
+    // Transient, the lists point into the arena passed to queryCapabilities.
     struct Capabilities {
         VkSurfaceCapabilitiesKHR capabilities;
-        core::ArrList<VkSurfaceFormatKHR> formats;
-        core::ArrList<VkPresentModeKHR> presentModes;
+        core::Memory<VkSurfaceFormatKHR> formats;
+        core::Memory<VkPresentModeKHR> presentModes;
     };
 
     struct CachedCapabilities {
@@ -37,8 +43,17 @@ struct VulkanSurface {
     CachedCapabilities capabilities;
 
     [[nodiscard]] static VulkanSurface::Capabilities queryCapabilities(const VulkanSurface& surface,
-                                                                       VkPhysicalDevice physicalDevice);
-    [[nodiscard]] static core::expected<CachedCapabilities, AppError> pickCapabilities(const Capabilities& capabilities, bool vSyncOn);
+                                                                       VkPhysicalDevice physicalDevice,
+                                                                       FrameArena& scratch);
+    [[nodiscard]] static core::expected<CachedCapabilities, AppError> pickCapabilities(const Capabilities& capabilities, PacingMode pacingMode);
+
+    // Updates only what can change when the window is resized (extent and transform). The format and image count stay
+    // as picked at startup.
+    static void refreshCapabilities(VulkanSurface& surface, VkPhysicalDevice physicalDevice);
+
+    // Picks the present mode again when the pacing mode changes at runtime. Takes effect with the next swapchain.
+    static void refreshPresentMode(VulkanSurface& surface, VkPhysicalDevice physicalDevice, PacingMode pacingMode,
+                                   FrameArena& scratch);
 };
 
 struct VulkanDevice {
@@ -60,6 +75,16 @@ struct VulkanDevice {
             }
             return computed;
         }
+
+        inline bool isOptionalActive(const char* name) const {
+            addr_size nameLen = core::cstrLen(name);
+            for (addr_size i = 0; i < optionalIsActive.len(); i++) {
+                if (optionalIsActive[i] && core::memcmp(optional[i], core::cstrLen(optional[i]), name, nameLen) == 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
     };
 
     VkInstance instance = VK_NULL_HANDLE;
@@ -70,18 +95,34 @@ struct VulkanDevice {
     VkPhysicalDeviceFeatures physicalDeviceFeatures;
     VkDebugUtilsMessengerEXT debugMessenger = VK_NULL_HANDLE;
     VulkanSurface surface = {};
-    bool vSyncOn = false;
+    PacingMode pacingMode = PacingMode::UNCAPPED;
+    bool presentWaitEnabled = false; // VK_KHR_present_id and VK_KHR_present_wait with their features enabled.
+    bool timelineSemaphoreEnabled = false; // VK_KHR_timeline_semaphore with its feature enabled.
+    bool fillModeNonSolidEnabled = false; // Wireframe rendering.
+    bool dynamicRenderingEnabled = false; // VK_KHR_dynamic_rendering with its feature enabled.
 
     VulkanQueue graphicsQueue = {};
     VulkanQueue presentQueue = {};
-
-    [[nodiscard]] static core::expected<VulkanDevice, AppError> create(const struct RendererInitInfo& rendererInitInfo);
+    VulkanQueue computeQueue = {}; // Same family as the graphics queue, when the device has no dedicated one.
+
+    // Creates the instance and the debug messenger only. Does not touch the window, so it can run on another thread while
+    // the platform layer is initializing.
+    [[nodiscard]] static VulkanDevice createInstance(const struct RendererInitInfo& rendererInitInfo);
+    // Creates the surface, picks the GPU and creates the logical device on top of an instance from createInstance.
+    [[nodiscard]] static core::expected<VulkanDevice, AppError> create(const struct RendererInitInfo& rendererInitInfo,
+                                                                       VulkanDevice&& withInstance);
     [[nodiscard]] static core::expected<AppError> pickDevice(core::Memory<const PhysicalDevice> gpus, VulkanDevice& out);
 
+    // The first memory type allowed by typeFilter that has all the properties. False when there is none.
+    [[nodiscard]] static bool findMemoryType(const VulkanDevice& device, u32 typeFilter,
+                                             VkMemoryPropertyFlags properties, u32& outIdx);
+
     static void destroy(VulkanDevice& device);
 };
 
 struct VulkanSwapchain {
+    static constexpr u32 MAX_IMAGES = 8;
+
     VkSwapchainKHR handle = VK_NULL_HANDLE;
     core::ArrList<VkImage> images;
     core::ArrList<VkImageView> imageViews;
@@ -90,6 +131,113 @@ struct VulkanSwapchain {
                                                                           const VulkanSwapchain* old = nullptr);
 
     static void destroy(VulkanSwapchain& swapchain, const VulkanDevice& device);
+    static void retire(VulkanSwapchain& swapchain, VulkanDeletionQueue& queue);
+};
+
+// GPU progress of a single queue as an increasing counter. Every submission through the timeline signals the next value.
+// The CPU waits for values, and submissions to other queues can wait for values on the GPU, so one semaphore replaces
+// the fence per frame and the semaphore per dependency.
+//
+// Without VK_KHR_timeline_semaphore it falls back to a small ring of fences, one per submission, and waits on another
+// queue's timeline become CPU waits before the submit.
+struct VulkanTimeline {
+    // At least as many as the frames or compute jobs in flight, so reusing a slot never waits on its own.
+    static constexpr u32 FALLBACK_SLOTS = 8;
+
+    struct Submit {
+        static constexpr u32 MAX_WAITS = 4;
+
+        VkCommandBuffer cmdBuffer = VK_NULL_HANDLE;
+        VkSemaphore signalBinary = VK_NULL_HANDLE; // Optional, e.g. for the present to wait on.
+
+        VkSemaphore binaryWaits[MAX_WAITS];
+        VkPipelineStageFlags binaryWaitStages[MAX_WAITS];
+        u32 binaryWaitsCount = 0;
+
+        const VulkanTimeline* timelineWaits[MAX_WAITS];
+        u64 timelineWaitValues[MAX_WAITS];
+        VkPipelineStageFlags timelineWaitStages[MAX_WAITS];
+        u32 timelineWaitsCount = 0;
+
+        void waitBinary(VkSemaphore semaphore, VkPipelineStageFlags stage);
+        void waitTimeline(const VulkanTimeline& timeline, u64 value, VkPipelineStageFlags stage);
+    };
+
+    VkDevice logicalDevice = VK_NULL_HANDLE;
+    VkSemaphore semaphore = VK_NULL_HANDLE; // Timeline semaphore, null in fallback mode.
+    u64 lastSubmitted = 0;
+
+    // Fallback mode only.
+    VkFence fences[FALLBACK_SLOTS] = {};
+    u64 fenceValues[FALLBACK_SLOTS] = {};
+    mutable u64 lastCompleted = 0;
+
+    static VulkanTimeline create(const VulkanDevice& device);
+    static void destroy(VulkanTimeline& timeline);
+
+    // Returns the value that is signaled once the submission completes.
+    static u64 submit(VulkanTimeline& timeline, VkQueue queue, const Submit& submit);
+
+    // Blocks until the value is reached. Value 0 is always reached.
+    static void wait(const VulkanTimeline& timeline, u64 value);
+    static bool isReached(const VulkanTimeline& timeline, u64 value);
+};
+
+// Objects that frames in flight might still be using. There is one queue per frame in flight and it is flushed right
+// after waiting for that frame's timeline value, so objects pushed to the queue of the last submitted frame are destroyed once
+// every frame that could have referenced them has finished executing.
+struct VulkanDeletionQueue {
+    enum struct Type : u8 {
+        BUFFER,
+        DEVICE_MEMORY,
+        FRAMEBUFFER,
+        IMAGE_VIEW,
+        SWAPCHAIN,
+        PIPELINE,
+        IMAGE,
+    };
+
+    struct Entry {
+        Type type;
+        union {
+            VkBuffer buffer;
+            VkDeviceMemory memory;
+            VkFramebuffer framebuffer;
+            VkImageView imageView;
+            VkSwapchainKHR swapchain;
+            VkPipeline pipeline;
+            VkImage image;
+        };
+    };
+
+    core::ArrList<Entry> entries;
+
+    // NOTE: Distinct names, because on 32 bit platforms all non-dispatchable handles are the same type.
+    void pushBuffer(VkBuffer buffer);
+    void pushMemory(VkDeviceMemory memory);
+    void pushFramebuffer(VkFramebuffer framebuffer);
+    void pushImageView(VkImageView imageView);
+    void pushSwapchain(VkSwapchainKHR swapchain);
+    void pushPipeline(VkPipeline pipeline);
+    void pushImage(VkImage image);
+
+    static void flush(VulkanDeletionQueue& queue, VkDevice logicalDevice);
+};
+
+// Waits on VK_KHR_present_wait from a background thread and reports when each queued present id reached the screen.
+// Only runs in latency measurement mode.
+struct VulkanPresentWaiter {
+    static constexpr u32 MAX_PENDING = 16;
+    static constexpr u64 WAIT_SLICE_NS = 2 * 1000 * 1000; // Bounds how long retireSwapchain can block.
+
+    static void start(const VulkanDevice& device);
+    static void stop();
+
+    static void enqueue(VkSwapchainKHR swapchain, u64 presentId);
+
+    // Must be called before the swapchain is passed as oldSwapchain. Ids queued for it are dropped, and once this
+    // returns no wait on it is in progress.
+    static void retireSwapchain();
 };
 
 struct VulkanShaderStage {
@@ -97,6 +245,7 @@ struct VulkanShaderStage {
         UNDEFINED,
         VERTEX,
         FRAGMENT,
+        COMPUTE,
     };
 
     u32 id = 0;
@@ -105,9 +254,21 @@ struct VulkanShaderStage {
     addr_size shaderBytesSize = 0;
     Type stageType = Type::UNDEFINED;
 
+    // Only reads the file, does not need a device. Safe to call from any thread.
+    [[nodiscard]] static core::expected<AppError> readFile(core::StrView path, core::ArrList<u8>& outBytes);
+
     [[nodiscard]] static core::expected<VulkanShaderStage, AppError> createFromFile(VkDevice logicalDevice,
                                                                                     core::StrView path,
                                                                                     Type stageType);
+    // Takes ownership of the bytes. The path is used for logging and the debug source only.
+    [[nodiscard]] static core::expected<VulkanShaderStage, AppError> createFromBytes(VkDevice logicalDevice,
+                                                                                     core::StrView path,
+                                                                                     core::ArrList<u8>&& bytes,
+                                                                                     Type stageType);
+    // Does not copy the words, they only have to live until the call returns.
+    [[nodiscard]] static core::expected<VulkanShaderStage, AppError> createFromSpirv(VkDevice logicalDevice,
+                                                                                     core::Memory<const u32> words,
+                                                                                     Type stageType);
     static void destroy(VulkanShaderStage& stage, VkDevice logicalDevice);
 };
 
@@ -116,6 +277,10 @@ struct VulkanShader {
     struct CreateFromFileInfo {
         core::StrView vertexShaderPath;
         core::StrView fragmetShaderPath;
+
+        // Optional contents already read with VulkanShaderStage::readFile, moved from. The file is read when empty.
+        core::ArrList<u8>* vertexShaderBytes = nullptr;
+        core::ArrList<u8>* fragmentShaderBytes = nullptr;
     };
 
     static constexpr addr_size MAX_SHADER_STAGES = 5;
@@ -125,9 +290,137 @@ struct VulkanShader {
 
     [[nodiscard]] static VulkanShader createGraphicsShaderFromFile(const CreateFromFileInfo& info,
                                                                    const VulkanContext& vkctx);
+    [[nodiscard]] static VulkanShader createGraphicsShaderFromSpirv(core::Memory<const u32> vertexWords,
+                                                                    core::Memory<const u32> fragmentWords,
+                                                                    const VulkanContext& vkctx);
     static void destroy(VulkanShader& shader, VkDevice logicalDevice);
 };
 
+// Graphics pipeline variants of the mesh shaders. A variant is described by a State, which packs into a 32 bit key the
+// registry is searched by. All variants share the shader modules and differ in specialization constants and a few fixed
+// function states, so they are created as derivatives of the base variant, which is built up front. Any other variant is
+// compiled on a worker thread the first time it is asked for, and until it is ready get() returns the variant that was
+// returned last.
+//
+// get() and setShaders() are render thread only.
+struct VulkanPipelineRegistry {
+    static constexpr u32 MAX_VARIANTS = 16;
+    static constexpr u32 COMPILE_THREADS = 2;
+
+    struct State {
+        ShadingMode shadingMode = ShadingMode::NORMALS;
+        VkPolygonMode polygonMode = VK_POLYGON_MODE_FILL;
+        VkCullModeFlags cullMode = VK_CULL_MODE_BACK_BIT;
+        bool additiveBlend = false;
+
+        // Without fillModeNonSolid the wireframe mode draws filled triangles.
+        static State fromShadingMode(ShadingMode mode, bool fillModeNonSolid);
+        u32 key() const;
+    };
+
+    // Without a render pass the pipelines are created for dynamic rendering to the color format.
+    static void init(VkDevice logicalDevice, VkPipelineLayout layout, VkRenderPass renderPass, VkFormat colorFormat,
+                     VkSampleCountFlagBits samples, VkPipelineCache cache);
+    static void shutdown(); // Waits for the running compiles, the device must be idle.
+
+    // Thread safe. Builds the base variant (the default State), which every other variant derives from. Returns
+    // VK_NULL_HANDLE on failure.
+    [[nodiscard]] static VkPipeline createBase(VkShaderModule vertexShaderModule, VkShaderModule fragmentShaderModule);
+
+    // Starts over with new shaders and a base from createBase, which the registry takes ownership of. The modules must
+    // stay alive until the next call or shutdown. Waits for the running compiles, which use the previous modules, and
+    // retires the previous variants into the queue.
+    static void setShaders(VkShaderModule vertexShaderModule, VkShaderModule fragmentShaderModule, VkPipeline base,
+                           VulkanDeletionQueue& retireTo);
+
+    [[nodiscard]] static VkPipeline get(const State& state);
+};
+
+// Compute shader with a single descriptor set of storage buffers and an optional push constant block.
+struct VulkanComputePipeline {
+    static constexpr u32 MAX_STORAGE_BUFFERS = 8;
+
+    struct CreateFromFileInfo {
+        core::StrView shaderPath;
+        u32 storageBuffersCount = 0; // Bound at bindings 0..count-1 of set 0.
+        u32 pushConstantsSize = 0;
+    };
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+    u32 storageBuffersCount = 0;
+    u32 pushConstantsSize = 0;
+
+    [[nodiscard]] static core::expected<VulkanComputePipeline, AppError> createFromFile(VkDevice logicalDevice,
+                                                                                        const CreateFromFileInfo& info);
+    // Same as createFromFile, info.shaderPath is only used for logging.
+    [[nodiscard]] static core::expected<VulkanComputePipeline, AppError> createFromSpirv(VkDevice logicalDevice,
+                                                                                         core::Memory<const u32> words,
+                                                                                         const CreateFromFileInfo& info);
+    static void destroy(VulkanComputePipeline& pipeline, VkDevice logicalDevice);
+};
+
+// Runs compute jobs on the compute queue, asynchronously to rendering when the device has a dedicated compute family.
+// Every job gets a command buffer and a descriptor pool from a small ring and is submitted right away. Completion is
+// tracked with the compute timeline, so a graphics submission that consumes the results waits for the job's value with
+// VulkanTimeline::Submit::waitTimeline.
+//
+// The command and descriptor pools are created by the first job, or the first timeline() call, so startup does not pay
+// for them when nothing runs compute.
+//
+// Render thread only, the compute queue might be the graphics queue. Buffers that are written by a job and read by the
+// graphics queue must be created with VK_SHARING_MODE_CONCURRENT when the families differ.
+struct VulkanCompute {
+    static constexpr u32 MAX_JOBS_IN_FLIGHT = 8;
+
+    using RecordFn = void (*)(VkCommandBuffer cmdBuffer, void* userData);
+
+    struct Dispatch {
+        const VulkanComputePipeline* pipeline = nullptr;
+        VkBuffer storageBuffers[VulkanComputePipeline::MAX_STORAGE_BUFFERS] = {};
+        const void* pushConstants = nullptr; // pipeline->pushConstantsSize bytes.
+        u32 groupCountX = 1;
+        u32 groupCountY = 1;
+        u32 groupCountZ = 1;
+        bool readBackOnHost = false; // Makes the shader writes visible to mapped memory once the job is done.
+    };
+
+    static void init(const VulkanDevice& device);
+    static void shutdown();
+
+    // Both return the timeline value that is reached once the job is done. Blocks only when all slots are in use.
+    static u64 submit(const Dispatch& dispatch);
+    static u64 submit(RecordFn record, void* userData);
+
+    static bool isDone(u64 value);
+    static void wait(u64 value);
+    static const VulkanTimeline& timeline();
+    static bool isAsync(); // Runs on a dedicated compute queue.
+};
+
+// Computes the bounding box of a mesh on the compute queue when it is swapped in. The result is picked up by a later
+// frame without stalling on the job. The pipeline and the result buffer are created by the first request.
+//
+// Render thread only.
+struct VulkanMeshBounds {
+    struct Bounds {
+        f32 minX, minY;
+        f32 maxX, maxY;
+    };
+
+    // An empty path uses the embedded shader.
+    static void init(const VulkanDevice& device, core::StrView shaderPath);
+    static void shutdown();
+
+    // Replaces the previous request. The mesh's vertex buffer must stay alive until the job is done, see wait().
+    static void request(const Mesh2D& mesh);
+    // True once, when the result of the last request is ready.
+    static bool poll(Bounds& out);
+    // Blocks until the last request is done, e.g. before its vertex buffer is retired.
+    static void wait();
+};
+
 struct Mesh2D {
     template <typename T>
     using container_type = core::ArrList<T>;
@@ -185,9 +478,21 @@ struct Mesh2D {
             vkFreeMemory(device.logicalDevice, mesh.vertexBufferMemory, nullptr);
         }
     }
+
+    static void retire(VulkanDeletionQueue& queue, Mesh2D& mesh) {
+        if (mesh.vertexBuffer != VK_NULL_HANDLE) {
+            queue.pushBuffer(mesh.vertexBuffer);
+        }
+        if (mesh.vertexBufferMemory != VK_NULL_HANDLE) {
+            queue.pushMemory(mesh.vertexBufferMemory);
+        }
+        mesh = {};
+    }
 };
 
 struct VulkanContext {
+    static constexpr u32 MAX_FRAMES_IN_FLIGHT = 3;
+
     VulkanDevice device;
     VulkanSwapchain swapchain;
 
@@ -195,16 +500,46 @@ struct VulkanContext {
 
     // EXPERIMENTAL SECTION:
     VulkanShader shader;
-    VkPipeline pipeline;
+    VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+    ShadingMode shadingMode = ShadingMode::NORMALS;
     VkPipelineLayout pipelineLayout;
-    VkRenderPass renderPass;
-    core::ArrStatic<VkFramebuffer, 5> frameBuffers;
-    core::ArrStatic<VkFence, 5> inFlightFences;
-    core::ArrStatic<VkSemaphore, 5> imageAvailableSemaphores;
-    core::ArrStatic<VkSemaphore, 5> renderFinishedSemaphores;
-    core::ArrStatic<VkCommandBuffer, 5> cmdBuffers;
+    VkRenderPass renderPass; // Null with dynamic rendering.
+
+    VulkanTimeline graphicsTimeline;
+
+    // Per frame in flight.
+    u64 frameTimelineValues[MAX_FRAMES_IN_FLIGHT] = {}; // Value signaled by the frame's last submission.
+    core::ArrStatic<VkSemaphore, MAX_FRAMES_IN_FLIGHT> imageAvailableSemaphores;
+    core::ArrStatic<VkCommandBuffer, MAX_FRAMES_IN_FLIGHT> cmdBuffers;
+    VulkanDeletionQueue deletionQueues[MAX_FRAMES_IN_FLIGHT];
+    FrameArena frameArenas[MAX_FRAMES_IN_FLIGHT]; // Transient CPU data, reset once the frame's timeline value is reached.
+
+    // Renders straight to the swapchain image views with VK_KHR_dynamic_rendering. There is no render pass and no
+    // framebuffers, so nothing but the swapchain has to be recreated on resize.
+    bool useDynamicRendering = false;
+
+    // Multisampled color target, resolved into the swapchain image at the end of the pass and never stored. One is
+    // shared by all frames, consecutive frames are serialized on the color output stage anyway. Created as a transient
+    // attachment in lazily allocated memory where the device has it, so on tilers it only ever lives in tile memory.
+    // Recreated with the swapchain.
+    VkSampleCountFlagBits msaaSamples = VK_SAMPLE_COUNT_1_BIT;
+    VkImage msaaColorImage = VK_NULL_HANDLE;
+    VkDeviceMemory msaaColorMemory = VK_NULL_HANDLE;
+    VkImageView msaaColorView = VK_NULL_HANDLE;
+
+    // Per swapchain image. The present of an image waits on its semaphore, and the semaphore can only be signaled
+    // again once the image is acquired again, which is after that present. Indexing by frame would break as soon as
+    // the frame count and image count differ.
+    core::ArrStatic<VkFramebuffer, VulkanSwapchain::MAX_IMAGES> frameBuffers; // Empty with dynamic rendering.
+    core::ArrStatic<VkSemaphore, VulkanSwapchain::MAX_IMAGES> renderFinishedSemaphores;
+    core::ArrStatic<u64, VulkanSwapchain::MAX_IMAGES> imagesInFlight; // Timeline value of the last frame rendering to it.
     VkCommandPool cmdBuffersPool;
     u32 currentFrame = 0;
+    u32 lastSubmittedFrame = 0;
     u32 maxFramesInFlight = 0;
     bool frameBufferResized = false;
+    bool swapchainOutOfDate = false;
+    bool presentModeChanged = false;
+    bool minimized = false;
+    u64 lastPresentId = 0; // Only advanced when present ids are in use.
 };
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <basic.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Fixed size pool of worker threads consuming jobs from a bounded FIFO queue. Submitting to a full queue blocks until a
+// worker frees a slot, so the pool never allocates after init.
+struct WorkerPool {
+    using JobFn = void (*)(void* userData);
+
+    static constexpr u32 MAX_THREADS = 32;
+    static constexpr u32 MAX_QUEUED_JOBS = 1024;
+
+    struct Job {
+        JobFn fn = nullptr;
+        void* userData = nullptr;
+    };
+
+    // threadCount = 0 picks one thread per hardware thread.
+    void init(u32 threadCount = 0);
+    void shutdown(); // Finishes all queued jobs before joining the threads.
+
+    void submit(JobFn fn, void* userData);
+    void waitIdle();
+
+    inline u32 threadCount() const { return m_threadCount; }
+
+private:
+    static void workerLoop(WorkerPool* pool);
+
+    std::thread m_threads[MAX_THREADS];
+    u32 m_threadCount = 0;
+
+    Job m_jobs[MAX_QUEUED_JOBS];
+    u32 m_head = 0;
+    u32 m_count = 0;
+    u32 m_running = 0;
+    bool m_stopping = false;
+
+    std::mutex m_mutex;
+    std::condition_variable m_jobAvailable;
+    std::condition_variable m_slotAvailable;
+    std::condition_variable m_idle;
+};
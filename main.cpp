@@ -1,30 +1,128 @@
 #include <app.h>
+#include <app_logger.h>
+#include <startup_timeline.h>
 
 #include "./tools/sandbox/sandbox.h"
 
-i32 main() {
+#include <iostream>
+
+namespace {
+
+bool startsWith(const char* str, const char* prefix) {
+    addr_size prefixLen = core::cstrLen(prefix);
+    return core::cstrLen(str) >= prefixLen && core::memcmp(str, prefixLen, prefix, prefixLen) == 0;
+}
+
+bool parseU32(const char* str, u32& out) {
+    if (*str == '\0') return false;
+    u64 v = 0;
+    for (; *str; str++) {
+        if (*str < '0' || *str > '9') return false;
+        v = v * 10 + u64(*str - '0');
+        if (v > u64(u32(-1))) return false;
+    }
+    out = u32(v);
+    return true;
+}
+
+} // namespace
+
+i32 main(i32 argc, const char** argv) {
+    StartupTimeline::start();
+
     ApplicationInfo appInfo = {};
     appInfo.windowTitle = "Example Application";
     appInfo.appName = "STL Viewer";
     appInfo.initWindowHeight = 1280;
     appInfo.initWindowWidth = 720;
+    appInfo.stlFilePath = nullptr;
+    appInfo.measureLatency = false;
+    appInfo.pacingMode = PacingMode::UNCAPPED;
+    appInfo.frameLimitFps = 0;
+    appInfo.framesInFlight = 2;
+    appInfo.msaaSamples = 4;
+    appInfo.assertNoFrameAllocs = false;
+    appInfo.logFilePath = nullptr;
+    appInfo.fastExit = !STLV_DEBUG;
+    appInfo.shaderDir = nullptr;
+    appInfo.hotReloadShaders = false;
+
+    for (i32 i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (core::memcmp(arg, core::cstrLen(arg), "--measure-latency", core::cstrLen("--measure-latency")) == 0) {
+            appInfo.measureLatency = true;
+        }
+        else if (core::memcmp(arg, core::cstrLen(arg), "--assert-no-frame-allocs", core::cstrLen("--assert-no-frame-allocs")) == 0) {
+            appInfo.assertNoFrameAllocs = true;
+        }
+        else if (core::memcmp(arg, core::cstrLen(arg), "--fast-exit", core::cstrLen("--fast-exit")) == 0) {
+            appInfo.fastExit = true;
+        }
+        else if (core::memcmp(arg, core::cstrLen(arg), "--full-shutdown", core::cstrLen("--full-shutdown")) == 0) {
+            appInfo.fastExit = false;
+        }
+        else if (core::memcmp(arg, core::cstrLen(arg), "--hot-reload-shaders", core::cstrLen("--hot-reload-shaders")) == 0) {
+            appInfo.hotReloadShaders = true;
+        }
+        else if (startsWith(arg, "--shader-dir=")) {
+            appInfo.shaderDir = arg + core::cstrLen("--shader-dir=");
+        }
+        else if (startsWith(arg, "--log-file=")) {
+            appInfo.logFilePath = arg + core::cstrLen("--log-file=");
+        }
+        else if (startsWith(arg, "--pacing=")) {
+            const char* value = arg + core::cstrLen("--pacing=");
+            if (!pacingModeFromCStr(value, appInfo.pacingMode)) {
+                // The logger is not initialized yet.
+                std::cerr << "Unknown pacing mode: " << value
+                          << ", expected uncapped, low-latency, power-saving or adaptive\n";
+                return -1;
+            }
+        }
+        else if (startsWith(arg, "--fps-limit=")) {
+            const char* value = arg + core::cstrLen("--fps-limit=");
+            if (!parseU32(value, appInfo.frameLimitFps)) {
+                std::cerr << "Invalid frame limit: " << value << "\n";
+                return -1;
+            }
+        }
+        else if (startsWith(arg, "--frames-in-flight=")) {
+            const char* value = arg + core::cstrLen("--frames-in-flight=");
+            if (!parseU32(value, appInfo.framesInFlight) || appInfo.framesInFlight < 1 || appInfo.framesInFlight > 3) {
+                std::cerr << "Invalid frames in flight: " << value << ", expected 1 to 3\n";
+                return -1;
+            }
+        }
+        else if (startsWith(arg, "--msaa=")) {
+            const char* value = arg + core::cstrLen("--msaa=");
+            u32& samples = appInfo.msaaSamples;
+            if (!parseU32(value, samples) || samples < 1 || samples > 64 || (samples & (samples - 1)) != 0) {
+                std::cerr << "Invalid MSAA sample count: " << value << ", expected 1 (off), 2, 4, 8, 16, 32 or 64\n";
+                return -1;
+            }
+        }
+        else {
+            appInfo.stlFilePath = arg;
+        }
+    }
 
     if (auto res = Application::init(appInfo); res.hasErr()) {
         logFatal(res.err().toCStr());
         return -1;
     }
-    defer {
-        // TODO2:
-        // In the final product I should probably just avoid shutdown, because it can be rather slow on performance.
-        // It does quite a bit and most of it is not necessary, since we just want to kill the process.
-        // For now I am keeping it to ensure proper resource release and proper Vulkan spec adherence!
-        Application::shutdown();
-    };
 
+    i32 exitCode = 0;
     if (auto res = Application::start(); res.hasErr()) {
         logFatal(res.err().toCStr());
-        return -1;
+        exitCode = -1;
+    }
+
+    // The full shutdown releases every resource in order and keeps the validation layers happy, but most of it is not
+    // needed to kill the process.
+    if (appInfo.fastExit) {
+        Application::fastExit(exitCode);
     }
+    Application::shutdown();
 
-    return 0;
+    return exitCode;
 }
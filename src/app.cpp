@@ -1,12 +1,24 @@
 #include <app.h>
 #include <app_logger.h>
+#include <frame_pacer.h>
+#include <input_thread.h>
+#include <latency_tracker.h>
+#include <memory_tracker.h>
 #include <platform.h>
 #include <renderer.h>
+#include <scene_loader.h>
+#include <shader_hot_reload.h>
+#include <startup_timeline.h>
 #include <user_input.h>
 
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
+#include <thread>
 
 using PlatformError::Type::FAILED_TO_INITIALIZE_CORE_LOGGER;
+using PlatformError::Type::HEAP_ALLOCATION_IN_FRAME_LOOP;
 
 namespace {
 
@@ -16,15 +28,30 @@ constexpr bool USE_ANSI_LOGGING = true;
 constexpr bool USE_ANSI_LOGGING = false;
 #endif
 
+// Keys 1-4 switch the pacing mode and keys 5-9 the shading mode at runtime. Cocoa reports hardware key codes, X11
+// keysyms and Win32 virtual-key codes are the same as ASCII for digits.
+#if defined(OS_MAC) && OS_MAC == 1
+constexpr u32 PACING_MODE_KEYS[u32(PacingMode::COUNT)] = { 0x12, 0x13, 0x14, 0x15 };
+constexpr u32 SHADING_MODE_KEYS[u32(ShadingMode::COUNT)] = { 0x17, 0x16, 0x1A, 0x1C, 0x19 };
+#else
+constexpr u32 PACING_MODE_KEYS[u32(PacingMode::COUNT)] = { '1', '2', '3', '4' };
+constexpr u32 SHADING_MODE_KEYS[u32(ShadingMode::COUNT)] = { '5', '6', '7', '8', '9' };
+#endif
+
+// How often a minimized window is checked for a usable surface when the input thread owns the event queue. Not every
+// platform sends an event on restore, so it cannot just wait for one.
+constexpr i32 MINIMIZED_POLL_MS = 50;
+
 bool g_appIsRunning = false;
+InputEventQueue g_inputEvents;
+u64 g_reportedDroppedEvents = 0;
 
 core::expected<AppError> initCoreContext();
-void registerEventHandlers();
+void processInputEvents();
+void handleInputEvent(const InputEvent& ev);
 
 void assertHandler(const char* failedExpr, const char* file, i32 line, const char* funcName, const char* errMsg);
 
-void __debugPrintMemoryUsage();
-
 }
 
 bool Application::isRunning() {
@@ -32,60 +59,159 @@ bool Application::isRunning() {
 }
 
 core::expected<AppError> Application::init(const ApplicationInfo& appInfo) {
-    if (auto res = initCoreContext(); res.hasErr()) {
-        return res;
+    {
+        StartupTimeline::Scope phase ("Core context and logger");
+        if (auto res = initCoreContext(); res.hasErr()) {
+            return res;
+        }
+        AsyncLogger::start(appInfo.logFilePath, USE_ANSI_LOGGING);
+    }
+
+    // Work that needs neither the window nor the device starts first and overlaps with the rest of the startup: the
+    // model is read and parsed on the loader thread, the Vulkan instance is created and the shader binaries are read
+    // on their own threads while the window is created on this one.
+    if (appInfo.stlFilePath) {
+        MemoryScope memScope (MemSubsystem::LOADER);
+        SceneLoader::prefetch(appInfo.stlFilePath);
+    }
+
+    logSectionTitleInfoTagged(APP_TAG, "BEGIN Renderer Initialization");
+    FramePacer::init(appInfo.pacingMode, appInfo.frameLimitFps);
+    RendererInitInfo rendererInfo = RendererInitInfo::create(appInfo.appName, FramePacer::mode());
+    rendererInfo.framesInFlight = appInfo.framesInFlight;
+    rendererInfo.msaaSamples = appInfo.msaaSamples;
+    rendererInfo.shaderDir = appInfo.shaderDir;
+    {
+        MemoryScope memScope (MemSubsystem::RENDERER);
+        Renderer::beginInit(rendererInfo);
     }
 
     const char* title = appInfo.windowTitle;
     i32 w = appInfo.initWindowHeight;
     i32 h = appInfo.initWindowWidth;
-    if (auto err = Platform::init(title, w, h); !err.isOk()) {
-        return core::unexpected(err);
+    {
+        MemoryScope memScope (MemSubsystem::PLATFORM);
+        StartupTimeline::Scope phase ("Platform window");
+        if (auto err = Platform::init(title, w, h); !err.isOk()) {
+            Renderer::abortInit();
+            SceneLoader::shutdown();
+            return core::unexpected(err);
+        }
     }
 
-    registerEventHandlers();
+    // Before the renderer, which starts the present wait thread only when measuring.
+    LatencyTracker::init(appInfo.measureLatency);
 
-    logSectionTitleInfoTagged(APP_TAG, "BEGIN Renderer Initialization");
-    bool vSyncOn = false;
-    RendererInitInfo rendererInfo = RendererInitInfo::create(appInfo.appName, vSyncOn);
-    if (auto res = Renderer::init(rendererInfo); res.hasErr()) {
-        return res;
+    {
+        MemoryScope memScope (MemSubsystem::RENDERER);
+        if (auto res = Renderer::init(rendererInfo); res.hasErr()) {
+            return res;
+        }
     }
     logSectionTitleInfoTagged(APP_TAG, "END Renderer Initialization");
 
-    __debugPrintMemoryUsage();
+    if (appInfo.stlFilePath) {
+        MemoryScope memScope (MemSubsystem::LOADER);
+        StartupTimeline::Scope phase ("Wait for and upload STL mesh");
+        if (auto res = SceneLoader::init(appInfo.stlFilePath); res.hasErr()) {
+            return res;
+        }
+    }
+
+    if (appInfo.hotReloadShaders) {
+        if (auto res = ShaderHotReload::init(); res.hasErr()) {
+            return res;
+        }
+    }
+
+    MemoryTracker::logReport();
+    MemoryTracker::enableNoAllocCheck(appInfo.assertNoFrameAllocs);
 
     return {};
 }
 
 core::expected<AppError> Application::start() {
     g_appIsRunning = true;
+
+    if constexpr (InputThread::SUPPORTED) {
+        InputThread::start();
+    }
+
     while (Application::isRunning()) {
-        if (auto err = Platform::pollEvents(false); !err.isOk()) {
-            return core::unexpected(err);
+        // Wait before sampling input, not after, so the frame is built from the freshest input possible.
+        FramePacer::waitForNextFrame();
+        MemoryTracker::frameBegin();
+
+        // Nothing is drawn while minimized, sleep instead of spinning through the loop.
+        bool minimized = Renderer::isMinimized();
+        if constexpr (!InputThread::SUPPORTED) {
+            MemoryScope memScope (MemSubsystem::PLATFORM);
+            if (auto err = Platform::pollEvents(g_inputEvents, minimized); !err.isOk()) {
+                return core::unexpected(err);
+            }
+        }
+        else if (minimized) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(MINIMIZED_POLL_MS));
         }
-        Renderer::drawFrame();
+        processInputEvents();
+        if (!Application::isRunning()) break;
+
+        {
+            MemoryScope memScope (MemSubsystem::RENDERER);
+            Renderer::drawFrame();
+        }
+
+        if (!MemoryTracker::frameEnd()) {
+            return core::unexpected(createPltErr(HEAP_ALLOCATION_IN_FRAME_LOOP,
+                                    "Frame loop allocated on the heap in steady state"));
+        }
+        MemoryTracker::update();
     }
 
     return {};
 }
 
 void Application::shutdown() {
+    InputThread::stop();
+    SceneLoader::shutdown();
+    ShaderHotReload::shutdown();
+
     logSectionTitleInfoTagged(APP_TAG, "BEGIN Renderer Shutdown");
-    Renderer::shutdown();
+    {
+        MemoryScope memScope (MemSubsystem::RENDERER);
+        Renderer::shutdown();
+    }
     logSectionTitleInfoTagged(APP_TAG, "END Renderer Shutdown");
 
+    // After the renderer, the present wait thread reports into the tracker until it is stopped.
+    LatencyTracker::shutdown();
+
     Platform::shutdown();
     logInfoTagged(APP_TAG, "Platform Shutdown");
 
+    // Anything still in use here is a leak.
+    MemoryTracker::logReport();
+
+    AsyncLogger::stop();
     core::destroyProgramCtx();
 }
 
+void Application::fastExit(i32 exitCode) {
+    // Reports requested on the command line still go out.
+    LatencyTracker::shutdown();
+
+    logInfoTagged(APP_TAG, "Fast exit, skipping shutdown");
+    AsyncLogger::stop(); // Drains the queue and closes the log file.
+    std::fflush(stdout);
+    std::fflush(stderr);
+
+    // No atexit handlers and no static destructors, they would run into threads that are still alive.
+    std::_Exit(exitCode);
+}
+
 namespace {
 
 core::expected<AppError> initCoreContext() {
-    static auto globalDebugAllocator = core::StdStatsAllocator{};
-
     // Logger setup
     i32* tagIndicesToIgnore = nullptr;
     addr_size tagsToIgnoreSize = 0;
@@ -107,56 +233,111 @@ core::expected<AppError> initCoreContext() {
     core::setLogLevel(core::LogLevel::L_INFO);
     core::useLoggerANSI(USE_ANSI_LOGGING);
 
+    // The application logs through the async backend, which filters on its own.
+    AsyncLogger::setLevel(AsyncLogger::Level::INFO);
+    for (addr_size i = 0; i < tagsToIgnoreSize; i++) {
+        AsyncLogger::setTagEnabled(u8(tagIndicesToIgnore[i]), false);
+    }
+
     // Set logger tags
     core::setLoggerTag(APP_TAG, appLogTagsToCStr(APP_TAG));
     core::setLoggerTag(INPUT_EVENTS_TAG, appLogTagsToCStr(INPUT_EVENTS_TAG));
     core::setLoggerTag(RENDERER_TAG, appLogTagsToCStr(RENDERER_TAG));
+    core::setLoggerTag(LOADER_TAG, appLogTagsToCStr(LOADER_TAG));
 
     core::initProgramCtx(assertHandler,
                          &loggerCreateInfo,
-                         core::createAllocatorCtx(&globalDebugAllocator));
+                         core::createAllocatorCtx(&MemoryTracker::allocator()));
 
     return {};
 }
 
-void registerEventHandlers() {
-    Platform::registerWindowCloseCallback([]() {
-        logInfoTagged(INPUT_EVENTS_TAG, "Closing Application!");
-        g_appIsRunning = false;
-    });
-    Platform::registerWindowResizeCallback([](i32 w, i32 h) {
-        logInfoTagged(INPUT_EVENTS_TAG, "EVENT: WINDOW_RESIZE (w={}, h={})", w, h);
-        Renderer::resizeTarget(w, h);
-    });
-    Platform::registerWindowFocusCallback([](bool focus) {
-        if (focus) logInfoTagged(INPUT_EVENTS_TAG, "EVENT: WINDOW_FOCUS_GAINED");
-        else       logInfoTagged(INPUT_EVENTS_TAG, "EVENT: WINDOW_FOCUS_LOST");
-    });
-    Platform::registerKeyCallback([](bool isPress, u32 vkcode, u32 scancode, KeyboardModifiers mods) {
-        logTraceTagged(INPUT_EVENTS_TAG, "EVENT: KEY_{} (vkcode={}, scancode={}, mods={})",
-                       isPress ? "PRESS" : "RELEASE", vkcode, scancode, keyModifiersToCptr(mods));
-    });
-    Platform::registerMouseClickCallback([](bool isPress, MouseButton button, i32 x, i32 y, KeyboardModifiers mods) {
-        logTraceTagged(INPUT_EVENTS_TAG, "EVENT: MOUSE_{} (button={}, x={}, y={}, mods={})",
-                       isPress ? "PRESS" : "RELEASE", button, x, y, keyModifiersToCptr(mods));
-    });
-    Platform::registerMouseMoveCallback([](i32 x, i32 y) {
-        // NOTE: Very noisy.
-        logTraceTagged(INPUT_EVENTS_TAG, "EVENT: MOUSE_MOVE (x={}, y={})", x, y);
-    });
-    Platform::registerMouseScrollCallback([](MouseScrollDirection direction, i32 x, i32 y) {
-        logTraceTagged(INPUT_EVENTS_TAG, "EVENT: MOUSE_SCROLL (direction={}, x={}, y={})", direction, x, y);
-    });
-    Platform::registerMouseEnterOrLeaveCallback([](bool enter) {
-        if (enter) logTraceTagged(INPUT_EVENTS_TAG, "EVENT: MOUSE_ENTER");
-        else       logTraceTagged(INPUT_EVENTS_TAG, "EVENT: MOUSE_LEAVE");
-    });
-
-    logInfo("Registered event handlers SUCCESSFULLY");
+void processInputEvents() {
+    InputEvent ev;
+    u64 dropped;
+    if constexpr (InputThread::SUPPORTED) {
+        while (InputThread::pop(ev)) {
+            handleInputEvent(ev);
+        }
+        dropped = InputThread::droppedCount();
+    }
+    else {
+        while (g_inputEvents.pop(ev)) {
+            handleInputEvent(ev);
+        }
+        dropped = g_inputEvents.droppedCount();
+    }
+
+    if (dropped != g_reportedDroppedEvents) {
+        logWarnTagged(INPUT_EVENTS_TAG, "Input event queue overflowed, {} events dropped so far", dropped);
+        g_reportedDroppedEvents = dropped;
+    }
+}
+
+void handleInputEvent(const InputEvent& ev) {
+    LatencyTracker::recordInput(ev);
+
+    switch (ev.type) {
+        case InputEventType::WINDOW_CLOSE:
+            logInfoTagged(INPUT_EVENTS_TAG, "Closing Application!");
+            g_appIsRunning = false;
+            break;
+
+        case InputEventType::WINDOW_RESIZE:
+            logInfoTagged(INPUT_EVENTS_TAG, "EVENT: WINDOW_RESIZE (w={}, h={})", ev.resize.w, ev.resize.h);
+            Renderer::resizeTarget(ev.resize.w, ev.resize.h);
+            break;
+
+        case InputEventType::WINDOW_FOCUS:
+            if (ev.focus.gain) logInfoTagged(INPUT_EVENTS_TAG, "EVENT: WINDOW_FOCUS_GAINED");
+            else               logInfoTagged(INPUT_EVENTS_TAG, "EVENT: WINDOW_FOCUS_LOST");
+            break;
+
+        case InputEventType::KEY:
+            logTraceTagged(INPUT_EVENTS_TAG, "EVENT: KEY_{} (vkcode={}, scancode={}, mods={})",
+                           ev.key.isPress ? "PRESS" : "RELEASE", ev.key.vkcode, ev.key.scancode,
+                           keyModifiersToCptr(ev.key.mods));
+
+            if (ev.key.isPress) {
+                for (u32 i = 0; i < u32(PacingMode::COUNT); i++) {
+                    if (ev.key.vkcode == PACING_MODE_KEYS[i]) FramePacer::setMode(PacingMode(i));
+                }
+                for (u32 i = 0; i < u32(ShadingMode::COUNT); i++) {
+                    if (ev.key.vkcode == SHADING_MODE_KEYS[i]) Renderer::setShadingMode(ShadingMode(i));
+                }
+            }
+            break;
+
+        case InputEventType::MOUSE_CLICK:
+            logTraceTagged(INPUT_EVENTS_TAG, "EVENT: MOUSE_{} (button={}, x={}, y={}, mods={})",
+                           ev.click.isPress ? "PRESS" : "RELEASE", ev.click.button, ev.click.x, ev.click.y,
+                           keyModifiersToCptr(ev.click.mods));
+            break;
+
+        case InputEventType::MOUSE_MOVE:
+            // NOTE: Very noisy.
+            logTraceTagged(INPUT_EVENTS_TAG, "EVENT: MOUSE_MOVE (x={}, y={})", ev.move.x, ev.move.y);
+            break;
+
+        case InputEventType::MOUSE_SCROLL:
+            logTraceTagged(INPUT_EVENTS_TAG, "EVENT: MOUSE_SCROLL (direction={}, x={}, y={})",
+                           ev.scroll.direction, ev.scroll.x, ev.scroll.y);
+            break;
+
+        case InputEventType::MOUSE_ENTER_OR_LEAVE:
+            if (ev.enterOrLeave.enter) logTraceTagged(INPUT_EVENTS_TAG, "EVENT: MOUSE_ENTER");
+            else                       logTraceTagged(INPUT_EVENTS_TAG, "EVENT: MOUSE_LEAVE");
+            break;
+
+        case InputEventType::NONE:
+            break;
+    }
 }
 
 void assertHandler(const char* failedExpr, const char* file, i32 line, const char* funcName, const char* errMsg) {
-    // Using iostream here since assertions can happen inside core as well.
+    // Using iostream here since assertions can happen inside core as well. Whatever was logged before the assertion
+    // goes out first.
+    AsyncLogger::flush();
 
     // Get a stack trace of at max 200 stack frames, skipping the first 2. The first stack frame is this assert handler
     // frame and the second is the function itself, for which we already have information.
@@ -190,14 +371,4 @@ void assertHandler(const char* failedExpr, const char* file, i32 line, const cha
     throw std::runtime_error("Assertion failed!");
 };
 
-void __debugPrintMemoryUsage() {
-    core::AllocatorContext& gactx = core::getAllocator(0);
-    addr_size inUseMemory = gactx.inUseMemory();
-    addr_size totalMemoryAllocated = gactx.totalMemoryAllocated();
-    char buff[128];
-    logInfo(ANSI_BOLD("Memory in_use: {}, total_allocated: {}"),
-            core::testing::memoryUsedToStr(buff, inUseMemory),
-            core::testing::memoryUsedToStr(buff, totalMemoryAllocated));
-}
-
 } // namespace
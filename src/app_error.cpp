@@ -81,6 +81,8 @@ constexpr const char* rendErrorToCStr(RendererError e) {
             return "Failed to allocate Vulkan Semaphore";
         case RendererError::FAILED_TO_ALLOCATE_VULKAN_FENCE:
             return "Failed to allocate Vulkan Fence";
+        case RendererError::FAILED_TO_CREATE_VULKAN_COMPUTE_PIPELINE:
+            return "Failed to create Vulkan Compute Pipeline";
     }
     return "unknown";
 }
@@ -0,0 +1,540 @@
+#include <async_file_reader.h>
+#include <app_logger.h>
+#include <worker_pool.h>
+
+#include <atomic>
+#include <cerrno>
+#include <latch>
+
+#if defined(OS_WIN) && OS_WIN == 1
+    // Reads fall back to core::fileReadEntire.
+#else
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#if defined(OS_LINUX) && OS_LINUX == 1
+    #include <linux/io_uring.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+#endif
+
+namespace {
+
+struct BatchState;
+
+struct PendingFile {
+    AsyncFileReader::Completion completion;
+    BatchState* batch = nullptr;
+};
+
+struct BatchState {
+    const AsyncFileReader::BatchInfo* info = nullptr;
+    core::ArrList<PendingFile> files;
+    std::latch* parsed = nullptr;
+};
+
+void parseJob(void* userData);
+void handOffToParser(PendingFile& file);
+
+void readBatchThreadPool(BatchState& batch);
+void readFilesThreadPool(BatchState& batch, core::Memory<const u32> fileIdxs);
+void readFileJob(void* userData);
+
+#if defined(OS_LINUX) && OS_LINUX == 1
+bool readBatchIoUring(BatchState& batch);
+#endif
+
+} // namespace
+
+AsyncFileReader::Backend AsyncFileReader::readBatch(const BatchInfo& info) {
+    Assert(info.onComplete, "Completion callback is required");
+    Assert(info.parserPool, "Parser pool is required");
+    Assert(info.maxReadsInFlight > 0 && info.chunkSize > 0, "Invalid batch configuration");
+
+    addr_size count = info.requests.len();
+    if (count == 0) {
+        return info.preferredBackend;
+    }
+
+    std::latch parsed { std::ptrdiff_t(count) };
+
+    BatchState batch;
+    batch.info = &info;
+    batch.parsed = &parsed;
+    batch.files = core::ArrList<PendingFile>(count); // No reallocation after this, the parser jobs point into it.
+    for (addr_size i = 0; i < count; i++) {
+        PendingFile file;
+        file.completion.path = info.requests[i].path;
+        file.completion.userData = info.requests[i].userData;
+        file.batch = &batch;
+        batch.files.push(std::move(file));
+    }
+
+    Backend used = Backend::THREAD_POOL;
+
+#if defined(OS_LINUX) && OS_LINUX == 1
+    if (info.preferredBackend == Backend::IO_URING) {
+        if (readBatchIoUring(batch)) {
+            used = Backend::IO_URING;
+        }
+        else {
+            logWarnTagged(LOADER_TAG, "io_uring is not available, falling back to the thread pool reader");
+        }
+    }
+#endif
+
+    if (used == Backend::THREAD_POOL) {
+        readBatchThreadPool(batch);
+    }
+
+    parsed.wait();
+    return used;
+}
+
+const char* AsyncFileReader::backendToCStr(Backend backend) {
+    switch (backend) {
+        case Backend::IO_URING:    return "io_uring";
+        case Backend::THREAD_POOL: return "thread pool";
+    }
+    return "unknown";
+}
+
+namespace {
+
+void parseJob(void* userData) {
+    PendingFile& file = *reinterpret_cast<PendingFile*>(userData);
+    BatchState& batch = *file.batch;
+    batch.info->onComplete(file.completion);
+    batch.parsed->count_down();
+}
+
+void handOffToParser(PendingFile& file) {
+    file.batch->info->parserPool->submit(parseJob, &file);
+}
+
+// ---------------------------------------- Thread pool backend --------------------------------------------------------
+
+void readBatchThreadPool(BatchState& batch) {
+    // One blocking read per I/O thread, so the thread count is the number of reads in flight.
+    WorkerPool ioPool;
+    ioPool.init(batch.info->maxReadsInFlight);
+
+    for (addr_size i = 0; i < batch.files.len(); i++) {
+        ioPool.submit(readFileJob, &batch.files[i]);
+    }
+
+    ioPool.shutdown();
+}
+
+// Same as above for a subset of the batch.
+void readFilesThreadPool(BatchState& batch, core::Memory<const u32> fileIdxs) {
+    if (fileIdxs.len() == 0) return;
+
+    WorkerPool ioPool;
+    ioPool.init(batch.info->maxReadsInFlight);
+
+    for (addr_size i = 0; i < fileIdxs.len(); i++) {
+        ioPool.submit(readFileJob, &batch.files[fileIdxs[i]]);
+    }
+
+    ioPool.shutdown();
+}
+
+void readFileJob(void* userData) {
+    PendingFile& file = *reinterpret_cast<PendingFile*>(userData);
+    AsyncFileReader::Completion& c = file.completion;
+
+#if defined(OS_WIN) && OS_WIN == 1
+    if (auto res = core::fileReadEntire(c.path, c.data); res.hasErr()) {
+        c.errCode = EIO;
+    }
+#else
+    i32 fd = ::open(c.path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        c.errCode = errno;
+        handOffToParser(file);
+        return;
+    }
+    defer { ::close(fd); };
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        c.errCode = errno;
+        handOffToParser(file);
+        return;
+    }
+
+    addr_size size = addr_size(st.st_size);
+    c.data = core::ArrList<u8>(size, u8(0));
+
+    #if defined(OS_LINUX) && OS_LINUX == 1
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    #endif
+
+    addr_size offset = 0;
+    addr_size chunkSize = file.batch->info->chunkSize;
+    while (offset < size) {
+        addr_size len = size - offset < chunkSize ? size - offset : chunkSize;
+        ssize_t n = ::pread(fd, c.data.data() + offset, len, off_t(offset));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            c.errCode = errno;
+            break;
+        }
+        if (n == 0) {
+            // The file was truncated while reading it.
+            c.errCode = EIO;
+            break;
+        }
+        offset += addr_size(n);
+    }
+#endif
+
+    if (c.errCode != 0) c.data.free();
+    handOffToParser(file);
+}
+
+// ---------------------------------------- io_uring backend -----------------------------------------------------------
+
+#if defined(OS_LINUX) && OS_LINUX == 1
+
+struct IoUring {
+    i32 fd = -1;
+
+    u32* sqTail = nullptr;
+    u32 sqMask = 0;
+    u32* sqArray = nullptr;
+    io_uring_sqe* sqes = nullptr;
+
+    u32* cqHead = nullptr;
+    u32* cqTail = nullptr;
+    u32 cqMask = 0;
+    io_uring_cqe* cqes = nullptr;
+
+    void* sqRing = nullptr;
+    addr_size sqRingSize = 0;
+    void* cqRing = nullptr;
+    addr_size cqRingSize = 0;
+    addr_size sqesSize = 0;
+};
+
+struct UringFile {
+    i32 fd = -1;
+    addr_size size = 0;
+    addr_size submitted = 0;
+    addr_size completed = 0;
+    u32 readsInFlight = 0;
+    i32 err = 0;
+    bool opened = false;
+    bool finished = false;
+};
+
+struct UringRead {
+    u32 fileIdx = 0;
+    u32 len = 0;
+    addr_size offset = 0;
+};
+
+bool ioUringInit(IoUring& ring, u32 entries) {
+    io_uring_params params = {};
+    i32 fd = i32(::syscall(__NR_io_uring_setup, entries, &params));
+    if (fd < 0) {
+        logWarnTagged(LOADER_TAG, "io_uring_setup failed, errno: {}", errno);
+        return false;
+    }
+
+    // IORING_OP_READ landed in the same kernel release as this feature bit, older kernels only have the vectored reads.
+    if (!(params.features & IORING_FEAT_RW_CUR_POS)) {
+        ::close(fd);
+        return false;
+    }
+
+    ring.fd = fd;
+    ring.sqRingSize = params.sq_off.array + params.sq_entries * sizeof(u32);
+    ring.cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    ring.sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+    bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (singleMmap) {
+        if (ring.cqRingSize > ring.sqRingSize) ring.sqRingSize = ring.cqRingSize;
+        ring.cqRingSize = ring.sqRingSize;
+    }
+
+    auto mapRing = [fd](addr_size size, u64 offset) -> void* {
+        void* ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, off_t(offset));
+        return ptr == MAP_FAILED ? nullptr : ptr;
+    };
+
+    ring.sqRing = mapRing(ring.sqRingSize, IORING_OFF_SQ_RING);
+    ring.cqRing = singleMmap ? ring.sqRing : mapRing(ring.cqRingSize, IORING_OFF_CQ_RING);
+    ring.sqes = reinterpret_cast<io_uring_sqe*>(mapRing(ring.sqesSize, IORING_OFF_SQES));
+    if (!ring.sqRing || !ring.cqRing || !ring.sqes) {
+        logWarnTagged(LOADER_TAG, "Failed to map io_uring rings, errno: {}", errno);
+        return false;
+    }
+
+    u8* sq = reinterpret_cast<u8*>(ring.sqRing);
+    ring.sqTail = reinterpret_cast<u32*>(sq + params.sq_off.tail);
+    ring.sqMask = *reinterpret_cast<u32*>(sq + params.sq_off.ring_mask);
+    ring.sqArray = reinterpret_cast<u32*>(sq + params.sq_off.array);
+
+    u8* cq = reinterpret_cast<u8*>(ring.cqRing);
+    ring.cqHead = reinterpret_cast<u32*>(cq + params.cq_off.head);
+    ring.cqTail = reinterpret_cast<u32*>(cq + params.cq_off.tail);
+    ring.cqMask = *reinterpret_cast<u32*>(cq + params.cq_off.ring_mask);
+    ring.cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    return true;
+}
+
+void ioUringDestroy(IoUring& ring) {
+    if (ring.sqes) ::munmap(ring.sqes, ring.sqesSize);
+    if (ring.cqRing && ring.cqRing != ring.sqRing) ::munmap(ring.cqRing, ring.cqRingSize);
+    if (ring.sqRing) ::munmap(ring.sqRing, ring.sqRingSize);
+    if (ring.fd >= 0) ::close(ring.fd);
+    ring = {};
+}
+
+// Only the reading thread touches the submission tail, the kernel reads it after the release store.
+void ioUringQueueRead(IoUring& ring, i32 fd, void* dst, u32 len, addr_size offset, u64 userData) {
+    u32 tail = *ring.sqTail;
+    u32 idx = tail & ring.sqMask;
+
+    io_uring_sqe& sqe = ring.sqes[idx];
+    sqe = {};
+    sqe.opcode = IORING_OP_READ;
+    sqe.fd = fd;
+    sqe.addr = u64(dst);
+    sqe.len = len;
+    sqe.off = u64(offset);
+    sqe.user_data = userData;
+
+    ring.sqArray[idx] = idx;
+    std::atomic_ref<u32>(*ring.sqTail).store(tail + 1, std::memory_order_release);
+}
+
+bool readBatchIoUring(BatchState& batch) {
+    const AsyncFileReader::BatchInfo& info = *batch.info;
+    const u32 maxInFlight = info.maxReadsInFlight;
+
+    // Buffers the kernel may still be reading into after a failed io_uring_enter. Closing the ring cancels or waits
+    // out its outstanding requests, so they are freed only after it, hence declared before it.
+    core::ArrList<core::ArrList<u8>> parkedBuffers;
+
+    IoUring ring;
+    defer { ioUringDestroy(ring); };
+    if (!ioUringInit(ring, maxInFlight)) {
+        return false;
+    }
+
+    addr_size fileCount = batch.files.len();
+    core::ArrList<UringFile> files (fileCount, UringFile{});
+    core::ArrList<UringRead> reads (maxInFlight, UringRead{});
+    core::ArrList<u32> freeReads (maxInFlight, u32(0));
+    u32 freeCount = 0;
+    for (u32 i = 0; i < maxInFlight; i++) {
+        freeReads[freeCount++] = maxInFlight - 1 - i;
+    }
+
+    addr_size filesDone = 0;
+    addr_size nextFile = 0;
+    u32 inFlight = 0;
+    u32 unsubmitted = 0;
+
+    auto tryFinish = [&](addr_size idx) {
+        UringFile& f = files[idx];
+        if (f.finished || f.readsInFlight > 0) return;
+        bool done = f.err != 0 || (f.opened && f.completed == f.size);
+        if (!done) return;
+
+        if (f.fd >= 0) ::close(f.fd);
+        f.fd = -1;
+        f.finished = true;
+        filesDone++;
+
+        PendingFile& pending = batch.files[idx];
+        pending.completion.errCode = f.err;
+        if (f.err != 0) pending.completion.data.free();
+        handOffToParser(pending);
+    };
+
+    auto openFile = [&](addr_size idx) {
+        UringFile& f = files[idx];
+        AsyncFileReader::Completion& c = batch.files[idx].completion;
+        f.opened = true;
+
+        f.fd = ::open(c.path, O_RDONLY | O_CLOEXEC);
+        if (f.fd < 0) {
+            f.err = errno;
+            return;
+        }
+
+        struct stat st;
+        if (::fstat(f.fd, &st) != 0) {
+            f.err = errno;
+            return;
+        }
+
+        f.size = addr_size(st.st_size);
+        c.data = core::ArrList<u8>(f.size, u8(0));
+        ::posix_fadvise(f.fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    };
+
+    auto queueRead = [&](u32 readIdx) {
+        UringRead& r = reads[readIdx];
+        UringFile& f = files[r.fileIdx];
+        u8* dst = batch.files[r.fileIdx].completion.data.data() + r.offset;
+        ioUringQueueRead(ring, f.fd, dst, r.len, r.offset, readIdx);
+        f.readsInFlight++;
+        inFlight++;
+        unsubmitted++;
+    };
+
+    // Counts the completions in, without retrying or finishing anything. Used once the ring has failed.
+    auto reapAborted = [&]() {
+        u32 head = *ring.cqHead;
+        u32 tail = std::atomic_ref<u32>(*ring.cqTail).load(std::memory_order_acquire);
+        while (head != tail) {
+            const io_uring_cqe& cqe = ring.cqes[head & ring.cqMask];
+            head++;
+            files[reads[u32(cqe.user_data)].fileIdx].readsInFlight--;
+            inFlight--;
+        }
+        std::atomic_ref<u32>(*ring.cqHead).store(head, std::memory_order_release);
+    };
+
+    // Takes back the reads the kernel has not seen yet and waits for the ones it has, the buffers must not be touched
+    // by the kernel after this. Reads that could not be waited for stay counted in readsInFlight.
+    auto abandonRing = [&]() {
+        // Without SQPOLL the kernel only reads the submission tail inside io_uring_enter, so it can be rewound.
+        u32 tail = *ring.sqTail;
+        for (u32 i = 0; i < unsubmitted; i++) {
+            u32 readIdx = u32(ring.sqes[(tail - 1 - i) & ring.sqMask].user_data);
+            files[reads[readIdx].fileIdx].readsInFlight--;
+            inFlight--;
+        }
+        std::atomic_ref<u32>(*ring.sqTail).store(tail - unsubmitted, std::memory_order_release);
+        unsubmitted = 0;
+
+        while (inFlight > 0) {
+            i32 ret = i32(::syscall(__NR_io_uring_enter, ring.fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+            if (ret < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                logErrTagged(LOADER_TAG, "Failed to wait for the io_uring reads in flight, errno: {}", errno);
+                return;
+            }
+            reapAborted();
+        }
+    };
+
+    bool failed = false;
+    while (filesDone < fileCount) {
+        // Fill every free slot, walking the files in order. Large files are split into chunks so that a single file
+        // can keep the device busy on its own.
+        while (freeCount > 0 && nextFile < fileCount) {
+            UringFile& f = files[nextFile];
+            if (!f.opened) openFile(nextFile);
+            if (f.err != 0 || f.submitted == f.size) {
+                tryFinish(nextFile); // Failed to open or an empty file.
+                nextFile++;
+                continue;
+            }
+
+            addr_size remaining = f.size - f.submitted;
+            u32 len = remaining < info.chunkSize ? u32(remaining) : info.chunkSize;
+
+            u32 readIdx = freeReads[--freeCount];
+            reads[readIdx] = { u32(nextFile), len, f.submitted };
+            queueRead(readIdx);
+            f.submitted += len;
+        }
+
+        if (inFlight == 0) {
+            // Everything left finished without a read, e.g. the last files failed to open.
+            continue;
+        }
+
+        i32 ret = i32(::syscall(__NR_io_uring_enter, ring.fd, unsubmitted, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+        if (ret < 0) {
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY) continue;
+            // Can happen at runtime (ENOMEM, a seccomp filter), the batch is finished on the thread pool instead.
+            logErrTagged(LOADER_TAG, "io_uring_enter failed, errno: {}, reading the rest of the batch on the thread pool",
+                         errno);
+            failed = true;
+            break;
+        }
+        unsubmitted -= u32(ret);
+
+        u32 head = *ring.cqHead;
+        u32 tail = std::atomic_ref<u32>(*ring.cqTail).load(std::memory_order_acquire);
+        while (head != tail) {
+            const io_uring_cqe& cqe = ring.cqes[head & ring.cqMask];
+            head++;
+
+            u32 readIdx = u32(cqe.user_data);
+            UringRead& r = reads[readIdx];
+            UringFile& f = files[r.fileIdx];
+            f.readsInFlight--;
+            inFlight--;
+
+            if (cqe.res < 0) {
+                if ((cqe.res == -EINTR || cqe.res == -EAGAIN) && f.err == 0) {
+                    queueRead(readIdx);
+                    continue;
+                }
+                if (f.err == 0) f.err = -cqe.res;
+            }
+            else if (cqe.res == 0) {
+                // The file was truncated while reading it.
+                if (f.err == 0) f.err = EIO;
+            }
+            else {
+                f.completed += addr_size(cqe.res);
+                if (u32(cqe.res) < r.len && f.err == 0) {
+                    // Short read, queue the rest of the chunk.
+                    r.offset += addr_size(cqe.res);
+                    r.len -= u32(cqe.res);
+                    queueRead(readIdx);
+                    continue;
+                }
+            }
+
+            freeReads[freeCount++] = readIdx;
+            tryFinish(r.fileIdx);
+        }
+        std::atomic_ref<u32>(*ring.cqHead).store(head, std::memory_order_release);
+    }
+
+    if (failed) {
+        abandonRing();
+
+        core::ArrList<u32> retry;
+        for (addr_size i = 0; i < fileCount; i++) {
+            UringFile& f = files[i];
+            if (f.finished) continue;
+            if (f.fd >= 0) ::close(f.fd);
+            f.fd = -1;
+
+            AsyncFileReader::Completion& c = batch.files[i].completion;
+            if (f.readsInFlight > 0) {
+                // The kernel may still write into the buffer, it is freed once the ring is closed.
+                parkedBuffers.push(std::move(c.data));
+                c.errCode = EIO;
+                handOffToParser(batch.files[i]);
+                continue;
+            }
+
+            c.data.free();
+            c.errCode = 0;
+            retry.push(u32(i));
+        }
+        readFilesThreadPool(batch, retry.memView());
+    }
+
+    return true;
+}
+
+#endif
+
+} // namespace
@@ -0,0 +1,293 @@
+#include <app_logger.h>
+#include <async_logger.h>
+#include <mpsc_queue.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Level = AsyncLogger::Level;
+using Record = AsyncLogger::Record;
+
+constexpr addr_size LINE_PREFIX_MAX_LEN = 96;
+constexpr addr_size MAX_LINE_LEN = LINE_PREFIX_MAX_LEN + AsyncLogger::MAX_MESSAGE_LEN + 8; // Color reset and newline.
+constexpr addr_size WRITE_BATCH_SIZE = 64 * core::CORE_KILOBYTE;
+
+MpscQueue<Record, AsyncLogger::RING_CAPACITY> g_ring;
+std::thread g_writerThread;
+std::atomic<bool> g_running = false;
+std::atomic<bool> g_stopRequested = false;
+std::atomic<u64> g_submitted = 0;
+std::atomic<u64> g_written = 0;
+std::atomic<u64> g_dropped = 0;
+
+std::atomic<u8> g_level = u8(Level::INFO);
+std::atomic<u64> g_disabledTags = 0; // One bit per tag.
+
+const Clock::time_point g_startTime = Clock::now();
+FILE* g_file = nullptr;
+bool g_useAnsi = false;
+bool g_atExitRegistered = false;
+
+void writerLoop();
+addr_size formatLine(char* out, const Record& r);
+addr_size copyWithoutAnsi(char* out, const char* msg, addr_size len);
+void writeDirect(const char* data, addr_size len);
+u64 nowNs();
+
+} // namespace
+
+void AsyncLogger::start(const char* filePath, bool useAnsi) {
+    if (g_running.load(std::memory_order_relaxed)) return;
+
+    if (filePath) {
+        g_file = std::fopen(filePath, "w");
+        if (!g_file) {
+            logWarnTagged(APP_TAG, "Failed to open log file: {}, logging to stdout only", filePath);
+        }
+    }
+    // Lines are formatted once for both outputs, keep escape codes out of the file.
+    g_useAnsi = useAnsi && !g_file;
+
+    g_stopRequested.store(false, std::memory_order_relaxed);
+    g_writerThread = std::thread(writerLoop);
+    g_running.store(true, std::memory_order_release);
+
+    // An early return from main after the logger started must not leave the thread running into static destruction.
+    if (!g_atExitRegistered) {
+        std::atexit(AsyncLogger::stop);
+        g_atExitRegistered = true;
+    }
+}
+
+void AsyncLogger::stop() {
+    if (!g_running.load(std::memory_order_acquire)) return;
+
+    g_stopRequested.store(true, std::memory_order_release);
+    g_writerThread.join();
+    g_running.store(false, std::memory_order_release);
+
+    if (g_file) {
+        std::fclose(g_file);
+        g_file = nullptr;
+    }
+
+    if (u64 dropped = droppedCount(); dropped > 0) {
+        logWarnTagged(APP_TAG, "Logger dropped {} messages in total", dropped);
+    }
+}
+
+bool AsyncLogger::isRunning() {
+    return g_running.load(std::memory_order_acquire);
+}
+
+void AsyncLogger::flush() {
+    if (!isRunning()) {
+        std::fflush(stdout);
+        return;
+    }
+
+    u64 target = g_submitted.load(std::memory_order_acquire);
+    while (g_written.load(std::memory_order_acquire) < target) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
+
+u64 AsyncLogger::droppedCount() {
+    return g_dropped.load(std::memory_order_relaxed);
+}
+
+void AsyncLogger::setLevel(Level level) {
+    g_level.store(u8(level), std::memory_order_relaxed);
+}
+
+void AsyncLogger::setTagEnabled(u8 tag, bool enabled) {
+    Assert(tag < MAX_TAGS, "Tag out of range");
+    if (enabled) g_disabledTags.fetch_and(~(u64(1) << tag), std::memory_order_relaxed);
+    else         g_disabledTags.fetch_or(u64(1) << tag, std::memory_order_relaxed);
+}
+
+bool AsyncLogger::isEnabled(Level level, u8 tag) {
+    if (u8(level) < g_level.load(std::memory_order_relaxed)) return false;
+    return (g_disabledTags.load(std::memory_order_relaxed) & (u64(1) << (tag & (MAX_TAGS - 1)))) == 0;
+}
+
+void AsyncLogger::submit(Record& r) {
+    r.timestampNs = nowNs();
+
+    if (r.level == Level::FATAL || !isRunning()) {
+        // Keep the order with whatever is already queued.
+        flush();
+        char line[MAX_LINE_LEN];
+        writeDirect(line, formatLine(line, r));
+        std::fflush(stdout);
+        if (g_file) std::fflush(g_file);
+        return;
+    }
+
+    if (g_ring.push(r)) {
+        g_submitted.fetch_add(1, std::memory_order_release);
+    }
+    else {
+        g_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void AsyncLogger::writeStr(FormatBuffer& out, const char* s) {
+    if (!s) s = "(null)";
+    while (*s) out.put(*s++);
+}
+
+void AsyncLogger::writeU64(FormatBuffer& out, u64 v) {
+    char digits[20];
+    i32 n = 0;
+    do {
+        digits[n++] = char('0' + v % 10);
+        v /= 10;
+    } while (v > 0);
+    while (n > 0) out.put(digits[--n]);
+}
+
+void AsyncLogger::writeI64(FormatBuffer& out, i64 v) {
+    if (v < 0) {
+        out.put('-');
+        writeU64(out, u64(0) - u64(v));
+        return;
+    }
+    writeU64(out, u64(v));
+}
+
+void AsyncLogger::writeF64(FormatBuffer& out, f64 v) {
+    char buf[32];
+    i32 n = std::snprintf(buf, sizeof(buf), "%.6g", v);
+    if (n > 0) out.put(buf, addr_size(n) < sizeof(buf) ? addr_size(n) : sizeof(buf) - 1);
+}
+
+void AsyncLogger::writePtr(FormatBuffer& out, const void* p) {
+    constexpr const char* HEX = "0123456789abcdef";
+    u64 v = u64(reinterpret_cast<uintptr_t>(p));
+    out.put("0x", 2);
+    for (i32 shift = 60; shift >= 0; shift -= 4) {
+        out.put(HEX[(v >> shift) & 0xf]);
+    }
+}
+
+const char* AsyncLogger::copyUntilPlaceholder(FormatBuffer& out, const char* fmt) {
+    while (*fmt) {
+        if (fmt[0] == '{' && fmt[1] == '}') return fmt;
+        out.put(*fmt++);
+    }
+    return fmt;
+}
+
+namespace {
+
+void writerLoop() {
+    static char batch[WRITE_BATCH_SIZE];
+    addr_size batchLen = 0;
+    u64 reportedDropped = 0;
+    Record r;
+
+    auto flushBatch = [&]() {
+        if (batchLen == 0) return;
+        writeDirect(batch, batchLen);
+        batchLen = 0;
+    };
+
+    while (true) {
+        // Read the flag before draining, so nothing pushed before stop() was called is left behind.
+        bool stopping = g_stopRequested.load(std::memory_order_acquire);
+
+        u64 written = 0;
+        while (g_ring.pop(r)) {
+            if (batchLen + MAX_LINE_LEN > WRITE_BATCH_SIZE) flushBatch();
+            batchLen += formatLine(batch + batchLen, r);
+            written++;
+        }
+
+        u64 dropped = g_dropped.load(std::memory_order_relaxed);
+        if (dropped != reportedDropped) {
+            Record warn = {};
+            warn.timestampNs = nowNs();
+            warn.level = Level::WARN;
+            warn.tag = APP_TAG;
+            i32 n = std::snprintf(warn.msg, sizeof(warn.msg), "Log ring overflowed, %llu messages dropped so far",
+                                  static_cast<unsigned long long>(dropped));
+            warn.len = u16(n > 0 ? n : 0);
+            if (batchLen + MAX_LINE_LEN > WRITE_BATCH_SIZE) flushBatch();
+            batchLen += formatLine(batch + batchLen, warn);
+            reportedDropped = dropped;
+        }
+
+        flushBatch();
+        if (written > 0) {
+            std::fflush(stdout);
+            if (g_file) std::fflush(g_file);
+            g_written.fetch_add(written, std::memory_order_release);
+            continue;
+        }
+
+        if (stopping) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(AsyncLogger::IDLE_SLEEP_MS));
+    }
+}
+
+addr_size formatLine(char* out, const Record& r) {
+    static constexpr const char* LEVEL_NAMES[u32(Level::COUNT)] = {
+        "TRACE", "DEBUG", "INFO", "WARN", "ERROR", "FATAL"
+    };
+    static constexpr const char* LEVEL_COLORS[u32(Level::COUNT)] = {
+        "\x1b[2m", "\x1b[36m", "", "\x1b[33m", "\x1b[31m", "\x1b[1;31m"
+    };
+
+    core::StrView tagName = appLogTagsToCStr(AppLogTags(r.tag));
+    const char* color = g_useAnsi ? LEVEL_COLORS[u32(r.level)] : "";
+    const char* reset = g_useAnsi && *color ? "\x1b[0m" : "";
+
+    f64 seconds = f64(r.timestampNs) / 1e9;
+    i32 n = std::snprintf(out, LINE_PREFIX_MAX_LEN, "%s[%12.6f] [%s] [%.*s] ", color, seconds,
+                          LEVEL_NAMES[u32(r.level)], i32(tagName.len()), tagName.data());
+    addr_size len = n > 0 ? core::min(addr_size(n), LINE_PREFIX_MAX_LEN - 1) : 0;
+
+    if (g_useAnsi) {
+        core::memcopy(out + len, r.msg, r.len);
+        len += r.len;
+    }
+    else {
+        // Messages carry their own escape codes (ANSI_BOLD and friends), keep them out of the file too.
+        len += copyWithoutAnsi(out + len, r.msg, r.len);
+    }
+    for (const char* s = reset; *s; s++) out[len++] = *s;
+    out[len++] = '\n';
+    return len;
+}
+
+// Drops CSI sequences, ESC [ parameters and a final byte in the @ to ~ range.
+addr_size copyWithoutAnsi(char* out, const char* msg, addr_size len) {
+    addr_size n = 0;
+    for (addr_size i = 0; i < len; i++) {
+        if (msg[i] == '\x1b' && i + 1 < len && msg[i + 1] == '[') {
+            i += 2;
+            while (i < len && !(msg[i] >= '@' && msg[i] <= '~')) i++;
+            continue;
+        }
+        out[n++] = msg[i];
+    }
+    return n;
+}
+
+void writeDirect(const char* data, addr_size len) {
+    std::fwrite(data, 1, len, stdout);
+    if (g_file) std::fwrite(data, 1, len, g_file);
+}
+
+u64 nowNs() {
+    return u64(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - g_startTime).count());
+}
+
+} // namespace
@@ -0,0 +1,50 @@
+#include <embedded_shaders.h>
+
+#ifndef STLV_EMBED_SHADERS
+    #define STLV_EMBED_SHADERS 0
+#endif
+
+namespace {
+
+struct EmbeddedShader {
+    const char* name;
+    const u32* words;
+    addr_size wordsCount;
+};
+
+#if STLV_EMBED_SHADERS
+
+// Comma separated words written by glslc -mfmt=num. A new shader needs an entry here.
+constexpr u32 MESH_SHADER_VERT[] = {
+    #include "mesh_shader.vert.spirv.inc"
+};
+constexpr u32 MESH_SHADER_FRAG[] = {
+    #include "mesh_shader.frag.spirv.inc"
+};
+constexpr u32 MESH_BOUNDS_COMP[] = {
+    #include "mesh_bounds.comp.spirv.inc"
+};
+
+constexpr EmbeddedShader EMBEDDED_SHADERS[] = {
+    { "mesh_shader.vert", MESH_SHADER_VERT, sizeof(MESH_SHADER_VERT) / sizeof(u32) },
+    { "mesh_shader.frag", MESH_SHADER_FRAG, sizeof(MESH_SHADER_FRAG) / sizeof(u32) },
+    { "mesh_bounds.comp", MESH_BOUNDS_COMP, sizeof(MESH_BOUNDS_COMP) / sizeof(u32) },
+};
+constexpr addr_size EMBEDDED_SHADERS_COUNT = sizeof(EMBEDDED_SHADERS) / sizeof(EMBEDDED_SHADERS[0]);
+
+#endif
+
+} // namespace
+
+core::Memory<const u32> EmbeddedShaders::find([[maybe_unused]] const char* name) {
+#if STLV_EMBED_SHADERS
+    addr_size nameLen = core::cstrLen(name);
+    for (addr_size i = 0; i < EMBEDDED_SHADERS_COUNT; i++) {
+        const EmbeddedShader& s = EMBEDDED_SHADERS[i];
+        if (core::memcmp(s.name, core::cstrLen(s.name), name, nameLen) == 0) {
+            return { s.words, s.wordsCount };
+        }
+    }
+#endif
+    return {};
+}
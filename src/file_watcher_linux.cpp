@@ -0,0 +1,255 @@
+#include <app_logger.h>
+#include <file_watcher.h>
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include <cerrno>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+using PlatformError::Type::FAILED_TO_INITIALIZE_FILE_WATCHER;
+
+namespace {
+
+struct WatchedFile {
+    i32 wd = -1;
+    char path[FileWatcher::MAX_PATH_LEN] = {};
+    const char* fileName = nullptr; // Points into path.
+    FileWatcher::ChangeCallback cb = nullptr; // nullptr marks a free slot.
+    void* userData = nullptr;
+    i64 firesAtMs = -1; // Pending notification, -1 when there is none.
+};
+
+i32 g_inotifyFd = -1;
+i32 g_wakeFd = -1;
+std::thread g_thread;
+std::mutex g_mutex;
+std::mutex g_callbackMutex; // Held while callbacks run, so unwatch can wait for a running one.
+WatchedFile g_files[FileWatcher::MAX_WATCHED_FILES];
+u32 g_filesCount = 0; // High water mark, unwatched slots below it are reused.
+u32 g_initCount = 0;
+
+void watcherLoop();
+void handleInotifyEvents(i64 nowMs);
+i64 nowMilliseconds();
+
+} // namespace
+
+core::expected<AppError> FileWatcher::init() {
+    if (g_initCount > 0) {
+        g_initCount++;
+        return {};
+    }
+
+    g_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (g_inotifyFd < 0) {
+        logErrTagged(LOADER_TAG, "inotify_init1 failed, errno: {}", errno);
+        return core::unexpected(createPltErr(FAILED_TO_INITIALIZE_FILE_WATCHER, "Failed to initialize inotify"));
+    }
+
+    g_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (g_wakeFd < 0) {
+        logErrTagged(LOADER_TAG, "eventfd failed, errno: {}", errno);
+        close(g_inotifyFd);
+        g_inotifyFd = -1;
+        return core::unexpected(createPltErr(FAILED_TO_INITIALIZE_FILE_WATCHER, "Failed to create wake event"));
+    }
+
+    g_thread = std::thread(watcherLoop);
+    g_initCount = 1;
+    return {};
+}
+
+bool FileWatcher::watch(const char* path, ChangeCallback cb, void* userData) {
+    Assert(g_inotifyFd >= 0, "File watcher is not initialized");
+
+    addr_size pathLen = core::cstrLen(path);
+    if (pathLen + 1 > MAX_PATH_LEN) {
+        logErrTagged(LOADER_TAG, "Path is too long to watch: {}", path);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(g_mutex);
+
+    u32 slot = 0;
+    while (slot < g_filesCount && g_files[slot].cb != nullptr) slot++;
+    if (slot >= MAX_WATCHED_FILES) {
+        logErrTagged(LOADER_TAG, "Too many watched files, ignoring: {}", path);
+        return false;
+    }
+
+    WatchedFile& file = g_files[slot];
+    core::memcopy(file.path, path, pathLen);
+    file.path[pathLen] = '\0';
+
+    // Split into the directory to watch and the file name to match the events against.
+    char dir[MAX_PATH_LEN] = ".";
+    file.fileName = file.path;
+    for (addr_size i = pathLen; i > 0; i--) {
+        if (file.path[i - 1] == '/') {
+            file.fileName = file.path + i;
+            if (i > 1) {
+                core::memcopy(dir, file.path, i - 1);
+                dir[i - 1] = '\0';
+            }
+            else {
+                dir[0] = '/';
+                dir[1] = '\0';
+            }
+            break;
+        }
+    }
+
+    file.wd = inotify_add_watch(g_inotifyFd, dir, IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (file.wd < 0) {
+        logErrTagged(LOADER_TAG, "Failed to watch directory: {}, errno: {}", dir, errno);
+        return false;
+    }
+
+    file.cb = cb;
+    file.userData = userData;
+    file.firesAtMs = -1;
+    if (slot == g_filesCount) g_filesCount++;
+
+    logInfoTagged(LOADER_TAG, "Watching file for changes: {}", path);
+    return true;
+}
+
+void FileWatcher::unwatch(const char* path, ChangeCallback cb) {
+    if (g_inotifyFd < 0) return;
+
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+
+        addr_size pathLen = core::cstrLen(path);
+        for (u32 i = 0; i < g_filesCount; i++) {
+            WatchedFile& file = g_files[i];
+            if (file.cb != cb) continue;
+            if (core::memcmp(file.path, core::cstrLen(file.path), path, pathLen) != 0) continue;
+
+            // inotify returns the same descriptor for every file in a directory, keep it while another file uses it.
+            bool shared = false;
+            for (u32 j = 0; j < g_filesCount; j++) {
+                if (j != i && g_files[j].cb != nullptr && g_files[j].wd == file.wd) shared = true;
+            }
+            if (!shared) inotify_rm_watch(g_inotifyFd, file.wd);
+
+            file = WatchedFile{};
+            logInfoTagged(LOADER_TAG, "Stopped watching file: {}", path);
+            break;
+        }
+    }
+
+    // The watcher thread may have collected the file just before it was removed, wait for that callback to return.
+    std::lock_guard<std::mutex> lock(g_callbackMutex);
+}
+
+void FileWatcher::shutdown() {
+    if (g_inotifyFd < 0) return;
+    if (--g_initCount > 0) return;
+
+    u64 one = 1;
+    [[maybe_unused]] ssize_t written = write(g_wakeFd, &one, sizeof(one));
+    g_thread.join();
+
+    close(g_wakeFd);
+    close(g_inotifyFd);
+    g_wakeFd = -1;
+    g_inotifyFd = -1;
+    g_filesCount = 0;
+}
+
+namespace {
+
+void watcherLoop() {
+    while (true) {
+        // Sleep until an event arrives or until the nearest pending notification is due.
+        i32 timeoutMs = -1;
+        {
+            i64 now = nowMilliseconds();
+            std::lock_guard<std::mutex> lock(g_mutex);
+            for (u32 i = 0; i < g_filesCount; i++) {
+                if (g_files[i].firesAtMs < 0) continue;
+                i32 wait = g_files[i].firesAtMs > now ? i32(g_files[i].firesAtMs - now) : 0;
+                if (timeoutMs < 0 || wait < timeoutMs) timeoutMs = wait;
+            }
+        }
+
+        pollfd fds[2] = {
+            { g_inotifyFd, POLLIN, 0 },
+            { g_wakeFd, POLLIN, 0 },
+        };
+        i32 ret = poll(fds, 2, timeoutMs);
+        if (ret < 0 && errno != EINTR) {
+            logErrTagged(LOADER_TAG, "File watcher poll failed, errno: {}", errno);
+            return;
+        }
+
+        if (fds[1].revents & POLLIN) {
+            return; // Shutdown was requested.
+        }
+
+        i64 now = nowMilliseconds();
+        if (fds[0].revents & POLLIN) {
+            handleInotifyEvents(now);
+        }
+
+        // Collect due notifications under the lock, run the callbacks outside of it. Copies, because a slot can be
+        // unwatched and reused by watch while the callbacks run.
+        static WatchedFile dueFiles[FileWatcher::MAX_WATCHED_FILES];
+        u32 dueCount = 0;
+        std::lock_guard<std::mutex> callbackLock(g_callbackMutex);
+        {
+            std::lock_guard<std::mutex> lock(g_mutex);
+            for (u32 i = 0; i < g_filesCount; i++) {
+                if (g_files[i].cb != nullptr && g_files[i].firesAtMs >= 0 && g_files[i].firesAtMs <= now) {
+                    g_files[i].firesAtMs = -1;
+                    dueFiles[dueCount++] = g_files[i];
+                }
+            }
+        }
+
+        for (u32 i = 0; i < dueCount; i++) {
+            dueFiles[i].cb(dueFiles[i].path, dueFiles[i].userData);
+        }
+    }
+}
+
+void handleInotifyEvents(i64 nowMs) {
+    alignas(inotify_event) char buf[4096];
+
+    while (true) {
+        ssize_t len = read(g_inotifyFd, buf, sizeof(buf));
+        if (len <= 0) {
+            break; // EAGAIN, everything is drained.
+        }
+
+        std::lock_guard<std::mutex> lock(g_mutex);
+        for (char* ptr = buf; ptr < buf + len; ) {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(ptr);
+            ptr += sizeof(inotify_event) + event->len;
+            if (event->len == 0) continue;
+
+            addr_size nameLen = core::cstrLen(event->name);
+            for (u32 i = 0; i < g_filesCount; i++) {
+                WatchedFile& file = g_files[i];
+                if (file.cb == nullptr || file.wd != event->wd) continue;
+                if (core::memcmp(file.fileName, core::cstrLen(file.fileName), event->name, nameLen) != 0) continue;
+
+                // Push the deadline back on every event, so a burst of writes results in a single notification.
+                file.firesAtMs = nowMs + FileWatcher::DEBOUNCE_MS;
+            }
+        }
+    }
+}
+
+i64 nowMilliseconds() {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
@@ -0,0 +1,17 @@
+#include <app_logger.h>
+#include <file_watcher.h>
+
+// TODO: Implement with ReadDirectoryChangesW on Windows and FSEvents on macOS.
+
+core::expected<AppError> FileWatcher::init() {
+    return {};
+}
+
+bool FileWatcher::watch(const char* path, ChangeCallback, void*) {
+    logWarnTagged(LOADER_TAG, "File watching is not supported on this platform, ignoring: {}", path);
+    return false;
+}
+
+void FileWatcher::unwatch(const char*, ChangeCallback) {}
+
+void FileWatcher::shutdown() {}
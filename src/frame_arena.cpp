@@ -0,0 +1,98 @@
+#include <app_logger.h>
+#include <frame_arena.h>
+
+struct FrameArena::OverflowBlock {
+    OverflowBlock* next;
+    addr_size size; // Including this header.
+};
+
+namespace {
+
+constexpr addr_size alignUp(addr_size v, addr_size alignment) {
+    return (v + alignment - 1) & ~(alignment - 1);
+}
+
+constexpr addr_size OVERFLOW_HEADER_SIZE = alignUp(sizeof(FrameArena::OverflowBlock), FrameArena::MAX_ALIGNMENT);
+
+u8* allocBlock(addr_size size);
+void freeBlock(void* block, addr_size size);
+void freeOverflow(FrameArena& arena);
+
+} // namespace
+
+FrameArena FrameArena::create(addr_size capacity) {
+    FrameArena arena = {};
+    arena.capacity = alignUp(capacity, MAX_ALIGNMENT);
+    arena.data = allocBlock(arena.capacity);
+    return arena;
+}
+
+void FrameArena::destroy(FrameArena& arena) {
+    defer { arena = {}; };
+
+    freeOverflow(arena);
+    if (arena.data) freeBlock(arena.data, arena.capacity);
+}
+
+void FrameArena::reset(FrameArena& arena) {
+    if (arena.overflow) {
+        freeOverflow(arena);
+
+        // Grow once to fit the whole of the frame that overflowed, with some headroom for the next one.
+        addr_size newCapacity = alignUp(arena.highWater + arena.highWater / 2, MAX_ALIGNMENT);
+        logInfoTagged(APP_TAG, "Frame arena overflowed, growing from {} to {} bytes", arena.capacity, newCapacity);
+        freeBlock(arena.data, arena.capacity);
+        arena.data = allocBlock(newCapacity);
+        arena.capacity = newCapacity;
+    }
+
+    arena.used = 0;
+    arena.highWater = 0;
+}
+
+void* FrameArena::alloc(FrameArena& arena, addr_size size, addr_size alignment) {
+    Assert(alignment > 0 && alignment <= MAX_ALIGNMENT && (alignment & (alignment - 1)) == 0, "Invalid alignment");
+
+    addr_size offset = alignUp(arena.used, alignment);
+    if (offset + size <= arena.capacity) {
+        arena.used = offset + size;
+        if (arena.used > arena.highWater) arena.highWater = arena.used;
+        return arena.data + offset;
+    }
+
+    // Out of space. The block lives until the next reset, same as everything else in the arena.
+    addr_size blockSize = OVERFLOW_HEADER_SIZE + size;
+    u8* block = allocBlock(blockSize);
+    OverflowBlock* header = reinterpret_cast<OverflowBlock*>(block);
+    header->next = arena.overflow;
+    header->size = blockSize;
+    arena.overflow = header;
+    arena.overflowCount++;
+    arena.highWater += alignUp(size, MAX_ALIGNMENT);
+
+    return block + OVERFLOW_HEADER_SIZE;
+}
+
+namespace {
+
+u8* allocBlock(addr_size size) {
+    void* block = core::getAllocator(core::DEFAULT_ALLOCATOR_ID).alloc(size, sizeof(u8));
+    Panic(block, "Failed to allocate frame arena memory");
+    return reinterpret_cast<u8*>(block);
+}
+
+void freeBlock(void* block, addr_size size) {
+    core::getAllocator(core::DEFAULT_ALLOCATOR_ID).free(block, size, sizeof(u8));
+}
+
+void freeOverflow(FrameArena& arena) {
+    FrameArena::OverflowBlock* curr = arena.overflow;
+    while (curr) {
+        FrameArena::OverflowBlock* next = curr->next;
+        freeBlock(curr, curr->size);
+        curr = next;
+    }
+    arena.overflow = nullptr;
+}
+
+} // namespace
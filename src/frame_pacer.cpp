@@ -0,0 +1,123 @@
+#include <app_logger.h>
+#include <frame_pacer.h>
+#include <renderer.h>
+
+#include <chrono>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+PacingMode g_mode = PacingMode::UNCAPPED;
+u32 g_frameLimitFps = 0;
+
+bool g_hasDeadline = false;
+Clock::time_point g_nextFrameStart;
+u64 g_sleepMarginNs = 1000 * 1000; // Starts pessimistic, adapts after the first few frames.
+
+void preciseSleepUntil(Clock::time_point deadline);
+
+} // namespace
+
+const char* pacingModeToCStr(PacingMode mode) {
+    switch (mode) {
+        case PacingMode::UNCAPPED:     return "uncapped";
+        case PacingMode::LOW_LATENCY:  return "low-latency";
+        case PacingMode::POWER_SAVING: return "power-saving";
+        case PacingMode::ADAPTIVE:     return "adaptive";
+        case PacingMode::COUNT:        break;
+    }
+    return "unknown";
+}
+
+bool pacingModeFromCStr(const char* str, PacingMode& out) {
+    addr_size strLen = core::cstrLen(str);
+    for (u8 i = 0; i < u8(PacingMode::COUNT); i++) {
+        const char* name = pacingModeToCStr(PacingMode(i));
+        if (core::memcmp(str, strLen, name, core::cstrLen(name)) == 0) {
+            out = PacingMode(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+void FramePacer::init(PacingMode mode, u32 frameLimitFps) {
+    g_mode = mode;
+    g_frameLimitFps = frameLimitFps;
+    g_hasDeadline = false;
+    logInfoTagged(APP_TAG, "Frame pacing: {}, frame limit: {}", pacingModeToCStr(g_mode), effectiveFrameLimit());
+}
+
+void FramePacer::setMode(PacingMode mode) {
+    if (mode == g_mode) return;
+
+    g_mode = mode;
+    g_hasDeadline = false;
+    Renderer::setPacingMode(mode);
+    logInfoTagged(APP_TAG, "Frame pacing changed to: {}, frame limit: {}", pacingModeToCStr(g_mode), effectiveFrameLimit());
+}
+
+void FramePacer::setFrameLimit(u32 fps) {
+    g_frameLimitFps = fps;
+    g_hasDeadline = false;
+}
+
+PacingMode FramePacer::mode() {
+    return g_mode;
+}
+
+u32 FramePacer::effectiveFrameLimit() {
+    if (g_frameLimitFps == 0 && g_mode == PacingMode::POWER_SAVING) {
+        return POWER_SAVING_DEFAULT_FPS;
+    }
+    return g_frameLimitFps;
+}
+
+void FramePacer::waitForNextFrame() {
+    u32 fps = effectiveFrameLimit();
+    if (fps == 0) return;
+
+    auto period = std::chrono::nanoseconds(1000000000ull / fps);
+    if (!g_hasDeadline) {
+        g_nextFrameStart = Clock::now() + period;
+        g_hasDeadline = true;
+        return;
+    }
+
+    preciseSleepUntil(g_nextFrameStart);
+
+    // Schedule from the deadline and not from the wake up time, so the rate does not drift. After a stall longer than
+    // a frame start over instead of rushing out frames to catch up.
+    g_nextFrameStart += period;
+    auto now = Clock::now();
+    if (g_nextFrameStart < now) {
+        g_nextFrameStart = now + period;
+    }
+}
+
+namespace {
+
+void preciseSleepUntil(Clock::time_point deadline) {
+    auto sleepUntil = deadline - std::chrono::nanoseconds(g_sleepMarginNs);
+    if (Clock::now() < sleepUntil) {
+        std::this_thread::sleep_until(sleepUntil);
+
+        // Grow the margin right away when the sleep overshot it, shrink it slowly otherwise.
+        u64 overshootNs = u64(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - sleepUntil).count());
+        if (overshootNs > g_sleepMarginNs) {
+            g_sleepMarginNs = overshootNs + overshootNs / 4;
+            if (g_sleepMarginNs > FramePacer::MAX_SLEEP_MARGIN_NS) g_sleepMarginNs = FramePacer::MAX_SLEEP_MARGIN_NS;
+        }
+        else {
+            g_sleepMarginNs -= (g_sleepMarginNs - overshootNs) / 16;
+        }
+    }
+
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+} // namespace
@@ -0,0 +1,97 @@
+#include <app_logger.h>
+#include <input_thread.h>
+#include <memory_tracker.h>
+#include <platform.h>
+#include <spsc_queue.h>
+
+#include <atomic>
+#include <thread>
+
+namespace {
+
+SpscQueue<InputEvent, InputThread::CHANNEL_CAPACITY> g_channel;
+std::thread g_thread;
+std::atomic<bool> g_stopRequested = false;
+std::atomic<u64> g_dropped = 0;
+bool g_running = false;
+
+void inputLoop();
+
+} // namespace
+
+void InputThread::start() {
+    if constexpr (!SUPPORTED) {
+        Panic(false, "Input thread is not supported on this platform");
+    }
+
+    Assert(!g_running, "Input thread is already running");
+    g_stopRequested.store(false, std::memory_order_relaxed);
+    g_thread = std::thread(inputLoop);
+    g_running = true;
+    logInfoTagged(INPUT_EVENTS_TAG, "Input thread started");
+}
+
+void InputThread::stop() {
+    if (!g_running) return;
+
+    g_stopRequested.store(true, std::memory_order_relaxed);
+#if defined(USE_X11)
+    Platform::wakeEventWait();
+#endif
+    g_thread.join();
+    g_running = false;
+    logInfoTagged(INPUT_EVENTS_TAG, "Input thread stopped");
+}
+
+bool InputThread::pop(InputEvent& out) {
+    return g_channel.pop(out);
+}
+
+u64 InputThread::droppedCount() {
+    return g_dropped.load(std::memory_order_relaxed);
+}
+
+namespace {
+
+void inputLoop() {
+    MemoryScope memScope (MemSubsystem::PLATFORM);
+
+#if defined(USE_X11)
+    // Xlib or the Vulkan WSI can read events off the socket while the render thread waits for a reply, which leaves
+    // them in the client side queue without waking up this thread. The timeout bounds how long they can sit there.
+    constexpr i32 WAIT_TIMEOUT_MS = 10;
+    // Used while the channel is full and the render thread has to catch up.
+    constexpr i32 BACKPRESSURE_WAIT_MS = 1;
+
+    // Events that did not fit into the channel wait here. It keeps coalescing mouse moves while the render thread is
+    // behind and counts what it has to drop.
+    static InputEventQueue pending;
+
+    bool failed = false;
+    while (!g_stopRequested.load(std::memory_order_relaxed)) {
+        Platform::waitForEvents(pending.empty() ? WAIT_TIMEOUT_MS : BACKPRESSURE_WAIT_MS);
+
+        if (!failed) {
+            if (auto err = Platform::pollEvents(pending, false); !err.isOk()) {
+                // Same outcome as a failed poll on the render thread, the application shuts down. Keep running until
+                // the close event is handed over.
+                logErrTagged(INPUT_EVENTS_TAG, "Input thread failed to poll events: {}", err.toCStr());
+                pending.clear();
+                pending.push(InputEvent::createWindowClose());
+                failed = true;
+            }
+        }
+
+        // This thread is the only producer, so the free slot count can only grow while forwarding.
+        InputEvent ev;
+        for (u32 room = g_channel.freeSlots(); room > 0 && pending.pop(ev); room--) {
+            g_channel.push(ev);
+        }
+
+        g_dropped.store(pending.droppedCount(), std::memory_order_relaxed);
+        if (failed && pending.empty()) break;
+    }
+#endif
+}
+
+} // namespace
@@ -0,0 +1,286 @@
+#include <app_logger.h>
+#include <latency_tracker.h>
+
+#include <atomic>
+#include <mutex>
+
+namespace {
+
+constexpr u32 KIND_COUNT = u32(LatencyTracker::InputKind::COUNT);
+constexpr u32 STAGE_COUNT = u32(LatencyTracker::Stage::COUNT);
+
+struct Sample {
+    LatencyTracker::InputKind kind;
+    u64 timestampNs;
+};
+
+struct FrameRecord {
+    u64 presentId = 0;
+    u32 sampleCount = 0;
+    Sample samples[LatencyTracker::MAX_SAMPLES_PER_FRAME];
+};
+
+struct Histogram {
+    u64 buckets[LatencyTracker::HISTOGRAM_BUCKETS] = {};
+    u64 count = 0;
+    u64 sumNs = 0;
+    u64 maxNs = 0;
+
+    void add(u64 ns);
+    f64 percentileMs(f64 p) const;
+    void logSummary(const char* label) const;
+    void logBuckets() const;
+};
+
+// Read by the present wait thread, which can still be running when fastExit calls shutdown.
+std::atomic<bool> g_enabled = false;
+bool g_buttonHeld = false;
+
+// Filled by the thread that consumes input and draws, never shared.
+FrameRecord g_current;
+u64 g_droppedSamples = 0;
+
+// Everything below is shared with the present wait thread.
+std::mutex g_mutex;
+FrameRecord g_awaiting[LatencyTracker::MAX_FRAMES_AWAITING_PRESENT];
+u32 g_awaitingHead = 0;
+u32 g_awaitingCount = 0;
+Histogram g_total[STAGE_COUNT][KIND_COUNT];
+Histogram g_interval[STAGE_COUNT][KIND_COUNT]; // Reset after every periodic report.
+u64 g_lastReportNs = 0;
+
+void addSamples(const FrameRecord& frame, LatencyTracker::Stage stage, u64 nowNs);
+void logIntervalReport();
+f64 nsToMs(u64 ns);
+
+} // namespace
+
+void LatencyTracker::init(bool enabled) {
+    g_enabled.store(enabled, std::memory_order_relaxed);
+    if (!enabled) return;
+
+    g_lastReportNs = inputTimestampNs();
+    logInfoTagged(INPUT_EVENTS_TAG, "Input latency measurement is enabled");
+}
+
+void LatencyTracker::shutdown() {
+    if (!g_enabled.load(std::memory_order_relaxed)) return;
+
+    std::lock_guard<std::mutex> lock(g_mutex);
+
+    logInfoTagged(INPUT_EVENTS_TAG, ANSI_BOLD("Input latency histograms (bucket size: {}us)"), HISTOGRAM_BUCKET_US);
+    for (u32 s = 0; s < STAGE_COUNT; s++) {
+        for (u32 k = 0; k < KIND_COUNT; k++) {
+            const Histogram& h = g_total[s][k];
+            if (h.count == 0) continue;
+
+            logInfoTagged(INPUT_EVENTS_TAG, "{} -> {}:", inputKindToCStr(InputKind(k)), stageToCStr(Stage(s)));
+            h.logSummary("total");
+            h.logBuckets();
+        }
+    }
+    if (g_droppedSamples > 0) {
+        logWarnTagged(INPUT_EVENTS_TAG, "Latency samples dropped: {}", g_droppedSamples);
+    }
+
+    g_enabled.store(false, std::memory_order_relaxed);
+}
+
+bool LatencyTracker::isEnabled() {
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+void LatencyTracker::recordInput(const InputEvent& ev) {
+    if (!g_enabled.load(std::memory_order_relaxed)) return;
+
+    InputKind kind;
+    switch (ev.type) {
+        case InputEventType::MOUSE_CLICK:
+            g_buttonHeld = ev.click.isPress;
+            if (!ev.click.isPress) return;
+            kind = InputKind::CLICK;
+            break;
+
+        case InputEventType::MOUSE_MOVE:
+            if (!g_buttonHeld) return;
+            kind = InputKind::DRAG;
+            break;
+
+        case InputEventType::KEY:
+            if (!ev.key.isPress) return;
+            kind = InputKind::KEY;
+            break;
+
+        default:
+            return;
+    }
+
+    if (g_current.sampleCount == MAX_SAMPLES_PER_FRAME) {
+        g_droppedSamples++;
+        return;
+    }
+    g_current.samples[g_current.sampleCount++] = { kind, ev.timestampNs };
+}
+
+bool LatencyTracker::framePresented(u64 presentId) {
+    if (!g_enabled.load(std::memory_order_relaxed)) return false;
+
+    u64 now = inputTimestampNs();
+    std::lock_guard<std::mutex> lock(g_mutex);
+
+    bool awaitsCompletion = false;
+    if (g_current.sampleCount > 0) {
+        addSamples(g_current, Stage::PRESENT_RETURNED, now);
+
+        if (presentId != 0) {
+            if (g_awaitingCount == MAX_FRAMES_AWAITING_PRESENT) {
+                // The present wait thread fell behind, forget the oldest frame.
+                g_droppedSamples += g_awaiting[g_awaitingHead].sampleCount;
+                g_awaitingHead = (g_awaitingHead + 1) % MAX_FRAMES_AWAITING_PRESENT;
+                g_awaitingCount--;
+            }
+
+            g_current.presentId = presentId;
+            g_awaiting[(g_awaitingHead + g_awaitingCount) % MAX_FRAMES_AWAITING_PRESENT] = g_current;
+            g_awaitingCount++;
+            awaitsCompletion = true;
+        }
+
+        g_current.sampleCount = 0;
+    }
+
+    if (now - g_lastReportNs >= u64(REPORT_INTERVAL_SEC) * 1000000000ull) {
+        logIntervalReport();
+        g_lastReportNs = now;
+    }
+
+    return awaitsCompletion;
+}
+
+void LatencyTracker::framePresentCompleted(u64 presentId, u64 timestampNs) {
+    if (!g_enabled.load(std::memory_order_relaxed)) return;
+
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (!g_enabled.load(std::memory_order_relaxed)) return; // The report was logged while waiting for the lock.
+
+    while (g_awaitingCount > 0) {
+        FrameRecord& frame = g_awaiting[g_awaitingHead];
+        if (frame.presentId > presentId) break;
+
+        // Older ids were never waited for, e.g. their swapchain was retired. They have no completion time.
+        if (frame.presentId == presentId) {
+            addSamples(frame, Stage::PRESENT_COMPLETED, timestampNs);
+        }
+
+        g_awaitingHead = (g_awaitingHead + 1) % MAX_FRAMES_AWAITING_PRESENT;
+        g_awaitingCount--;
+    }
+}
+
+const char* LatencyTracker::inputKindToCStr(InputKind kind) {
+    switch (kind) {
+        case InputKind::CLICK: return "click";
+        case InputKind::DRAG:  return "drag";
+        case InputKind::KEY:   return "key";
+        case InputKind::COUNT: break;
+    }
+    return "unknown";
+}
+
+const char* LatencyTracker::stageToCStr(Stage stage) {
+    switch (stage) {
+        case Stage::PRESENT_RETURNED:  return "present returned";
+        case Stage::PRESENT_COMPLETED: return "present completed";
+        case Stage::COUNT:             break;
+    }
+    return "unknown";
+}
+
+namespace {
+
+void Histogram::add(u64 ns) {
+    u64 bucket = ns / (u64(LatencyTracker::HISTOGRAM_BUCKET_US) * 1000);
+    if (bucket >= LatencyTracker::HISTOGRAM_BUCKETS) bucket = LatencyTracker::HISTOGRAM_BUCKETS - 1;
+
+    buckets[bucket]++;
+    count++;
+    sumNs += ns;
+    if (ns > maxNs) maxNs = ns;
+}
+
+f64 Histogram::percentileMs(f64 p) const {
+    // Upper edge of the bucket that contains the percentile.
+    u64 target = u64(p * f64(count));
+    u64 seen = 0;
+    for (u32 i = 0; i < LatencyTracker::HISTOGRAM_BUCKETS; i++) {
+        seen += buckets[i];
+        if (seen > target) {
+            return f64((i + 1) * LatencyTracker::HISTOGRAM_BUCKET_US) / 1000.0;
+        }
+    }
+    return nsToMs(maxNs);
+}
+
+void Histogram::logSummary(const char* label) const {
+    logInfoTagged(INPUT_EVENTS_TAG, "  {}: n={}, avg={}ms, p50<={}ms, p90<={}ms, p99<={}ms, max={}ms",
+                  label, count, nsToMs(sumNs / count),
+                  percentileMs(0.5), percentileMs(0.9), percentileMs(0.99), nsToMs(maxNs));
+}
+
+void Histogram::logBuckets() const {
+    constexpr u32 BAR_WIDTH = 50;
+
+    u64 maxBucket = 0;
+    for (u32 i = 0; i < LatencyTracker::HISTOGRAM_BUCKETS; i++) {
+        if (buckets[i] > maxBucket) maxBucket = buckets[i];
+    }
+
+    char bar[BAR_WIDTH + 1];
+    for (u32 i = 0; i < LatencyTracker::HISTOGRAM_BUCKETS; i++) {
+        if (buckets[i] == 0) continue;
+
+        u32 barLen = u32((buckets[i] * BAR_WIDTH + maxBucket - 1) / maxBucket);
+        for (u32 j = 0; j < barLen; j++) bar[j] = '#';
+        bar[barLen] = '\0';
+
+        f64 from = f64(i * LatencyTracker::HISTOGRAM_BUCKET_US) / 1000.0;
+        if (i == LatencyTracker::HISTOGRAM_BUCKETS - 1) {
+            logInfoTagged(INPUT_EVENTS_TAG, "    >= {}ms: {} {}", from, buckets[i], bar);
+        }
+        else {
+            f64 to = f64((i + 1) * LatencyTracker::HISTOGRAM_BUCKET_US) / 1000.0;
+            logInfoTagged(INPUT_EVENTS_TAG, "    [{}, {})ms: {} {}", from, to, buckets[i], bar);
+        }
+    }
+}
+
+void addSamples(const FrameRecord& frame, LatencyTracker::Stage stage, u64 nowNs) {
+    for (u32 i = 0; i < frame.sampleCount; i++) {
+        const Sample& sample = frame.samples[i];
+        u64 latency = nowNs > sample.timestampNs ? nowNs - sample.timestampNs : 0;
+        g_total[u32(stage)][u32(sample.kind)].add(latency);
+        g_interval[u32(stage)][u32(sample.kind)].add(latency);
+    }
+}
+
+void logIntervalReport() {
+    for (u32 s = 0; s < STAGE_COUNT; s++) {
+        for (u32 k = 0; k < KIND_COUNT; k++) {
+            Histogram& h = g_interval[s][k];
+            if (h.count == 0) continue;
+
+            logInfoTagged(INPUT_EVENTS_TAG, "Latency {} -> {} (last {}s):",
+                          LatencyTracker::inputKindToCStr(LatencyTracker::InputKind(k)),
+                          LatencyTracker::stageToCStr(LatencyTracker::Stage(s)),
+                          LatencyTracker::REPORT_INTERVAL_SEC);
+            h.logSummary("interval");
+            h = {};
+        }
+    }
+}
+
+f64 nsToMs(u64 ns) {
+    return f64(ns) / 1000000.0;
+}
+
+} // namespace
@@ -0,0 +1,206 @@
+#include <app_logger.h>
+#include <memory_tracker.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct AtomicStats {
+    std::atomic<addr_size> inUse;
+    std::atomic<addr_size> peak;
+    std::atomic<addr_size> totalAllocated;
+    std::atomic<u64> allocationsCount;
+};
+
+struct BlockHeader {
+    addr_size size;
+    MemSubsystem subsystem;
+};
+static_assert(sizeof(BlockHeader) <= TaggedStatsAllocator::HEADER_SIZE);
+
+TaggedStatsAllocator g_allocator;
+AtomicStats g_stats[u32(MemSubsystem::COUNT)];
+
+thread_local MemSubsystem t_subsystem = MemSubsystem::GENERAL;
+thread_local u64 t_allocationsCount = 0;
+
+Clock::time_point g_lastReport;
+bool g_reportStarted = false;
+
+bool g_noAllocCheck = false;
+u32 g_steadyFrames = 0;
+u64 g_frameStartAllocations = 0;
+
+void* trackBlock(void* block, addr_size size);
+
+} // namespace
+
+const char* memSubsystemToCStr(MemSubsystem subsystem) {
+    switch (subsystem) {
+        case MemSubsystem::GENERAL:         return "general";
+        case MemSubsystem::PLATFORM:        return "platform";
+        case MemSubsystem::RENDERER:        return "renderer";
+        case MemSubsystem::LOADER:          return "loader";
+        case MemSubsystem::MESH_PROCESSING: return "mesh processing";
+        case MemSubsystem::COUNT:           break;
+    }
+    return "unknown";
+}
+
+void* TaggedStatsAllocator::alloc(addr_size count, addr_size size) noexcept {
+    addr_size blockSize = count * size;
+    return trackBlock(std::malloc(blockSize + HEADER_SIZE), blockSize);
+}
+
+void* TaggedStatsAllocator::calloc(addr_size count, addr_size size) noexcept {
+    addr_size blockSize = count * size;
+    return trackBlock(std::calloc(1, blockSize + HEADER_SIZE), blockSize);
+}
+
+void TaggedStatsAllocator::free(void* ptr, addr_size, addr_size) noexcept {
+    if (ptr == nullptr) return;
+
+    // The size in the header is authoritative, callers do not always remember how much they asked for.
+    u8* block = reinterpret_cast<u8*>(ptr) - HEADER_SIZE;
+    BlockHeader* header = reinterpret_cast<BlockHeader*>(block);
+    g_stats[u32(header->subsystem)].inUse.fetch_sub(header->size, std::memory_order_relaxed);
+    std::free(block);
+}
+
+void TaggedStatsAllocator::clear() noexcept {
+    // Blocks come straight from malloc, there is nothing to release in bulk.
+}
+
+addr_size TaggedStatsAllocator::totalMemoryAllocated() noexcept {
+    addr_size total = 0;
+    for (u32 i = 0; i < u32(MemSubsystem::COUNT); i++) {
+        total += g_stats[i].totalAllocated.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+addr_size TaggedStatsAllocator::inUseMemory() noexcept {
+    addr_size total = 0;
+    for (u32 i = 0; i < u32(MemSubsystem::COUNT); i++) {
+        total += g_stats[i].inUse.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+MemoryScope::MemoryScope(MemSubsystem subsystem) : m_previous(t_subsystem) {
+    t_subsystem = subsystem;
+}
+
+MemoryScope::~MemoryScope() {
+    t_subsystem = m_previous;
+}
+
+TaggedStatsAllocator& MemoryTracker::allocator() {
+    return g_allocator;
+}
+
+MemoryTracker::Stats MemoryTracker::stats(MemSubsystem subsystem) {
+    const AtomicStats& s = g_stats[u32(subsystem)];
+    Stats ret;
+    ret.inUse = s.inUse.load(std::memory_order_relaxed);
+    ret.peak = s.peak.load(std::memory_order_relaxed);
+    ret.totalAllocated = s.totalAllocated.load(std::memory_order_relaxed);
+    ret.allocationsCount = s.allocationsCount.load(std::memory_order_relaxed);
+    return ret;
+}
+
+void MemoryTracker::logReport() {
+    char inUseBuff[64], peakBuff[64], totalBuff[64];
+    for (u32 i = 0; i < u32(MemSubsystem::COUNT); i++) {
+        Stats s = stats(MemSubsystem(i));
+        logInfoTagged(APP_TAG, "Memory [{}] in_use: {}, peak: {}, total_allocated: {}, allocations: {}",
+                      memSubsystemToCStr(MemSubsystem(i)),
+                      core::testing::memoryUsedToStr(inUseBuff, s.inUse),
+                      core::testing::memoryUsedToStr(peakBuff, s.peak),
+                      core::testing::memoryUsedToStr(totalBuff, s.totalAllocated),
+                      s.allocationsCount);
+    }
+}
+
+u64 MemoryTracker::threadAllocationsCount() {
+    return t_allocationsCount;
+}
+
+void MemoryTracker::update() {
+    auto now = Clock::now();
+    if (!g_reportStarted) {
+        g_lastReport = now;
+        g_reportStarted = true;
+        return;
+    }
+
+    if (now - g_lastReport >= std::chrono::seconds(REPORT_INTERVAL_SEC)) {
+        logReport();
+        g_lastReport = now;
+    }
+}
+
+void MemoryTracker::enableNoAllocCheck(bool enabled) {
+    g_noAllocCheck = enabled;
+    g_steadyFrames = 0;
+    if (enabled) {
+        logInfoTagged(APP_TAG, "No allocation check on, steady state after {} frames", NO_ALLOC_WARMUP_FRAMES);
+    }
+}
+
+bool MemoryTracker::isNoAllocCheckEnabled() {
+    return g_noAllocCheck;
+}
+
+void MemoryTracker::frameBegin() {
+    g_frameStartAllocations = t_allocationsCount;
+}
+
+bool MemoryTracker::frameEnd() {
+    if (!g_noAllocCheck) return true;
+
+    if (g_steadyFrames < NO_ALLOC_WARMUP_FRAMES) {
+        g_steadyFrames++;
+        return true;
+    }
+
+    u64 allocated = t_allocationsCount - g_frameStartAllocations;
+    if (allocated != 0) {
+        logErrTagged(APP_TAG, "Frame loop made {} heap allocations in steady state", allocated);
+        logReport();
+        return false;
+    }
+
+    return true;
+}
+
+void MemoryTracker::restartSteadyState() {
+    g_steadyFrames = 0;
+}
+
+namespace {
+
+void* trackBlock(void* block, addr_size size) {
+    if (block == nullptr) return nullptr;
+
+    BlockHeader* header = reinterpret_cast<BlockHeader*>(block);
+    header->size = size;
+    header->subsystem = t_subsystem;
+
+    AtomicStats& s = g_stats[u32(t_subsystem)];
+    addr_size inUse = s.inUse.fetch_add(size, std::memory_order_relaxed) + size;
+    s.totalAllocated.fetch_add(size, std::memory_order_relaxed);
+    s.allocationsCount.fetch_add(1, std::memory_order_relaxed);
+    t_allocationsCount++;
+
+    addr_size peak = s.peak.load(std::memory_order_relaxed);
+    while (inUse > peak && !s.peak.compare_exchange_weak(peak, inUse, std::memory_order_relaxed)) {}
+
+    return reinterpret_cast<u8*>(block) + TaggedStatsAllocator::HEADER_SIZE;
+}
+
+} // namespace
@@ -0,0 +1,392 @@
+#include <app_logger.h>
+#include <mesh_codec.h>
+#include <stl_loader.h>
+
+namespace {
+
+constexpr addr_size HEADER_SIZE = sizeof(u32) * 2;
+constexpr addr_size GROUPS_PER_BLOCK = MeshCodec::BLOCK_SIZE / MeshCodec::GROUP_SIZE;
+constexpr addr_size MAX_BLOCK_HEADER_SIZE = GROUPS_PER_BLOCK / 4;
+constexpr addr_size MAX_VARINT_SIZE = 5;
+
+enum GroupMode : u8 {
+    GROUP_ZERO = 0,
+    GROUP_2BIT = 1,
+    GROUP_4BIT = 2,
+    GROUP_RAW = 3,
+};
+
+constexpr u8 GROUP_MODE_PAYLOAD_SIZE[] = { 0, 4, 8, 16 };
+
+inline addr_size minSize(addr_size a, addr_size b) { return a < b ? a : b; }
+
+inline u16 zigzag16(u16 d) { return u16((d << 1) ^ u16(i16(d) >> 15)); }
+inline u16 unzigzag16(u16 z) { return u16((z >> 1) ^ u16(-i32(z & 1))); }
+inline u32 zigzag32(u32 d) { return (d << 1) ^ u32(i32(d) >> 31); }
+inline u32 unzigzag32(u32 z) { return (z >> 1) ^ u32(-i32(z & 1)); }
+
+void writeHeader(u8* out, u32 magic, u32 count);
+bool readHeader(core::Memory<const u8> in, u32 magic, u32& outCount);
+
+addr_size encodeBlock(u8* out, const u8* values, addr_size count);
+const u8* decodeBlock(const u8* in, const u8* end, u8* values, addr_size count);
+
+} // namespace
+
+MeshCodec::QuantizedMesh MeshCodec::quantize(const StlMesh& mesh) {
+    QuantizedMesh ret;
+
+    f32 invScale[3];
+    for (i32 i = 0; i < 3; i++) {
+        f32 extent = mesh.boundsMax[i] - mesh.boundsMin[i];
+        ret.offset[i] = mesh.boundsMin[i];
+        ret.scale[i] = extent / 65535.0f;
+        invScale[i] = extent > 0.0f ? 65535.0f / extent : 0.0f;
+    }
+
+    const addr_size soupVertexCount = mesh.vertexCount();
+    if (soupVertexCount == 0) {
+        return ret;
+    }
+
+    // Open addressing hash table from the packed quantized position to the index of the welded vertex.
+    constexpr u32 EMPTY_SLOT = core::limitMax<u32>();
+    addr_size tableSize = 1;
+    u32 tableBits = 0;
+    while (tableSize < soupVertexCount * 2) {
+        tableSize <<= 1;
+        tableBits++;
+    }
+    core::ArrList<u32> table (tableSize, EMPTY_SLOT);
+    const addr_size tableMask = tableSize - 1;
+
+    ret.positions = core::ArrList<u16>(soupVertexCount * 3);
+    ret.indices.replaceWith(0, soupVertexCount);
+
+    const f32* src = mesh.positions.data();
+    u32* indices = ret.indices.data();
+    for (addr_size v = 0; v < soupVertexCount; v++) {
+        u16 q[3];
+        for (i32 i = 0; i < 3; i++) {
+            f32 n = (src[v * 3 + addr_size(i)] - ret.offset[i]) * invScale[i] + 0.5f;
+            q[i] = u16(core::clamp(n, 0.0f, 65535.0f));
+        }
+
+        u64 key = u64(q[0]) | (u64(q[1]) << 16) | (u64(q[2]) << 32);
+        addr_size slot = tableBits > 0 ? addr_size((key * 0x9E3779B97F4A7C15ull) >> (64 - tableBits)) : 0;
+
+        while (true) {
+            u32 existing = table[slot];
+            if (existing == EMPTY_SLOT) {
+                u32 newIdx = u32(ret.positions.len() / 3);
+                ret.positions.push(q[0]);
+                ret.positions.push(q[1]);
+                ret.positions.push(q[2]);
+                table[slot] = newIdx;
+                indices[v] = newIdx;
+                break;
+            }
+
+            const u16* p = ret.positions.data() + addr_size(existing) * 3;
+            if (p[0] == q[0] && p[1] == q[1] && p[2] == q[2]) {
+                indices[v] = existing;
+                break;
+            }
+
+            slot = (slot + 1) & tableMask;
+        }
+    }
+
+    logDebugTagged(LOADER_TAG, "Quantized mesh: {} vertices welded into {}", soupVertexCount, ret.vertexCount());
+
+    return ret;
+}
+
+addr_size MeshCodec::encodePositionsBound(addr_size vertexCount) {
+    addr_size blocks = (vertexCount + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    // 3 axes, 2 byte planes per axis.
+    return HEADER_SIZE + 3 * 2 * blocks * (MAX_BLOCK_HEADER_SIZE + BLOCK_SIZE);
+}
+
+addr_size MeshCodec::encodePositions(core::Memory<u8> out, core::Memory<const u16> positions) {
+    Assert(positions.len() % 3 == 0, "Positions must have 3 components per vertex");
+
+    const addr_size vertexCount = positions.len() / 3;
+    if (out.len() < encodePositionsBound(vertexCount)) {
+        return 0;
+    }
+
+    u8* curr = out.data();
+    writeHeader(curr, POSITIONS_MAGIC, u32(vertexCount));
+    curr += HEADER_SIZE;
+
+    const u16* src = positions.data();
+    u8 lo[BLOCK_SIZE];
+    u8 hi[BLOCK_SIZE];
+
+    for (addr_size axis = 0; axis < 3; axis++) {
+        u16 prev = 0;
+        for (addr_size base = 0; base < vertexCount; base += BLOCK_SIZE) {
+            addr_size count = minSize(BLOCK_SIZE, vertexCount - base);
+
+            for (addr_size i = 0; i < count; i++) {
+                u16 v = src[(base + i) * 3 + axis];
+                u16 z = zigzag16(u16(v - prev));
+                prev = v;
+                lo[i] = u8(z & 0xFF);
+                hi[i] = u8(z >> 8);
+            }
+
+            curr += encodeBlock(curr, lo, count);
+            curr += encodeBlock(curr, hi, count);
+        }
+    }
+
+    return addr_size(curr - out.data());
+}
+
+bool MeshCodec::decodePositions(core::Memory<u16> out, core::Memory<const u8> encoded) {
+    u32 vertexCount = 0;
+    if (!readHeader(encoded, POSITIONS_MAGIC, vertexCount)) return false;
+    if (out.len() < addr_size(vertexCount) * 3) return false;
+
+    const u8* curr = encoded.data() + HEADER_SIZE;
+    const u8* end = encoded.data() + encoded.len();
+    u16* dst = out.data();
+
+    // Decoded groups are always written in full, so the scratch buffers have room for the padding of the last group.
+    u8 lo[BLOCK_SIZE];
+    u8 hi[BLOCK_SIZE];
+
+    for (addr_size axis = 0; axis < 3; axis++) {
+        u16 prev = 0;
+        for (addr_size base = 0; base < vertexCount; base += BLOCK_SIZE) {
+            addr_size count = minSize(BLOCK_SIZE, addr_size(vertexCount) - base);
+
+            curr = decodeBlock(curr, end, lo, count);
+            if (!curr) return false;
+            curr = decodeBlock(curr, end, hi, count);
+            if (!curr) return false;
+
+            u16* blockDst = dst + base * 3 + axis;
+            for (addr_size i = 0; i < count; i++) {
+                u16 z = u16(lo[i] | (u16(hi[i]) << 8));
+                prev = u16(prev + unzigzag16(z));
+                blockDst[i * 3] = prev;
+            }
+        }
+    }
+
+    return true;
+}
+
+addr_size MeshCodec::encodeIndicesBound(addr_size indexCount) {
+    return HEADER_SIZE + indexCount * MAX_VARINT_SIZE;
+}
+
+addr_size MeshCodec::encodeIndices(core::Memory<u8> out, core::Memory<const u32> indices) {
+    if (out.len() < encodeIndicesBound(indices.len())) {
+        return 0;
+    }
+
+    u8* curr = out.data();
+    writeHeader(curr, INDICES_MAGIC, u32(indices.len()));
+    curr += HEADER_SIZE;
+
+    u32 next = 0;
+    u32 last = 0;
+    for (addr_size i = 0; i < indices.len(); i++) {
+        u32 idx = indices[i];
+        u32 code;
+        if (idx == next) {
+            code = 0;
+            next++;
+        }
+        else {
+            code = zigzag32(idx - last) + 1;
+            if (idx > next) next = idx + 1; // Not in first-use order, but still decodable.
+        }
+        last = idx;
+
+        while (code >= 0x80) {
+            *curr++ = u8(code | 0x80);
+            code >>= 7;
+        }
+        *curr++ = u8(code);
+    }
+
+    return addr_size(curr - out.data());
+}
+
+bool MeshCodec::decodeIndices(core::Memory<u32> out, core::Memory<const u8> encoded) {
+    u32 indexCount = 0;
+    if (!readHeader(encoded, INDICES_MAGIC, indexCount)) return false;
+    if (out.len() < addr_size(indexCount)) return false;
+
+    const u8* curr = encoded.data() + HEADER_SIZE;
+    const u8* end = encoded.data() + encoded.len();
+    u32* dst = out.data();
+
+    u32 next = 0;
+    u32 last = 0;
+    for (u32 i = 0; i < indexCount; i++) {
+        if (curr >= end) return false;
+
+        u32 code = *curr++;
+        if (code >= 0x80) {
+            code &= 0x7F;
+            u32 shift = 7;
+            while (true) {
+                if (curr >= end || shift > 28) return false;
+                u32 b = *curr++;
+                code |= (b & 0x7F) << shift;
+                if (b < 0x80) break;
+                shift += 7;
+            }
+        }
+
+        u32 idx;
+        if (code == 0) {
+            idx = next++;
+        }
+        else {
+            idx = last + unzigzag32(code - 1);
+            if (idx >= next) next = idx + 1;
+        }
+
+        dst[i] = idx;
+        last = idx;
+    }
+
+    return true;
+}
+
+bool MeshCodec::readPositionsCount(core::Memory<const u8> encoded, addr_size& outVertexCount) {
+    u32 count = 0;
+    if (!readHeader(encoded, POSITIONS_MAGIC, count)) return false;
+    outVertexCount = addr_size(count);
+    return true;
+}
+
+bool MeshCodec::readIndicesCount(core::Memory<const u8> encoded, addr_size& outIndexCount) {
+    u32 count = 0;
+    if (!readHeader(encoded, INDICES_MAGIC, count)) return false;
+    outIndexCount = addr_size(count);
+    return true;
+}
+
+namespace {
+
+void writeHeader(u8* out, u32 magic, u32 count) {
+    core::memcopy(out, &magic, sizeof(u32));
+    core::memcopy(out + sizeof(u32), &count, sizeof(u32));
+}
+
+bool readHeader(core::Memory<const u8> in, u32 magic, u32& outCount) {
+    if (in.len() < HEADER_SIZE) return false;
+
+    u32 m = 0;
+    core::memcopy(&m, in.data(), sizeof(u32));
+    if (m != magic) return false;
+
+    core::memcopy(&outCount, in.data() + sizeof(u32), sizeof(u32));
+    return true;
+}
+
+addr_size encodeBlock(u8* out, const u8* values, addr_size count) {
+    const addr_size groups = (count + MeshCodec::GROUP_SIZE - 1) / MeshCodec::GROUP_SIZE;
+    const addr_size headerSize = (groups + 3) / 4;
+
+    u8* header = out;
+    u8* curr = out + headerSize;
+    for (addr_size i = 0; i < headerSize; i++) header[i] = 0;
+
+    for (addr_size g = 0; g < groups; g++) {
+        // The last group is padded with zeroes.
+        u8 group[MeshCodec::GROUP_SIZE] = {};
+        addr_size groupCount = minSize(MeshCodec::GROUP_SIZE, count - g * MeshCodec::GROUP_SIZE);
+        core::memcopy(group, values + g * MeshCodec::GROUP_SIZE, groupCount);
+
+        u8 maxValue = 0;
+        for (addr_size i = 0; i < MeshCodec::GROUP_SIZE; i++) {
+            maxValue |= group[i];
+        }
+
+        GroupMode mode;
+        if (maxValue == 0)      mode = GROUP_ZERO;
+        else if (maxValue < 4)  mode = GROUP_2BIT;
+        else if (maxValue < 16) mode = GROUP_4BIT;
+        else                    mode = GROUP_RAW;
+
+        header[g / 4] = u8(header[g / 4] | (mode << ((g % 4) * 2)));
+
+        switch (mode) {
+            case GROUP_ZERO:
+                break;
+            case GROUP_2BIT:
+                for (addr_size j = 0; j < 4; j++) {
+                    curr[j] = u8(group[j*4] | (group[j*4 + 1] << 2) | (group[j*4 + 2] << 4) | (group[j*4 + 3] << 6));
+                }
+                break;
+            case GROUP_4BIT:
+                for (addr_size j = 0; j < 8; j++) {
+                    curr[j] = u8(group[j*2] | (group[j*2 + 1] << 4));
+                }
+                break;
+            case GROUP_RAW:
+                core::memcopy(curr, group, MeshCodec::GROUP_SIZE);
+                break;
+        }
+
+        curr += GROUP_MODE_PAYLOAD_SIZE[mode];
+    }
+
+    return addr_size(curr - out);
+}
+
+const u8* decodeBlock(const u8* in, const u8* end, u8* values, addr_size count) {
+    const addr_size groups = (count + MeshCodec::GROUP_SIZE - 1) / MeshCodec::GROUP_SIZE;
+    const addr_size headerSize = (groups + 3) / 4;
+
+    if (addr_size(end - in) < headerSize) return nullptr;
+
+    const u8* header = in;
+    const u8* curr = in + headerSize;
+
+    for (addr_size g = 0; g < groups; g++) {
+        u8 mode = u8((header[g / 4] >> ((g % 4) * 2)) & 0x3);
+        if (addr_size(end - curr) < GROUP_MODE_PAYLOAD_SIZE[mode]) return nullptr;
+
+        u8* dst = values + g * MeshCodec::GROUP_SIZE;
+        switch (mode) {
+            case GROUP_ZERO:
+                for (addr_size j = 0; j < MeshCodec::GROUP_SIZE; j++) dst[j] = 0;
+                break;
+            case GROUP_2BIT:
+                for (addr_size j = 0; j < 4; j++) {
+                    u8 b = curr[j];
+                    dst[j*4]     = u8(b & 0x3);
+                    dst[j*4 + 1] = u8((b >> 2) & 0x3);
+                    dst[j*4 + 2] = u8((b >> 4) & 0x3);
+                    dst[j*4 + 3] = u8(b >> 6);
+                }
+                break;
+            case GROUP_4BIT:
+                for (addr_size j = 0; j < 8; j++) {
+                    u8 b = curr[j];
+                    dst[j*2]     = u8(b & 0xF);
+                    dst[j*2 + 1] = u8(b >> 4);
+                }
+                break;
+            case GROUP_RAW:
+                core::memcopy(dst, curr, MeshCodec::GROUP_SIZE);
+                break;
+        }
+
+        curr += GROUP_MODE_PAYLOAD_SIZE[mode];
+    }
+
+    return curr;
+}
+
+} // namespace
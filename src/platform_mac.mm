@@ -12,17 +12,13 @@ NSWindow* window = nullptr;
 CAMetalLayer* metalLayer = nullptr;
 bool g_isCocoaAppRunning = false;
 
-// Callbacks
-WindowCloseCallback windowCloseCallbackMacOS = nullptr;
-WindowResizeCallback windowResizeCallbackMacOS = nullptr;
-WindowFocusCallback windowFocusCallbackMacOS = nullptr;
+// The delegates are called from inside sendEvent, so the queue of the current pollEvents call is kept here for the
+// duration of the call.
+InputEventQueue* g_eventQueue = nullptr;
 
-KeyCallback keyCallbackMacOS = nullptr;
-
-MouseClickCallback mouseClickCallbackMacOS = nullptr;
-MouseMoveCallback mouseMoveCallbackMacOS = nullptr;
-MouseScrollCallback mouseScrollCallbackMacOS = nullptr;
-MouseEnterOrLeaveCallback mouseEnterOrLeaveCallbackMacOS = nullptr;
+void pushEvent(const InputEvent& ev) {
+    if (g_eventQueue) g_eventQueue->push(ev);
+}
 
 KeyboardModifiers getModifiersOSX(NSEvent* event) {
     KeyboardModifiers mods = KeyboardModifiers::MODNONE;
@@ -93,28 +89,20 @@ void postEmptyEvent() {
 
 @implementation WindowDelegate
 - (void)windowDidResize:(NSNotification*)notification {
-    if (windowResizeCallbackMacOS) {
-        NSRect frame = [window frame];
-        windowResizeCallbackMacOS((i32)frame.size.width, (i32)frame.size.height);
-    }
+    NSRect frame = [window frame];
+    pushEvent(InputEvent::createWindowResize((i32)frame.size.width, (i32)frame.size.height));
 }
 
 - (void)windowDidResignKey:(NSNotification*)notification {
-    if (windowFocusCallbackMacOS) {
-        windowFocusCallbackMacOS(false); // Window lost focus
-    }
+    pushEvent(InputEvent::createWindowFocus(false)); // Window lost focus
 }
 
 - (void)windowDidBecomeKey:(NSNotification*)notification {
-    if (windowFocusCallbackMacOS) {
-        windowFocusCallbackMacOS(true); // Window gained focus
-    }
+    pushEvent(InputEvent::createWindowFocus(true)); // Window gained focus
 }
 
 - (BOOL)windowShouldClose:(NSWindow*)sender {
-    if (windowCloseCallbackMacOS) {
-        windowCloseCallbackMacOS();
-    }
+    pushEvent(InputEvent::createWindowClose());
 
     // This is necessary when the event polling is in blocking mode. This triggers a dummy event to wakeup the thread.
     g_isCocoaAppRunning = false;
@@ -153,21 +141,17 @@ void postEmptyEvent() {
 }
 
 - (void)keyDown:(NSEvent*)event {
-    if (keyCallbackMacOS) {
-        int vkcode = [event keyCode];
-        int scancode = 0; // TODO: Map to my own scancodes.
-        KeyboardModifiers mods = getModifiersOSX(event);
-        keyCallbackMacOS(true, vkcode, scancode, mods);
-    }
+    int vkcode = [event keyCode];
+    int scancode = 0; // TODO: Map to my own scancodes.
+    KeyboardModifiers mods = getModifiersOSX(event);
+    pushEvent(InputEvent::createKey(true, vkcode, scancode, mods));
 }
 
 - (void)keyUp:(NSEvent*)event {
-    if (keyCallbackMacOS) {
-        int vkcode = [event keyCode];
-        int scancode = 0; // TODO: Map to my own scancodes.
-        KeyboardModifiers mods = getModifiersOSX(event);
-        keyCallbackMacOS(false, vkcode, scancode, mods);
-    }
+    int vkcode = [event keyCode];
+    int scancode = 0; // TODO: Map to my own scancodes.
+    KeyboardModifiers mods = getModifiersOSX(event);
+    pushEvent(InputEvent::createKey(false, vkcode, scancode, mods));
 }
 
 - (void)flagsChanged:(NSEvent*)event {
@@ -201,23 +185,19 @@ void postEmptyEvent() {
 
 // These get called when the mouse enters or leaves the tracking area
 - (void)mouseEntered:(NSEvent*)event {
-    if (mouseEnterOrLeaveCallbackMacOS) {
-        NSPoint location = [event locationInWindow];
-        NSRect frame = [self frame];
-        // i32 x = (i32)location.x;
-        // i32 y = (i32)(frame.size.height - location.y);
-        mouseEnterOrLeaveCallbackMacOS(true);
-    }
+    // NSPoint location = [event locationInWindow];
+    // NSRect frame = [self frame];
+    // i32 x = (i32)location.x;
+    // i32 y = (i32)(frame.size.height - location.y);
+    pushEvent(InputEvent::createMouseEnterOrLeave(true));
 }
 
 - (void)mouseExited:(NSEvent*)event {
-    if (mouseEnterOrLeaveCallbackMacOS) {
-        NSPoint location = [event locationInWindow];
-        NSRect frame = [self frame];
-        // i32 x = (i32)location.x;
-        // i32 y = (i32)(frame.size.height - location.y);
-        mouseEnterOrLeaveCallbackMacOS(false);
-    }
+    // NSPoint location = [event locationInWindow];
+    // NSRect frame = [self frame];
+    // i32 x = (i32)location.x;
+    // i32 y = (i32)(frame.size.height - location.y);
+    pushEvent(InputEvent::createMouseEnterOrLeave(false));
 }
 
 @end // AppView
@@ -288,7 +268,9 @@ AppError Platform::init(const char* windowTitle, i32 windowWidth, i32 windowHeig
     }
 }
 
-AppError Platform::pollEvents(bool block) {
+AppError Platform::pollEvents(InputEventQueue& queue, bool block) {
+    g_eventQueue = &queue;
+
     @autoreleasepool {
         while (g_isCocoaAppRunning) {
             NSEvent* event = [NSApp nextEventMatchingMask:NSEventMaskAny
@@ -301,32 +283,27 @@ AppError Platform::pollEvents(bool block) {
                 case NSEventTypeMouseMoved: [[fallthrough]];
                 case NSEventTypeLeftMouseDragged: [[fallthrough]];
                 case NSEventTypeRightMouseDragged: {
-                    if (mouseMoveCallbackMacOS) {
-                        NSPoint location = [event locationInWindow];
-                        NSRect frame = [window contentView].frame;
-                        // Cocoa's coordinate system is flipped; we adjust Y accordingly.
-                        i32 x = (i32)location.x;
-                        i32 y = (i32)(frame.size.height - location.y);
-                        mouseMoveCallbackMacOS(x, y);
-                    }
+                    NSPoint location = [event locationInWindow];
+                    NSRect frame = [window contentView].frame;
+                    // Cocoa's coordinate system is flipped; we adjust Y accordingly.
+                    i32 x = (i32)location.x;
+                    i32 y = (i32)(frame.size.height - location.y);
+                    queue.push(InputEvent::createMouseMove(x, y));
                     break;
                 }
 
                 case NSEventTypeScrollWheel: {
-                    if (mouseScrollCallbackMacOS) {
-                        CGFloat deltaX = [event scrollingDeltaX];
-                        CGFloat deltaY = [event scrollingDeltaY];
-                        MouseScrollDirection direction = MouseScrollDirection::NONE;
+                    CGFloat deltaY = [event scrollingDeltaY];
+                    MouseScrollDirection direction = MouseScrollDirection::NONE;
 
-                        if (deltaY > 0) direction = MouseScrollDirection::UP;
-                        else if (deltaY < 0) direction = MouseScrollDirection::DOWN;
+                    if (deltaY > 0) direction = MouseScrollDirection::UP;
+                    else if (deltaY < 0) direction = MouseScrollDirection::DOWN;
 
-                        NSPoint location = [event locationInWindow];
-                        i32 x = (i32)location.x;
-                        i32 y = (i32)location.y;
+                    NSPoint location = [event locationInWindow];
+                    i32 x = (i32)location.x;
+                    i32 y = (i32)location.y;
 
-                        mouseScrollCallbackMacOS(direction, x, y);
-                    }
+                    queue.push(InputEvent::createMouseScroll(direction, x, y));
                     break;
                 }
 
@@ -336,26 +313,24 @@ AppError Platform::pollEvents(bool block) {
                 case NSEventTypeRightMouseUp: [[fallthrough]];
                 case NSEventTypeOtherMouseDown: [[fallthrough]];
                 case NSEventTypeOtherMouseUp: {
-                    if (mouseClickCallbackMacOS) {
-                        bool isPress = ([event type] == NSEventTypeLeftMouseDown ||
-                                        [event type] == NSEventTypeRightMouseDown ||
-                                        [event type] == NSEventTypeOtherMouseDown);
-
-                        MouseButton button = MouseButton::NONE;
-                        switch ([event buttonNumber]) {
-                            case 0: button = MouseButton::LEFT; break;
-                            case 1: button = MouseButton::RIGHT; break;
-                            case 2: button = MouseButton::MIDDLE; break;
-                        }
-
-                        NSPoint location = [event locationInWindow];
-                        NSRect frame = [window contentView].frame;
-                        i32 x = (i32)location.x;
-                        i32 y = (i32)(frame.size.height - location.y);
-
-                        KeyboardModifiers mods = getModifiersOSX(event);
-                        mouseClickCallbackMacOS(isPress, button, x, y, mods);
+                    bool isPress = ([event type] == NSEventTypeLeftMouseDown ||
+                                    [event type] == NSEventTypeRightMouseDown ||
+                                    [event type] == NSEventTypeOtherMouseDown);
+
+                    MouseButton button = MouseButton::NONE;
+                    switch ([event buttonNumber]) {
+                        case 0: button = MouseButton::LEFT; break;
+                        case 1: button = MouseButton::RIGHT; break;
+                        case 2: button = MouseButton::MIDDLE; break;
                     }
+
+                    NSPoint location = [event locationInWindow];
+                    NSRect frame = [window contentView].frame;
+                    i32 x = (i32)location.x;
+                    i32 y = (i32)(frame.size.height - location.y);
+
+                    KeyboardModifiers mods = getModifiersOSX(event);
+                    queue.push(InputEvent::createMouseClick(isPress, button, x, y, mods));
                     break;
                 }
 
@@ -382,6 +357,7 @@ void Platform::shutdown() {
         }
 
         g_isCocoaAppRunning = false;
+        g_eventQueue = nullptr;
     }
 }
 
@@ -418,15 +394,3 @@ AppError Platform::createVulkanSurface(VkInstance instance, VkSurfaceKHR& surfac
 
     return APP_OK;
 }
-
-// Callback registration
-void Platform::registerWindowCloseCallback(WindowCloseCallback cb) { windowCloseCallbackMacOS = cb; }
-void Platform::registerWindowResizeCallback(WindowResizeCallback cb) { windowResizeCallbackMacOS = cb; }
-void Platform::registerWindowFocusCallback(WindowFocusCallback cb) { windowFocusCallbackMacOS = cb; }
-
-void Platform::registerKeyCallback(KeyCallback cb) { keyCallbackMacOS = cb; }
-
-void Platform::registerMouseClickCallback(MouseClickCallback cb) { mouseClickCallbackMacOS = cb; }
-void Platform::registerMouseMoveCallback(MouseMoveCallback cb) { mouseMoveCallbackMacOS = cb; }
-void Platform::registerMouseScrollCallback(MouseScrollCallback cb) { mouseScrollCallbackMacOS = cb; }
-void Platform::registerMouseEnterOrLeaveCallback(MouseEnterOrLeaveCallback cb) { mouseEnterOrLeaveCallbackMacOS = cb; }
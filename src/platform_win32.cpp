@@ -3,7 +3,7 @@
 #include <vulkan_include.h>
 
 #include <core_assert.h>
-#include <core_logger.h>
+#include <app_logger.h>
 
 #include <windows.h>
 #include <windowsx.h>
@@ -17,17 +17,9 @@ namespace {
 
 LRESULT CALLBACK processWin32Messages(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
 
-// Initialize all callback variables to nullptr
-WindowCloseCallback windowCloseCallbackWin32 = nullptr;
-WindowResizeCallback windowResizeCallbackWin32 = nullptr;
-WindowFocusCallback windowFocusCallbackWin32 = nullptr;
-
-KeyCallback keyCallbackWin32 = nullptr;
-
-MouseClickCallback mouseClickCallbackWin32 = nullptr;
-MouseMoveCallback mouseMoveCallbackWin32 = nullptr;
-MouseScrollCallback mouseScrollCallbackWin32 = nullptr;
-MouseEnterOrLeaveCallback mouseEnterOrLeaveCallbackWin32 = nullptr;
+// Window procedure messages (resize, focus, close) are delivered from inside DispatchMessage, so the queue of the
+// current pollEvents call is kept here for the duration of the call.
+InputEventQueue* g_eventQueue = nullptr;
 
 HINSTANCE g_hInstance = nullptr;
 HWND g_hwnd = nullptr;
@@ -72,9 +64,11 @@ AppError Platform::init(const char* windowTitle, i32 windowWidth, i32 windowHeig
     return APP_OK;
 }
 
-AppError Platform::pollEvents(bool block) {
+AppError Platform::pollEvents(InputEventQueue& queue, bool block) {
     Assert(g_initialized, "Platform Layer needs to be initialized");
 
+    g_eventQueue = &queue;
+
     MSG msg = {};
     BOOL res;
     if (block) {
@@ -117,9 +111,7 @@ AppError Platform::pollEvents(bool block) {
         return mods;
     };
 
-    auto handleMouseMessage  = [&getModifiers](const MSG& win32Msg, bool isPress) -> void {
-        if (!mouseClickCallbackWin32) return;
-
+    auto handleMouseMessage  = [&getModifiers, &queue](const MSG& win32Msg, bool isPress) -> void {
         POINT pt = { GET_X_LPARAM(win32Msg.lParam), GET_Y_LPARAM(win32Msg.lParam) };
         auto x = pt.x;
         auto y = pt.y;
@@ -135,12 +127,10 @@ AppError Platform::pollEvents(bool block) {
             case WM_MBUTTONUP:   button = MouseButton::MIDDLE; break;
         }
 
-        mouseClickCallbackWin32(isPress, button, x, y, mods);
+        queue.push(InputEvent::createMouseClick(isPress, button, x, y, mods));
     };
 
-    auto handleScrollMessage = [](const MSG& win32Msg) -> void {
-        if (!mouseScrollCallbackWin32) return;
-
+    auto handleScrollMessage = [&queue](const MSG& win32Msg) -> void {
         POINT pt = { GET_X_LPARAM(win32Msg.lParam), GET_Y_LPARAM(win32Msg.lParam) };
         auto x = pt.x;
         auto y = pt.y;
@@ -150,17 +140,15 @@ AppError Platform::pollEvents(bool block) {
         if (delta > 0)      direction = MouseScrollDirection::UP;
         else if (delta < 0) direction = MouseScrollDirection::DOWN;
 
-        mouseScrollCallbackWin32(direction, x, y);
+        queue.push(InputEvent::createMouseScroll(direction, x, y));
     };
 
-    auto handleKeyMessage = [&getModifiers](const MSG& win32Msg, bool isPress) -> void {
-        if (!keyCallbackWin32) return;
-
+    auto handleKeyMessage = [&getModifiers, &queue](const MSG& win32Msg, bool isPress) -> void {
         u32 vkcode = u32(win32Msg.wParam); // Virtual-key code
         u32 scancode = u32((win32Msg.lParam >> 16) & 0xFF); // Extract scancode from lParam
         KeyboardModifiers mods = getModifiers();
 
-        keyCallbackWin32(isPress, vkcode, scancode, mods);
+        queue.push(InputEvent::createKey(isPress, vkcode, scancode, mods));
     };
 
     switch (msg.message) {
@@ -171,7 +159,7 @@ AppError Platform::pollEvents(bool block) {
         case WM_MOUSEMOVE: {
             POINT pt = { GET_X_LPARAM(msg.lParam), GET_Y_LPARAM(msg.lParam) };
             if (g_isTrackingMouse) {
-                if (mouseMoveCallbackWin32) mouseMoveCallbackWin32(pt.x, pt.y);
+                queue.push(InputEvent::createMouseMove(pt.x, pt.y));
             }
             else {
                 // Mouse tracking needs to be enabled again.
@@ -187,7 +175,7 @@ AppError Platform::pollEvents(bool block) {
                     logWarn("Failed to enable mouse tracking. This might have been caused by missed a leave event");
                 }
 
-                if (mouseEnterOrLeaveCallbackWin32) mouseEnterOrLeaveCallbackWin32(true);
+                queue.push(InputEvent::createMouseEnterOrLeave(true));
             }
 
             return APP_OK;
@@ -196,7 +184,7 @@ AppError Platform::pollEvents(bool block) {
         case WM_MOUSELEAVE:
             // TODO: What happens if mouse leave is missed?
             g_isTrackingMouse = false;
-            if (mouseEnterOrLeaveCallbackWin32) mouseEnterOrLeaveCallbackWin32(false);
+            queue.push(InputEvent::createMouseEnterOrLeave(false));
             return APP_OK;
 
         case WM_LBUTTONDOWN: [[fallthrough]];
@@ -233,6 +221,7 @@ AppError Platform::pollEvents(bool block) {
 
 void Platform::shutdown() {
     g_initialized = false;
+    g_eventQueue = nullptr;
 
     if (g_hwnd) {
         DestroyWindow(g_hwnd);
@@ -285,40 +274,29 @@ bool Platform::getFrameBufferSize(u32& width, u32& height) {
     return true;
 }
 
-void Platform::registerWindowCloseCallback(WindowCloseCallback cb) { windowCloseCallbackWin32 = cb; }
-void Platform::registerWindowResizeCallback(WindowResizeCallback cb) { windowResizeCallbackWin32 = cb; }
-void Platform::registerWindowFocusCallback(WindowFocusCallback cb) { windowFocusCallbackWin32 = cb; }
-
-void Platform::registerKeyCallback(KeyCallback cb) { keyCallbackWin32 = cb; }
-
-void Platform::registerMouseClickCallback(MouseClickCallback cb) { mouseClickCallbackWin32 = cb; }
-void Platform::registerMouseMoveCallback(MouseMoveCallback cb) { mouseMoveCallbackWin32 = cb; }
-void Platform::registerMouseScrollCallback(MouseScrollCallback cb) { mouseScrollCallbackWin32 = cb; }
-void Platform::registerMouseEnterOrLeaveCallback(MouseEnterOrLeaveCallback cb) { mouseEnterOrLeaveCallbackWin32 = cb; }
-
 namespace {
 
 LRESULT CALLBACK processWin32Messages(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam) {
     switch (message) {
         // case WM_NCACTIVATE: [[fallthrough]];
         case WM_ACTIVATE: {
-            if (windowFocusCallbackWin32) {
+            if (g_eventQueue) {
                 bool focused = (LOWORD(wParam) != WA_INACTIVE);
-                windowFocusCallbackWin32(focused);
+                g_eventQueue->push(InputEvent::createWindowFocus(focused));
             }
             return 0;
         }
 
         case WM_SIZE:
-            if (windowResizeCallbackWin32) {
+            if (g_eventQueue) {
                 auto w = LOWORD(lParam);
                 auto h = HIWORD(lParam);
-                windowResizeCallbackWin32(i32(w), i32(h));
+                g_eventQueue->push(InputEvent::createWindowResize(i32(w), i32(h)));
             }
             return 0;
 
         case WM_CLOSE:
-            if (windowCloseCallbackWin32) windowCloseCallbackWin32();
+            if (g_eventQueue) g_eventQueue->push(InputEvent::createWindowClose());
             DestroyWindow(hWnd);
             return 0;
         case WM_DESTROY:
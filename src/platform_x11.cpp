@@ -8,6 +8,10 @@
 #include <X11/Xlib.h>
 #include <X11/Xutil.h>
 
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
 using PlatformError::Type::FAILED_TO_CREATE_X11_DISPLAY;
 using PlatformError::Type::FAILED_TO_CREATE_X11_WINDOW;
 using PlatformError::Type::FAILED_TO_CREATE_X11_KHR_XLIB_SURFACE;
@@ -17,19 +21,28 @@ namespace {
 Display* g_display = nullptr;
 Window g_window = 0;
 Atom g_wmDeleteWindow;
+i32 g_wakeFd = -1; // Interrupts waitForEvents.
 [[maybe_unused]] bool g_initialized = false; // Probably won't use this in release builds.
 
-// Initialize all callback variables to nullptr
-WindowCloseCallback windowCloseCallbackX11 = nullptr;
-WindowResizeCallback windowResizeCallbackX11 = nullptr;
-WindowFocusCallback windowFocusCallbackX11 = nullptr;
+struct EventCoalescer {
+    bool hasMotion = false;
+    InputEvent motion;
+
+    bool hasResize = false;
+    InputEvent resize;
+
+    void flushMotion(InputEventQueue& queue);
+    void flushResize(InputEventQueue& queue);
+};
 
-KeyCallback keyCallbackX11 = nullptr;
+// Last reported window size. ConfigureNotify is sent for moves and restacking too, those should not trigger a resize.
+i32 g_lastWidth = -1;
+i32 g_lastHeight = -1;
 
-MouseClickCallback mouseClickCallbackX11 = nullptr;
-MouseMoveCallback mouseMoveCallbackX11 = nullptr;
-MouseScrollCallback mouseScrollCallbackX11 = nullptr;
-MouseEnterOrLeaveCallback mouseEnterOrLeaveCallbackX11 = nullptr;
+bool handleXEvent(XEvent& xevent, InputEventQueue& queue);
+KeyboardModifiers getModifiers(u32 state);
+void handleMouseClickEvent(XEvent& ev, bool isPress, InputEventQueue& queue);
+void handleKeyEvent(XEvent& ev, bool isPress, InputEventQueue& queue);
 
 i32 handleXError(Display* display, XErrorEvent* errorEvent);
 
@@ -99,160 +112,62 @@ AppError Platform::init(const char* windowTitle, i32 windowWidth, i32 windowHeig
     // Flushes all pending requests to the X server.
     XFlush(g_display);
 
+    g_lastWidth = windowWidth;
+    g_lastHeight = windowHeight;
+
+    g_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (g_wakeFd < 0) {
+        logWarnTagged(X11_PLATFORM_TAG, "eventfd failed, waitForEvents can only be interrupted by its timeout");
+    }
+
     g_initialized = true;
     logInfoTagged(X11_PLATFORM_TAG, "Platform X11 initialized");
     return APP_OK;
 }
 
-AppError Platform::pollEvents(bool block) {
+AppError Platform::pollEvents(InputEventQueue& queue, bool block) {
     Assert(g_initialized, "Platform Layer needs to be initialized");
 
     if (!block && !XPending(g_display)) {
         return APP_OK;
     }
 
-    auto getModifiers = [](u32 m) -> KeyboardModifiers {
-        KeyboardModifiers ret = KeyboardModifiers::MODNONE;
-
-        if (m & ShiftMask)   ret |= KeyboardModifiers::MODSHIFT;
-        if (m & ControlMask) ret |= KeyboardModifiers::MODCONTROL;
-        if (m & Mod1Mask)    ret |= KeyboardModifiers::MODALT;
-        if (m & Mod4Mask)    ret |= KeyboardModifiers::MODSUPER;
-
-        return ret;
-    };
-
-    XEvent xevent;
-    XNextEvent(g_display, &xevent);
+    // Drain the whole queue. Motion and resize events come in bursts and only the latest one matters, so they are held
+    // back and reported once. A pending motion is reported before any other input event to keep the ordering intact.
+    EventCoalescer coalescer;
 
-    auto handleMouseClickEvent = [&getModifiers](XEvent& ev, bool isPress) -> void {
-        KeyboardModifiers mods = getModifiers(ev.xbutton.state);
-        i32 x = i32(ev.xbutton.x);
-        i32 y = i32(ev.xbutton.y);
+    do {
+        XEvent xevent;
+        XNextEvent(g_display, &xevent);
 
-        if (mouseScrollCallbackX11) {
-            if (ev.xbutton.button == Button4) {
-                mouseScrollCallbackX11(MouseScrollDirection::UP, x, y);
-                return;
-            }
-            else if (ev.xbutton.button == Button5) {
-                mouseScrollCallbackX11(MouseScrollDirection::DOWN, x, y);
-                return;
-            }
-        }
-
-        if (mouseClickCallbackX11) {
-            if (ev.xbutton.button == Button1) {
-                mouseClickCallbackX11(isPress, MouseButton::LEFT, x, y, mods);
-                return;
-            }
-            else if (ev.xbutton.button == Button2) {
-                mouseClickCallbackX11(isPress, MouseButton::MIDDLE, x, y, mods);
-                return;
-            }
-            else if (ev.xbutton.button == Button3) {
-                mouseClickCallbackX11(isPress, MouseButton::RIGHT, x, y, mods);
-                return;
+        if (xevent.type == MotionNotify) {
+            InputEvent motion = InputEvent::createMouseMove(i32(xevent.xmotion.x), i32(xevent.xmotion.y));
+            if (coalescer.hasMotion) {
+                // Keep the receipt time of the first motion in the burst, the latency is measured from it.
+                coalescer.motion.move = motion.move;
             }
             else {
-                mouseClickCallbackX11(isPress, MouseButton::NONE, x, y, mods);
-                logDebugTagged(X11_PLATFORM_TAG, "Unknown Mouse Button");
-                return;
+                coalescer.motion = motion;
+                coalescer.hasMotion = true;
             }
+            continue;
         }
-    };
-
-    auto handleKeyEvent = [&getModifiers](XEvent& ev, bool isPress) -> void {
-        if (keyCallbackX11) {
-            u32 vkcode = u32(XLookupKeysym(&ev.xkey, 0));
-            u32 scancode = ev.xkey.keycode;
-            KeyboardModifiers mods = getModifiers(ev.xkey.state);
-            keyCallbackX11(isPress, vkcode, scancode, mods);
+        if (xevent.type == ConfigureNotify) {
+            coalescer.hasResize = true;
+            coalescer.resize = InputEvent::createWindowResize(i32(xevent.xconfigure.width),
+                                                              i32(xevent.xconfigure.height));
+            continue;
         }
-    };
 
-    switch (xevent.type) {
-        case DestroyNotify: {
-            XDestroyWindowEvent* e = reinterpret_cast<XDestroyWindowEvent*>(&xevent);
-            if(e->window == g_window) {
-                XSync(g_display, true);
-                if (windowCloseCallbackX11) windowCloseCallbackX11();
-                return APP_OK;
-            }
-
-            break;
-        }
-        case ClientMessage: {
-            if (Atom(xevent.xclient.data.l[0]) == g_wmDeleteWindow) {
-                XSync(g_display, true);
-                if (windowCloseCallbackX11) windowCloseCallbackX11();
-                return APP_OK;
-            }
-            break;
-        }
-
-        case ConfigureNotify:
-            if (windowResizeCallbackX11) {
-                i32 w = i32(xevent.xconfigure.width);
-                i32 h = i32(xevent.xconfigure.height);
-                windowResizeCallbackX11(w, h);
-            }
-            return APP_OK;
-
-        case ButtonPress:
-            handleMouseClickEvent(xevent, true);
-            return APP_OK;
-
-        case ButtonRelease:
-            handleMouseClickEvent(xevent, false);
-            return APP_OK;
-
-        case KeyPress:
-            handleKeyEvent(xevent, true);
-            return APP_OK;
-
-        case KeyRelease:
-            handleKeyEvent(xevent, false);
-            return APP_OK;
-
-        case MotionNotify: {
-            if (mouseMoveCallbackX11) {
-                i32 x = i32(xevent.xmotion.x);
-                i32 y = i32(xevent.xmotion.y);
-                mouseMoveCallbackX11(x, y);
-            }
-            return APP_OK;
-        }
-
-        case EnterNotify: {
-            if (mouseEnterOrLeaveCallbackX11) {
-                // i32 x = xevent.xcrossing.x;
-                // i32 y = xevent.xcrossing.y;
-                mouseEnterOrLeaveCallbackX11(true);
-            }
+        coalescer.flushMotion(queue);
+        if (handleXEvent(xevent, queue)) {
+            // The window is closing, discard the rest.
             return APP_OK;
         }
+    } while (XPending(g_display));
 
-        case LeaveNotify: {
-            if (mouseEnterOrLeaveCallbackX11) {
-                // i32 x = xevent.xcrossing.x;
-                // i32 y = xevent.xcrossing.y;
-                mouseEnterOrLeaveCallbackX11(false);
-            }
-            return APP_OK;
-        }
-
-        case FocusIn:
-            if (windowFocusCallbackX11) windowFocusCallbackX11(true);
-            return APP_OK;
-
-        case FocusOut:
-            if (windowFocusCallbackX11) windowFocusCallbackX11(false);
-            return APP_OK;
-
-        default:
-            break;
-    }
+    coalescer.flushMotion(queue);
+    coalescer.flushResize(queue);
 
     return APP_OK;
 }
@@ -268,6 +183,11 @@ void Platform::shutdown() {
     // Flush all X events and discard them.
     XSync(g_display, True);
 
+    if (g_wakeFd >= 0) {
+        close(g_wakeFd);
+        g_wakeFd = -1;
+    }
+
     if (g_display) {
         // TODO2: Figure out why XCloseDisplay triggers a segmentation fault?
         //        Even Crazier is that this happens only for GCC!
@@ -276,17 +196,6 @@ void Platform::shutdown() {
     }
 }
 
-void Platform::registerWindowCloseCallback(WindowCloseCallback cb) { windowCloseCallbackX11 = cb; }
-void Platform::registerWindowResizeCallback(WindowResizeCallback cb) { windowResizeCallbackX11 = cb; }
-void Platform::registerWindowFocusCallback(WindowFocusCallback cb) { windowFocusCallbackX11 = cb; }
-
-void Platform::registerKeyCallback(KeyCallback cb) { keyCallbackX11 = cb; }
-
-void Platform::registerMouseClickCallback(MouseClickCallback cb) { mouseClickCallbackX11 = cb; }
-void Platform::registerMouseMoveCallback(MouseMoveCallback cb) { mouseMoveCallbackX11 = cb; }
-void Platform::registerMouseScrollCallback(MouseScrollCallback cb) { mouseScrollCallbackX11 = cb; }
-void Platform::registerMouseEnterOrLeaveCallback(MouseEnterOrLeaveCallback cb) { mouseEnterOrLeaveCallbackX11 = cb; }
-
 void Platform::requiredVulkanExtsCount(i32& count) {
     count = 1;
 }
@@ -331,8 +240,159 @@ bool Platform::getFrameBufferSize(u32& width, u32& height) {
     return true;
 }
 
+void Platform::getX11Handles(void*& display, unsigned long& window) {
+    display = g_display;
+    window = g_window;
+}
+
+void Platform::waitForEvents(i32 timeoutMs) {
+    Assert(g_initialized, "Platform Layer needs to be initialized");
+
+    // Events might already be read into Xlib's queue, in which case the socket has nothing left to poll for.
+    if (XPending(g_display)) return;
+
+    pollfd fds[2] = {
+        { ConnectionNumber(g_display), POLLIN, 0 },
+        { g_wakeFd, POLLIN, 0 },
+    };
+    nfds_t count = g_wakeFd >= 0 ? 2 : 1;
+    if (poll(fds, count, timeoutMs) > 0 && count == 2 && (fds[1].revents & POLLIN)) {
+        u64 value;
+        [[maybe_unused]] ssize_t n = read(g_wakeFd, &value, sizeof(value));
+    }
+}
+
+void Platform::wakeEventWait() {
+    if (g_wakeFd < 0) return;
+    u64 one = 1;
+    [[maybe_unused]] ssize_t n = write(g_wakeFd, &one, sizeof(one));
+}
+
 namespace {
 
+void EventCoalescer::flushMotion(InputEventQueue& queue) {
+    if (!hasMotion) return;
+    hasMotion = false;
+    queue.push(motion);
+}
+
+void EventCoalescer::flushResize(InputEventQueue& queue) {
+    if (!hasResize) return;
+    hasResize = false;
+    if (resize.resize.w == g_lastWidth && resize.resize.h == g_lastHeight) return;
+
+    g_lastWidth = resize.resize.w;
+    g_lastHeight = resize.resize.h;
+    queue.push(resize);
+}
+
+// Returns true when the window is closing.
+bool handleXEvent(XEvent& xevent, InputEventQueue& queue) {
+    switch (xevent.type) {
+        case DestroyNotify: {
+            XDestroyWindowEvent* e = reinterpret_cast<XDestroyWindowEvent*>(&xevent);
+            if(e->window == g_window) {
+                XSync(g_display, true);
+                queue.push(InputEvent::createWindowClose());
+                return true;
+            }
+
+            break;
+        }
+        case ClientMessage: {
+            if (Atom(xevent.xclient.data.l[0]) == g_wmDeleteWindow) {
+                XSync(g_display, true);
+                queue.push(InputEvent::createWindowClose());
+                return true;
+            }
+            break;
+        }
+
+        case ButtonPress:
+            handleMouseClickEvent(xevent, true, queue);
+            break;
+
+        case ButtonRelease:
+            handleMouseClickEvent(xevent, false, queue);
+            break;
+
+        case KeyPress:
+            handleKeyEvent(xevent, true, queue);
+            break;
+
+        case KeyRelease:
+            handleKeyEvent(xevent, false, queue);
+            break;
+
+        case EnterNotify:
+            // i32 x = xevent.xcrossing.x;
+            // i32 y = xevent.xcrossing.y;
+            queue.push(InputEvent::createMouseEnterOrLeave(true));
+            break;
+
+        case LeaveNotify:
+            // i32 x = xevent.xcrossing.x;
+            // i32 y = xevent.xcrossing.y;
+            queue.push(InputEvent::createMouseEnterOrLeave(false));
+            break;
+
+        case FocusIn:
+            queue.push(InputEvent::createWindowFocus(true));
+            break;
+
+        case FocusOut:
+            queue.push(InputEvent::createWindowFocus(false));
+            break;
+
+        default:
+            break;
+    }
+
+    return false;
+}
+
+KeyboardModifiers getModifiers(u32 m) {
+    KeyboardModifiers ret = KeyboardModifiers::MODNONE;
+
+    if (m & ShiftMask)   ret |= KeyboardModifiers::MODSHIFT;
+    if (m & ControlMask) ret |= KeyboardModifiers::MODCONTROL;
+    if (m & Mod1Mask)    ret |= KeyboardModifiers::MODALT;
+    if (m & Mod4Mask)    ret |= KeyboardModifiers::MODSUPER;
+
+    return ret;
+}
+
+void handleMouseClickEvent(XEvent& ev, bool isPress, InputEventQueue& queue) {
+    KeyboardModifiers mods = getModifiers(ev.xbutton.state);
+    i32 x = i32(ev.xbutton.x);
+    i32 y = i32(ev.xbutton.y);
+
+    if (ev.xbutton.button == Button4) {
+        // Every wheel step comes as a press and release pair, report it once.
+        if (isPress) queue.push(InputEvent::createMouseScroll(MouseScrollDirection::UP, x, y));
+        return;
+    }
+    else if (ev.xbutton.button == Button5) {
+        if (isPress) queue.push(InputEvent::createMouseScroll(MouseScrollDirection::DOWN, x, y));
+        return;
+    }
+
+    MouseButton button = MouseButton::NONE;
+    if (ev.xbutton.button == Button1)      button = MouseButton::LEFT;
+    else if (ev.xbutton.button == Button2) button = MouseButton::MIDDLE;
+    else if (ev.xbutton.button == Button3) button = MouseButton::RIGHT;
+    else logDebugTagged(X11_PLATFORM_TAG, "Unknown Mouse Button");
+
+    queue.push(InputEvent::createMouseClick(isPress, button, x, y, mods));
+}
+
+void handleKeyEvent(XEvent& ev, bool isPress, InputEventQueue& queue) {
+    u32 vkcode = u32(XLookupKeysym(&ev.xkey, 0));
+    u32 scancode = ev.xkey.keycode;
+    KeyboardModifiers mods = getModifiers(ev.xkey.state);
+    queue.push(InputEvent::createKey(isPress, vkcode, scancode, mods));
+}
+
 i32 handleXError(Display* display, XErrorEvent* errorEvent) {
     constexpr i32 ERROR_TEXT_MAX_SIZE = 512;
     char errorText[ERROR_TEXT_MAX_SIZE] = {};
@@ -0,0 +1,203 @@
+#include <app_logger.h>
+#include <file_watcher.h>
+#include <memory_tracker.h>
+#include <renderer.h>
+#include <scene_loader.h>
+#include <startup_timeline.h>
+#include <stl_loader.h>
+#include <worker_pool.h>
+
+#include <atomic>
+
+using PlatformError::Type::FAILED_TO_LOAD_STL_FILE;
+
+namespace {
+
+const char* g_path = nullptr;
+WorkerPool g_reloadPool; // A single thread, so reloads never race each other.
+std::atomic<bool> g_reloadQueued = false;
+u64 g_loadedHash = 0; // Only touched by init and the reload thread.
+bool g_initialized = false;
+bool g_poolStarted = false;
+
+struct LoadedMesh {
+    StlMesh mesh;
+    u64 hash = 0;
+    bool unchanged = false; // Same contents as g_loadedHash, the mesh is empty.
+};
+
+// Written by the prefetch job, read by init after waiting for the pool.
+bool g_prefetchStarted = false;
+LoadedMesh g_prefetched;
+AppError g_prefetchErr;
+
+core::expected<AppError> loadMesh(const char* path, LoadedMesh& out);
+void submitLoaded(const char* path, const LoadedMesh& loaded);
+core::expected<AppError> loadAndSubmit(const char* path);
+void onFileChanged(const char* path, void* userData);
+void reloadJob(void* userData);
+void prefetchJob(void* userData);
+u64 hashBytes(core::Memory<const u8> bytes);
+
+} // namespace
+
+void SceneLoader::prefetch(const char* stlPath) {
+    g_path = stlPath;
+    g_reloadPool.init(1);
+    g_poolStarted = true;
+    g_prefetchStarted = true;
+    g_reloadPool.submit(prefetchJob, nullptr);
+}
+
+core::expected<AppError> SceneLoader::init(const char* stlPath) {
+    if (g_prefetchStarted) {
+        Assert(g_path == stlPath, "Prefetched a different file");
+        g_reloadPool.waitIdle();
+        g_prefetchStarted = false;
+
+        if (!g_prefetchErr.isOk()) {
+            SceneLoader::shutdown(); // Nothing else stops the loader thread on this path.
+            return core::unexpected(g_prefetchErr);
+        }
+        submitLoaded(g_path, g_prefetched);
+        g_prefetched = {};
+    }
+    else {
+        g_path = stlPath;
+        if (auto res = loadAndSubmit(g_path); res.hasErr()) {
+            return res;
+        }
+    }
+
+    if (auto res = FileWatcher::init(); res.hasErr()) {
+        return res;
+    }
+
+    if (!g_poolStarted) {
+        g_reloadPool.init(1);
+        g_poolStarted = true;
+    }
+    g_initialized = true;
+
+    FileWatcher::watch(g_path, onFileChanged, nullptr);
+
+    return {};
+}
+
+void SceneLoader::shutdown() {
+    // Stop the notifications first, then let a reload that is already running finish before the renderer goes away.
+    if (g_initialized) {
+        // The watcher thread outlives this when another user still holds it.
+        FileWatcher::unwatch(g_path, onFileChanged);
+        FileWatcher::shutdown();
+        g_initialized = false;
+    }
+    if (g_poolStarted) {
+        g_reloadPool.shutdown();
+        g_poolStarted = false;
+    }
+    g_prefetchStarted = false;
+    g_prefetched = {};
+}
+
+namespace {
+
+core::expected<AppError> loadMesh(const char* path, LoadedMesh& out) {
+    core::ArrList<u8> bytes;
+    if (auto res = core::fileReadEntire(path, bytes); res.hasErr()) {
+        char errBuf[core::MAX_SYSTEM_ERR_MSG_SIZE];
+        Assert(core::pltErrorDescribe(res.err(), errBuf), "Failed to describe platform error");
+        logErrTagged(LOADER_TAG, "Failed to read STL file, path: {}, reason: {}", path, errBuf);
+        return core::unexpected(createPltErr(FAILED_TO_LOAD_STL_FILE, "Failed to load STL file"));
+    }
+
+    // Exporters often touch the file without changing it, skip the parse and the upload in that case.
+    out.hash = hashBytes(bytes.memView());
+    out.unchanged = out.hash == g_loadedHash;
+    if (out.unchanged) {
+        return {};
+    }
+
+    auto res = [&] {
+        MemoryScope memScope (MemSubsystem::MESH_PROCESSING);
+        return StlMesh::parse(bytes.memView());
+    }();
+    if (res.hasErr()) {
+        logErrTagged(LOADER_TAG, "Failed to parse STL file, path: {}", path);
+        return core::unexpected(res.err());
+    }
+
+    out.mesh = std::move(res.value());
+    return {};
+}
+
+void submitLoaded(const char* path, const LoadedMesh& loaded) {
+    if (loaded.unchanged) {
+        logInfoTagged(LOADER_TAG, "STL file is unchanged, skipping reload: {}", path);
+        return;
+    }
+
+    Renderer::submitMesh(loaded.mesh);
+    g_loadedHash = loaded.hash;
+
+    logInfoTagged(LOADER_TAG, "Loaded STL file: {} (triangles={})", path, loaded.mesh.triangleCount());
+}
+
+core::expected<AppError> loadAndSubmit(const char* path) {
+    LoadedMesh loaded;
+    if (auto res = loadMesh(path, loaded); res.hasErr()) {
+        return res;
+    }
+    submitLoaded(path, loaded);
+    return {};
+}
+
+void onFileChanged(const char*, void*) {
+    // A reload that has not started yet will read the latest contents anyway.
+    if (!g_reloadQueued.exchange(true)) {
+        g_reloadPool.submit(reloadJob, nullptr);
+    }
+}
+
+void reloadJob(void*) {
+    MemoryScope memScope (MemSubsystem::LOADER);
+    g_reloadQueued = false;
+
+    // On failure the current mesh stays on screen. The exporter might still be writing, the next change retries.
+    [[maybe_unused]] auto res = loadAndSubmit(g_path);
+}
+
+void prefetchJob(void*) {
+    MemoryScope memScope (MemSubsystem::LOADER);
+    StartupTimeline::Scope phase ("Read and parse STL file");
+
+    // The renderer is not up yet, the mesh is handed over in init.
+    if (auto res = loadMesh(g_path, g_prefetched); res.hasErr()) {
+        g_prefetchErr = res.err();
+    }
+}
+
+u64 hashBytes(core::Memory<const u8> bytes) {
+    // FNV-1a over 8 byte words. Not a great general purpose hash, but plenty to tell two versions of a file apart and
+    // fast enough to not matter next to the parse.
+    constexpr u64 FNV_OFFSET = 0xcbf29ce484222325ull;
+    constexpr u64 FNV_PRIME = 0x100000001b3ull;
+
+    const u8* data = bytes.data();
+    addr_size len = bytes.len();
+    u64 hash = FNV_OFFSET;
+
+    addr_size i = 0;
+    for (; i + sizeof(u64) <= len; i += sizeof(u64)) {
+        u64 word;
+        core::memcopy(&word, data + i, sizeof(u64));
+        hash = (hash ^ word) * FNV_PRIME;
+    }
+    for (; i < len; i++) {
+        hash = (hash ^ u64(data[i])) * FNV_PRIME;
+    }
+
+    return hash ^ u64(len);
+}
+
+} // namespace
@@ -0,0 +1,123 @@
+#include <app_logger.h>
+#include <file_watcher.h>
+#include <memory_tracker.h>
+#include <renderer.h>
+#include <shader_hot_reload.h>
+#include <worker_pool.h>
+
+#include <atomic>
+#include <cstdlib>
+
+using PlatformError::Type::FAILED_TO_WATCH_FILE;
+
+namespace {
+
+constexpr const char* SOURCE_DIR = STLV_SHADER_SOURCES;
+constexpr const char* OUTPUT_DIR = STLV_ASSETS "/shaders";
+constexpr const char* GLSLC = STLV_GLSLC;
+constexpr const char* VERTEX_SHADER = "mesh_shader.vert";
+constexpr const char* FRAGMENT_SHADER = "mesh_shader.frag";
+
+WorkerPool g_compilePool; // A single thread, so compiles never race each other.
+std::atomic<bool> g_reloadQueued = false;
+bool g_initialized = false;
+
+core::StrBuilder g_vertexSourcePath;
+core::StrBuilder g_fragmentSourcePath;
+core::StrBuilder g_vertexOutputPath;
+core::StrBuilder g_fragmentOutputPath;
+
+void buildPath(core::StrBuilder& out, const char* dir, const char* name, const char* ext);
+bool compileShader(const core::StrBuilder& sourcePath, const core::StrBuilder& outputPath);
+void onShaderChanged(const char* path, void* userData);
+void reloadJob(void* userData);
+
+} // namespace
+
+core::expected<AppError> ShaderHotReload::init() {
+    buildPath(g_vertexSourcePath, SOURCE_DIR, VERTEX_SHADER, "");
+    buildPath(g_fragmentSourcePath, SOURCE_DIR, FRAGMENT_SHADER, "");
+    buildPath(g_vertexOutputPath, OUTPUT_DIR, VERTEX_SHADER, ".spirv");
+    buildPath(g_fragmentOutputPath, OUTPUT_DIR, FRAGMENT_SHADER, ".spirv");
+
+    if (auto res = FileWatcher::init(); res.hasErr()) {
+        return res;
+    }
+    g_compilePool.init(1);
+    g_initialized = true;
+
+    // Watching only one of the stages would reload some edits and silently miss others, so it is both or an error.
+    bool watching = FileWatcher::watch(g_vertexSourcePath.view().data(), onShaderChanged, nullptr) &&
+                    FileWatcher::watch(g_fragmentSourcePath.view().data(), onShaderChanged, nullptr);
+    if (!watching) {
+        ShaderHotReload::shutdown();
+        return core::unexpected(createPltErr(FAILED_TO_WATCH_FILE, "Failed to watch the shader sources"));
+    }
+
+    logInfoTagged(RENDERER_TAG, "Shader hot reload enabled, watching: {}", SOURCE_DIR);
+    return {};
+}
+
+void ShaderHotReload::shutdown() {
+    // Stop the notifications first, then let a compile that is already running finish before the renderer goes away.
+    if (!g_initialized) return;
+    FileWatcher::unwatch(g_vertexSourcePath.view().data(), onShaderChanged);
+    FileWatcher::unwatch(g_fragmentSourcePath.view().data(), onShaderChanged);
+    FileWatcher::shutdown();
+    g_compilePool.shutdown();
+    g_initialized = false;
+}
+
+namespace {
+
+void buildPath(core::StrBuilder& out, const char* dir, const char* name, const char* ext) {
+    out.clear();
+    out.append(core::sv(dir));
+    out.append('/');
+    out.append(core::sv(name));
+    out.append(core::sv(ext));
+}
+
+bool compileShader(const core::StrBuilder& sourcePath, const core::StrBuilder& outputPath) {
+    core::StrBuilder cmd;
+    cmd.append('"');
+    cmd.append(core::sv(GLSLC));
+    cmd.append("\" \""_sv);
+    cmd.append(sourcePath.view());
+    cmd.append("\" -o \""_sv);
+    cmd.append(outputPath.view());
+    cmd.append('"');
+
+    // glslc only writes the output when the compile succeeds, so a failed compile keeps the previous file.
+    i32 status = std::system(cmd.view().data());
+    if (status != 0) {
+        logErrTagged(RENDERER_TAG, "Failed to compile shader: {} (exit status {})", sourcePath.view().data(), status);
+        return false;
+    }
+    return true;
+}
+
+void onShaderChanged(const char*, void*) {
+    // A reload that has not started yet will compile the latest contents anyway.
+    if (!g_reloadQueued.exchange(true)) {
+        g_compilePool.submit(reloadJob, nullptr);
+    }
+}
+
+void reloadJob(void*) {
+    MemoryScope memScope (MemSubsystem::RENDERER);
+    g_reloadQueued = false;
+
+    // The pipeline needs both stages, and recompiling the one that did not change is cheap.
+    if (!compileShader(g_vertexSourcePath, g_vertexOutputPath)) return;
+    if (!compileShader(g_fragmentSourcePath, g_fragmentOutputPath)) return;
+
+    if (auto res = Renderer::submitShaders(g_vertexOutputPath.view(), g_fragmentOutputPath.view()); res.hasErr()) {
+        AppError err = res.err();
+        logErrTagged(RENDERER_TAG, "Failed to rebuild the pipeline, keeping the current one: {}", err.toCStr());
+        return;
+    }
+    logInfoTagged(RENDERER_TAG, "Shaders recompiled, the new pipeline is used from the next frame");
+}
+
+} // namespace
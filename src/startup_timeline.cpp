@@ -0,0 +1,111 @@
+#include <app_logger.h>
+#include <startup_timeline.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Phase {
+    const char* name;
+    u64 beginNs;
+    std::atomic<u64> endNs; // 0 while the phase is running.
+    u32 threadIdx;
+};
+
+Clock::time_point g_origin = Clock::now();
+std::thread::id g_mainThread;
+Phase g_phases[StartupTimeline::MAX_PHASES];
+std::atomic<u32> g_phasesCount = 0;
+std::atomic<bool> g_reported = false;
+
+// Small stable numbers for the report instead of opaque thread ids. 0 is the main thread.
+std::atomic<u32> g_nextThreadIdx = 1;
+thread_local u32 t_threadIdx = 0;
+thread_local bool t_threadIdxAssigned = false;
+
+u64 nowNs();
+u32 currentThreadIdx();
+
+} // namespace
+
+StartupTimeline::Scope::Scope(const char* name) : m_idx(StartupTimeline::phaseBegin(name)) {}
+
+StartupTimeline::Scope::~Scope() {
+    StartupTimeline::phaseEnd(m_idx);
+}
+
+void StartupTimeline::start() {
+    g_origin = Clock::now();
+    g_mainThread = std::this_thread::get_id();
+    t_threadIdx = 0;
+    t_threadIdxAssigned = true;
+}
+
+i32 StartupTimeline::phaseBegin(const char* name) {
+    if (g_reported.load(std::memory_order_relaxed)) return -1;
+
+    u32 idx = g_phasesCount.fetch_add(1, std::memory_order_relaxed);
+    if (idx >= MAX_PHASES) return -1;
+
+    Phase& p = g_phases[idx];
+    p.name = name;
+    p.beginNs = nowNs();
+    p.threadIdx = currentThreadIdx();
+    p.endNs.store(0, std::memory_order_release);
+    return i32(idx);
+}
+
+void StartupTimeline::phaseEnd(i32 idx) {
+    if (idx < 0) return;
+    g_phases[idx].endNs.store(nowNs(), std::memory_order_release);
+}
+
+void StartupTimeline::firstFramePresented() {
+    if (g_reported.exchange(true)) return;
+
+    u64 firstFrameNs = nowNs();
+    u32 count = core::min(g_phasesCount.load(std::memory_order_acquire), MAX_PHASES);
+
+    logSectionTitleInfoTagged(APP_TAG, "Startup Timeline");
+    for (u32 i = 0; i < count; i++) {
+        const Phase& p = g_phases[i];
+        u64 endNs = p.endNs.load(std::memory_order_acquire);
+        bool running = endNs == 0;
+        if (running) endNs = firstFrameNs;
+
+        // The bar spans the phase on a time axis from process start to the first frame.
+        char bar[REPORT_BAR_WIDTH + 1];
+        u32 from = u32((p.beginNs * REPORT_BAR_WIDTH) / (firstFrameNs + 1));
+        u32 to = u32((endNs * REPORT_BAR_WIDTH) / (firstFrameNs + 1));
+        for (u32 c = 0; c < REPORT_BAR_WIDTH; c++) {
+            bar[c] = (c >= from && c <= to) ? '#' : '.';
+        }
+        bar[REPORT_BAR_WIDTH] = '\0';
+
+        logInfoTagged(APP_TAG, "|{}| {}ms +{}ms thread={} {}{}",
+                      bar, f64(p.beginNs) / 1e6, f64(endNs - p.beginNs) / 1e6, p.threadIdx, p.name,
+                      running ? " (still running)" : "");
+    }
+    logInfoTagged(APP_TAG, ANSI_BOLD("Time to first frame: {}ms"), f64(firstFrameNs) / 1e6);
+}
+
+namespace {
+
+u64 nowNs() {
+    return u64(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - g_origin).count());
+}
+
+u32 currentThreadIdx() {
+    if (!t_threadIdxAssigned) {
+        t_threadIdx = std::this_thread::get_id() == g_mainThread ? 0
+                                                                 : g_nextThreadIdx.fetch_add(1, std::memory_order_relaxed);
+        t_threadIdxAssigned = true;
+    }
+    return t_threadIdx;
+}
+
+} // namespace
@@ -0,0 +1,198 @@
+#include <app_logger.h>
+#include <stl_loader.h>
+
+#include <cstdlib>
+
+using PlatformError::Type::FAILED_TO_LOAD_STL_FILE;
+using PlatformError::Type::FAILED_TO_PARSE_STL_FILE;
+
+namespace {
+
+bool isBinaryStl(core::Memory<const u8> bytes, u32& outTriangleCount);
+core::expected<StlMesh, AppError> parseBinary(core::Memory<const u8> bytes, u32 triangleCount);
+core::expected<StlMesh, AppError> parseAscii(core::Memory<const u8> bytes);
+void computeBounds(StlMesh& mesh);
+
+} // namespace
+
+core::expected<StlMesh, AppError> StlMesh::parse(core::Memory<const u8> bytes) {
+    u32 triangleCount = 0;
+    if (isBinaryStl(bytes, triangleCount)) {
+        return parseBinary(bytes, triangleCount);
+    }
+    return parseAscii(bytes);
+}
+
+core::expected<StlMesh, AppError> StlMesh::loadFromFile(core::StrView path) {
+    core::ArrList<u8> bytes;
+    if (auto res = core::fileReadEntire(path.data(), bytes); res.hasErr()) {
+        char errBuf[core::MAX_SYSTEM_ERR_MSG_SIZE];
+        Assert(core::pltErrorDescribe(res.err(), errBuf), "Failed to describe platform error");
+        logErrTagged(LOADER_TAG, "Failed to load STL file, path: {}, reason: {}", path.data(), errBuf);
+        return core::unexpected(createPltErr(FAILED_TO_LOAD_STL_FILE, "Failed to load STL file"));
+    }
+
+    auto res = StlMesh::parse(bytes.memView());
+    if (res.hasErr()) {
+        logErrTagged(LOADER_TAG, "Failed to parse STL file, path: {}", path.data());
+        return res;
+    }
+
+    logInfoTagged(LOADER_TAG, "Loaded STL file: {} (triangles={})", path.data(), res.value().triangleCount());
+    return res;
+}
+
+namespace {
+
+bool isBinaryStl(core::Memory<const u8> bytes, u32& outTriangleCount) {
+    constexpr addr_size countOffset = StlMesh::BINARY_HEADER_SIZE;
+    if (bytes.len() < countOffset + sizeof(u32)) {
+        return false;
+    }
+
+    // NOTE: Some exporters write "solid" at the start of binary files as well, so the only reliable check is whether the
+    //       file size matches the triangle count in the header.
+    u32 triangleCount = 0;
+    core::memcopy(&triangleCount, bytes.data() + countOffset, sizeof(u32));
+    addr_size expectedSize = countOffset + sizeof(u32) + addr_size(triangleCount) * StlMesh::BINARY_TRIANGLE_SIZE;
+    if (bytes.len() != expectedSize) {
+        return false;
+    }
+
+    outTriangleCount = triangleCount;
+    return true;
+}
+
+core::expected<StlMesh, AppError> parseBinary(core::Memory<const u8> bytes, u32 triangleCount) {
+    StlMesh mesh;
+    mesh.normals.replaceWith(0.0f, addr_size(triangleCount) * 3);
+    mesh.positions.replaceWith(0.0f, addr_size(triangleCount) * 9);
+
+    const u8* curr = bytes.data() + StlMesh::BINARY_HEADER_SIZE + sizeof(u32);
+    f32* normals = mesh.normals.data();
+    f32* positions = mesh.positions.data();
+
+    for (u32 i = 0; i < triangleCount; i++) {
+        // Layout: normal (3 x f32), vertices (9 x f32), attribute byte count (u16).
+        core::memcopy(normals, curr, sizeof(f32) * 3);
+        core::memcopy(positions, curr + sizeof(f32) * 3, sizeof(f32) * 9);
+        normals += 3;
+        positions += 9;
+        curr += StlMesh::BINARY_TRIANGLE_SIZE;
+    }
+
+    computeBounds(mesh);
+    return mesh;
+}
+
+core::expected<StlMesh, AppError> parseAscii(core::Memory<const u8> bytes) {
+    const char* curr = reinterpret_cast<const char*>(bytes.data());
+    const char* end = curr + bytes.len();
+
+    struct Token {
+        const char* ptr = nullptr;
+        addr_size len = 0;
+
+        bool eq(const char* keyword) const {
+            return core::memcmp(ptr, len, keyword, core::cstrLen(keyword)) == 0;
+        }
+    };
+
+    auto isSpace = [](char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; };
+
+    auto nextToken = [&](Token& out) -> bool {
+        while (curr < end && isSpace(*curr)) curr++;
+        out.ptr = curr;
+        while (curr < end && !isSpace(*curr)) curr++;
+        out.len = addr_size(curr - out.ptr);
+        return out.len > 0;
+    };
+
+    auto nextFloat = [&](f32& out) -> bool {
+        Token token;
+        if (!nextToken(token)) return false;
+
+        // The input is not null terminated, so copy the token before converting it.
+        constexpr addr_size MAX_FLOAT_TOKEN_LEN = 64;
+        char buf[MAX_FLOAT_TOKEN_LEN];
+        if (token.len >= MAX_FLOAT_TOKEN_LEN) return false;
+        core::memcopy(buf, token.ptr, token.len);
+        buf[token.len] = '\0';
+
+        char* parseEnd = nullptr;
+        out = std::strtof(buf, &parseEnd);
+        return parseEnd == buf + token.len;
+    };
+
+    auto parseErr = [](const char* msg) {
+        logErrTagged(LOADER_TAG, "ASCII STL: {}", msg);
+        return core::unexpected(createPltErr(FAILED_TO_PARSE_STL_FILE, "Failed to parse STL file"));
+    };
+
+    StlMesh mesh;
+    Token token;
+
+    if (!nextToken(token) || !token.eq("solid")) {
+        return parseErr("missing 'solid' keyword");
+    }
+
+    while (nextToken(token)) {
+        if (token.eq("facet")) {
+            // facet normal nx ny nz
+            if (!nextToken(token) || !token.eq("normal")) return parseErr("expected 'normal'");
+            for (i32 i = 0; i < 3; i++) {
+                f32 n;
+                if (!nextFloat(n)) return parseErr("invalid normal");
+                mesh.normals.push(n);
+            }
+
+            // outer loop
+            if (!nextToken(token) || !token.eq("outer")) return parseErr("expected 'outer'");
+            if (!nextToken(token) || !token.eq("loop")) return parseErr("expected 'loop'");
+
+            // vertex x y z (x3)
+            for (i32 v = 0; v < 3; v++) {
+                if (!nextToken(token) || !token.eq("vertex")) return parseErr("expected 'vertex'");
+                for (i32 i = 0; i < 3; i++) {
+                    f32 p;
+                    if (!nextFloat(p)) return parseErr("invalid vertex");
+                    mesh.positions.push(p);
+                }
+            }
+
+            // endloop endfacet
+            if (!nextToken(token) || !token.eq("endloop")) return parseErr("expected 'endloop'");
+            if (!nextToken(token) || !token.eq("endfacet")) return parseErr("expected 'endfacet'");
+        }
+        else if (token.eq("endsolid")) {
+            // The solid name follows, nothing else is of interest.
+            break;
+        }
+        // Anything else is the name of the solid.
+    }
+
+    computeBounds(mesh);
+    return mesh;
+}
+
+void computeBounds(StlMesh& mesh) {
+    if (mesh.positions.empty()) {
+        return;
+    }
+
+    const f32* p = mesh.positions.data();
+    for (i32 i = 0; i < 3; i++) {
+        mesh.boundsMin[i] = p[i];
+        mesh.boundsMax[i] = p[i];
+    }
+
+    for (addr_size v = 0; v < mesh.positions.len(); v += 3) {
+        for (addr_size i = 0; i < 3; i++) {
+            f32 c = p[v + i];
+            if (c < mesh.boundsMin[i]) mesh.boundsMin[i] = c;
+            if (c > mesh.boundsMax[i]) mesh.boundsMax[i] = c;
+        }
+    }
+}
+
+} // namespace
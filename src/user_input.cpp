@@ -1,5 +1,7 @@
 #include <platform.h>
 
+#include <chrono>
+
 const char* keyModifiersToCptr(KeyboardModifiers m) {
     using KeyboardModifiers::MODNONE;
     using KeyboardModifiers::MODSHIFT;
@@ -29,3 +31,112 @@ const char* keyModifiersToCptr(KeyboardModifiers m) {
 
     return "Unknown";
 }
+
+const char* inputEventTypeToCptr(InputEventType t) {
+    switch (t) {
+        case InputEventType::NONE:                 return "NONE";
+        case InputEventType::WINDOW_CLOSE:         return "WINDOW_CLOSE";
+        case InputEventType::WINDOW_RESIZE:        return "WINDOW_RESIZE";
+        case InputEventType::WINDOW_FOCUS:         return "WINDOW_FOCUS";
+        case InputEventType::KEY:                  return "KEY";
+        case InputEventType::MOUSE_CLICK:          return "MOUSE_CLICK";
+        case InputEventType::MOUSE_MOVE:           return "MOUSE_MOVE";
+        case InputEventType::MOUSE_SCROLL:         return "MOUSE_SCROLL";
+        case InputEventType::MOUSE_ENTER_OR_LEAVE: return "MOUSE_ENTER_OR_LEAVE";
+    }
+    return "Unknown";
+}
+
+u64 inputTimestampNs() {
+    using namespace std::chrono;
+    return u64(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+namespace {
+
+InputEvent createEvent(InputEventType type) {
+    InputEvent ev;
+    ev.type = type;
+    ev.timestampNs = inputTimestampNs();
+    return ev;
+}
+
+} // namespace
+
+InputEvent InputEvent::createWindowClose() {
+    return createEvent(InputEventType::WINDOW_CLOSE);
+}
+
+InputEvent InputEvent::createWindowResize(i32 w, i32 h) {
+    InputEvent ev = createEvent(InputEventType::WINDOW_RESIZE);
+    ev.resize = { w, h };
+    return ev;
+}
+
+InputEvent InputEvent::createWindowFocus(bool gain) {
+    InputEvent ev = createEvent(InputEventType::WINDOW_FOCUS);
+    ev.focus = { gain };
+    return ev;
+}
+
+InputEvent InputEvent::createKey(bool isPress, u32 vkcode, u32 scancode, KeyboardModifiers mods) {
+    InputEvent ev = createEvent(InputEventType::KEY);
+    ev.key = { isPress, vkcode, scancode, mods };
+    return ev;
+}
+
+InputEvent InputEvent::createMouseClick(bool isPress, MouseButton button, i32 x, i32 y, KeyboardModifiers mods) {
+    InputEvent ev = createEvent(InputEventType::MOUSE_CLICK);
+    ev.click = { isPress, button, x, y, mods };
+    return ev;
+}
+
+InputEvent InputEvent::createMouseMove(i32 x, i32 y) {
+    InputEvent ev = createEvent(InputEventType::MOUSE_MOVE);
+    ev.move = { x, y };
+    return ev;
+}
+
+InputEvent InputEvent::createMouseScroll(MouseScrollDirection direction, i32 x, i32 y) {
+    InputEvent ev = createEvent(InputEventType::MOUSE_SCROLL);
+    ev.scroll = { direction, x, y };
+    return ev;
+}
+
+InputEvent InputEvent::createMouseEnterOrLeave(bool enter) {
+    InputEvent ev = createEvent(InputEventType::MOUSE_ENTER_OR_LEAVE);
+    ev.enterOrLeave = { enter };
+    return ev;
+}
+
+bool InputEventQueue::push(const InputEvent& ev) {
+    if (m_count == CAPACITY) {
+        InputEvent& newest = m_events[(m_head + m_count - 1) % CAPACITY];
+        if (ev.type == InputEventType::MOUSE_MOVE && newest.type == InputEventType::MOUSE_MOVE) {
+            // Only the position moves forward, the older timestamp is the one the latency is measured from.
+            newest.move = ev.move;
+            return true;
+        }
+
+        m_dropped++;
+        return false;
+    }
+
+    m_events[(m_head + m_count) % CAPACITY] = ev;
+    m_count++;
+    return true;
+}
+
+bool InputEventQueue::pop(InputEvent& out) {
+    if (m_count == 0) return false;
+
+    out = m_events[m_head];
+    m_head = (m_head + 1) % CAPACITY;
+    m_count--;
+    return true;
+}
+
+void InputEventQueue::clear() {
+    m_head = 0;
+    m_count = 0;
+}
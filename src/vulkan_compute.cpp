@@ -0,0 +1,328 @@
+#include <app_logger.h>
+#include <vulkan_renderer.h>
+
+namespace {
+
+struct JobSlot {
+    VkCommandBuffer cmdBuffer = VK_NULL_HANDLE;
+    VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+    u64 timelineValue = 0;
+};
+
+const VulkanDevice* g_device = nullptr;
+VkDevice g_logicalDevice = VK_NULL_HANDLE; // Set once the resources are created.
+VulkanQueue g_queue;
+bool g_isAsync = false;
+VkCommandPool g_cmdPool = VK_NULL_HANDLE;
+VulkanTimeline g_timeline;
+JobSlot g_slots[VulkanCompute::MAX_JOBS_IN_FLIGHT];
+u32 g_nextSlot = 0;
+
+core::expected<VulkanComputePipeline, AppError> createFromStage(VkDevice logicalDevice, VulkanShaderStage& stage,
+                                                                const VulkanComputePipeline::CreateFromFileInfo& info);
+void ensureCreated();
+JobSlot& acquireSlot();
+u64 submitSlot(JobSlot& slot);
+void recordDispatch(VkCommandBuffer cmdBuffer, VkDescriptorPool descriptorPool, const VulkanCompute::Dispatch& dispatch);
+
+} // namespace
+
+core::expected<VulkanComputePipeline, AppError> VulkanComputePipeline::createFromFile(VkDevice logicalDevice,
+                                                                                      const CreateFromFileInfo& info) {
+    auto stageRes = VulkanShaderStage::createFromFile(logicalDevice, info.shaderPath, VulkanShaderStage::Type::COMPUTE);
+    if (stageRes.hasErr()) {
+        return core::unexpected(stageRes.err());
+    }
+    VulkanShaderStage stage = std::move(stageRes.value());
+
+    // The module is only needed until the pipeline is created.
+    defer { VulkanShaderStage::destroy(stage, logicalDevice); };
+    return createFromStage(logicalDevice, stage, info);
+}
+
+core::expected<VulkanComputePipeline, AppError> VulkanComputePipeline::createFromSpirv(VkDevice logicalDevice,
+                                                                                       core::Memory<const u32> words,
+                                                                                       const CreateFromFileInfo& info) {
+    auto stageRes = VulkanShaderStage::createFromSpirv(logicalDevice, words, VulkanShaderStage::Type::COMPUTE);
+    if (stageRes.hasErr()) {
+        return core::unexpected(stageRes.err());
+    }
+    VulkanShaderStage stage = std::move(stageRes.value());
+
+    defer { VulkanShaderStage::destroy(stage, logicalDevice); };
+    return createFromStage(logicalDevice, stage, info);
+}
+
+void VulkanComputePipeline::destroy(VulkanComputePipeline& pipeline, VkDevice logicalDevice) {
+    defer { pipeline = {}; };
+
+    if (pipeline.pipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(logicalDevice, pipeline.pipeline, nullptr);
+    }
+    if (pipeline.layout != VK_NULL_HANDLE) {
+        vkDestroyPipelineLayout(logicalDevice, pipeline.layout, nullptr);
+    }
+    if (pipeline.setLayout != VK_NULL_HANDLE) {
+        vkDestroyDescriptorSetLayout(logicalDevice, pipeline.setLayout, nullptr);
+    }
+}
+
+void VulkanCompute::init(const VulkanDevice& device) {
+    g_device = &device;
+    g_queue = device.computeQueue;
+    g_isAsync = device.computeQueue.idx != device.graphicsQueue.idx;
+
+    logInfoTagged(RENDERER_TAG, "Compute jobs run {}", g_isAsync ? "asynchronously on a dedicated queue"
+                                                                  : "on the graphics queue");
+}
+
+void VulkanCompute::shutdown() {
+    g_device = nullptr;
+    if (g_logicalDevice == VK_NULL_HANDLE) return;
+
+    VulkanTimeline::wait(g_timeline, g_timeline.lastSubmitted);
+
+    for (u32 i = 0; i < MAX_JOBS_IN_FLIGHT; i++) {
+        vkDestroyDescriptorPool(g_logicalDevice, g_slots[i].descriptorPool, nullptr);
+        g_slots[i] = {};
+    }
+    vkDestroyCommandPool(g_logicalDevice, g_cmdPool, nullptr);
+    g_cmdPool = VK_NULL_HANDLE;
+    VulkanTimeline::destroy(g_timeline);
+    g_logicalDevice = VK_NULL_HANDLE;
+}
+
+u64 VulkanCompute::submit(const Dispatch& dispatch) {
+    Assert(dispatch.pipeline, "Dispatch without a pipeline");
+
+    JobSlot& slot = acquireSlot();
+    recordDispatch(slot.cmdBuffer, slot.descriptorPool, dispatch);
+    return submitSlot(slot);
+}
+
+u64 VulkanCompute::submit(RecordFn record, void* userData) {
+    JobSlot& slot = acquireSlot();
+    record(slot.cmdBuffer, userData);
+    return submitSlot(slot);
+}
+
+bool VulkanCompute::isDone(u64 value) {
+    return value == 0 || VulkanTimeline::isReached(g_timeline, value);
+}
+
+void VulkanCompute::wait(u64 value) {
+    if (value == 0) return;
+    VulkanTimeline::wait(g_timeline, value);
+}
+
+const VulkanTimeline& VulkanCompute::timeline() {
+    // Graphics submissions can wait on it before any job ran.
+    ensureCreated();
+    return g_timeline;
+}
+
+bool VulkanCompute::isAsync() {
+    return g_isAsync;
+}
+
+namespace {
+
+core::expected<VulkanComputePipeline, AppError> createFromStage(VkDevice logicalDevice, VulkanShaderStage& stage,
+                                                                const VulkanComputePipeline::CreateFromFileInfo& info) {
+    constexpr u32 MAX_STORAGE_BUFFERS = VulkanComputePipeline::MAX_STORAGE_BUFFERS;
+    Assert(info.storageBuffersCount <= MAX_STORAGE_BUFFERS, "Too many storage buffers");
+
+    VulkanComputePipeline ret;
+    ret.storageBuffersCount = info.storageBuffersCount;
+    ret.pushConstantsSize = info.pushConstantsSize;
+
+    // Descriptor set layout
+    {
+        VkDescriptorSetLayoutBinding bindings[MAX_STORAGE_BUFFERS] = {};
+        for (u32 i = 0; i < info.storageBuffersCount; i++) {
+            bindings[i].binding = i;
+            bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            bindings[i].descriptorCount = 1;
+            bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        }
+
+        VkDescriptorSetLayoutCreateInfo setLayoutInfo{};
+        setLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        setLayoutInfo.bindingCount = info.storageBuffersCount;
+        setLayoutInfo.pBindings = bindings;
+
+        if (
+            VkResult vres = vkCreateDescriptorSetLayout(logicalDevice, &setLayoutInfo, nullptr, &ret.setLayout);
+            vres != VK_SUCCESS
+        ) {
+            return core::unexpected(createRendErr(RendererError::FAILED_TO_CREATE_VULKAN_PIPELINE_LAYOUT));
+        }
+    }
+
+    // Pipeline layout
+    {
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = info.pushConstantsSize;
+
+        VkPipelineLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        layoutInfo.setLayoutCount = 1;
+        layoutInfo.pSetLayouts = &ret.setLayout;
+        layoutInfo.pushConstantRangeCount = info.pushConstantsSize > 0 ? 1 : 0;
+        layoutInfo.pPushConstantRanges = &pushConstantRange;
+
+        if (
+            VkResult vres = vkCreatePipelineLayout(logicalDevice, &layoutInfo, nullptr, &ret.layout);
+            vres != VK_SUCCESS
+        ) {
+            VulkanComputePipeline::destroy(ret, logicalDevice);
+            return core::unexpected(createRendErr(RendererError::FAILED_TO_CREATE_VULKAN_PIPELINE_LAYOUT));
+        }
+    }
+
+    // Pipeline
+    {
+        VkComputePipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        pipelineInfo.stage.module = stage.shaderModule;
+        pipelineInfo.stage.pName = VulkanShader::SHADERS_ENTRY_FUNCTION;
+        pipelineInfo.layout = ret.layout;
+
+        if (
+            VkResult vres = vkCreateComputePipelines(logicalDevice, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr,
+                                                     &ret.pipeline);
+            vres != VK_SUCCESS
+        ) {
+            VulkanComputePipeline::destroy(ret, logicalDevice);
+            return core::unexpected(createRendErr(RendererError::FAILED_TO_CREATE_VULKAN_COMPUTE_PIPELINE));
+        }
+    }
+
+    logInfoTagged(RENDERER_TAG, "Created Compute Pipeline: {}", info.shaderPath.data());
+    return ret;
+}
+
+void ensureCreated() {
+    if (g_logicalDevice != VK_NULL_HANDLE) return;
+    Assert(g_device != nullptr, "Compute is not initialized");
+
+    g_logicalDevice = g_device->logicalDevice;
+    g_timeline = VulkanTimeline::create(*g_device);
+    g_nextSlot = 0;
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    poolInfo.queueFamilyIndex = u32(g_queue.idx);
+    VK_MUST(vkCreateCommandPool(g_logicalDevice, &poolInfo, nullptr, &g_cmdPool));
+
+    VkCommandBuffer cmdBuffers[VulkanCompute::MAX_JOBS_IN_FLIGHT];
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = g_cmdPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = VulkanCompute::MAX_JOBS_IN_FLIGHT;
+    VK_MUST(vkAllocateCommandBuffers(g_logicalDevice, &allocInfo, cmdBuffers));
+
+    // One pool per job, reset as a whole when the slot is reused.
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = VulkanComputePipeline::MAX_STORAGE_BUFFERS;
+
+    VkDescriptorPoolCreateInfo descriptorPoolInfo{};
+    descriptorPoolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    descriptorPoolInfo.maxSets = 1;
+    descriptorPoolInfo.poolSizeCount = 1;
+    descriptorPoolInfo.pPoolSizes = &poolSize;
+
+    for (u32 i = 0; i < VulkanCompute::MAX_JOBS_IN_FLIGHT; i++) {
+        g_slots[i] = {};
+        g_slots[i].cmdBuffer = cmdBuffers[i];
+        VK_MUST(vkCreateDescriptorPool(g_logicalDevice, &descriptorPoolInfo, nullptr, &g_slots[i].descriptorPool));
+    }
+
+    logInfoTagged(RENDERER_TAG, "Compute resources created");
+}
+
+JobSlot& acquireSlot() {
+    ensureCreated();
+
+    JobSlot& slot = g_slots[g_nextSlot];
+    g_nextSlot = (g_nextSlot + 1) % VulkanCompute::MAX_JOBS_IN_FLIGHT;
+
+    VulkanTimeline::wait(g_timeline, slot.timelineValue);
+    VK_MUST(vkResetDescriptorPool(g_logicalDevice, slot.descriptorPool, 0));
+    VK_MUST(vkResetCommandBuffer(slot.cmdBuffer, 0));
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    VK_MUST(vkBeginCommandBuffer(slot.cmdBuffer, &beginInfo));
+
+    return slot;
+}
+
+u64 submitSlot(JobSlot& slot) {
+    VK_MUST(vkEndCommandBuffer(slot.cmdBuffer));
+
+    VulkanTimeline::Submit submit;
+    submit.cmdBuffer = slot.cmdBuffer;
+    slot.timelineValue = VulkanTimeline::submit(g_timeline, g_queue.handle, submit);
+    return slot.timelineValue;
+}
+
+void recordDispatch(VkCommandBuffer cmdBuffer, VkDescriptorPool descriptorPool, const VulkanCompute::Dispatch& dispatch) {
+    const VulkanComputePipeline& pipeline = *dispatch.pipeline;
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = descriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &pipeline.setLayout;
+
+    VkDescriptorSet descriptorSet;
+    VK_MUST(vkAllocateDescriptorSets(g_logicalDevice, &allocInfo, &descriptorSet));
+
+    VkDescriptorBufferInfo bufferInfos[VulkanComputePipeline::MAX_STORAGE_BUFFERS];
+    VkWriteDescriptorSet writes[VulkanComputePipeline::MAX_STORAGE_BUFFERS];
+    for (u32 i = 0; i < pipeline.storageBuffersCount; i++) {
+        bufferInfos[i] = {};
+        bufferInfos[i].buffer = dispatch.storageBuffers[i];
+        bufferInfos[i].offset = 0;
+        bufferInfos[i].range = VK_WHOLE_SIZE;
+
+        writes[i] = {};
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = descriptorSet;
+        writes[i].dstBinding = i;
+        writes[i].descriptorCount = 1;
+        writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[i].pBufferInfo = &bufferInfos[i];
+    }
+    vkUpdateDescriptorSets(g_logicalDevice, pipeline.storageBuffersCount, writes, 0, nullptr);
+
+    vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline.pipeline);
+    vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline.layout, 0, 1, &descriptorSet, 0, nullptr);
+    if (pipeline.pushConstantsSize > 0) {
+        Assert(dispatch.pushConstants, "Missing push constants");
+        vkCmdPushConstants(cmdBuffer, pipeline.layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, pipeline.pushConstantsSize,
+                           dispatch.pushConstants);
+    }
+    vkCmdDispatch(cmdBuffer, dispatch.groupCountX, dispatch.groupCountY, dispatch.groupCountZ);
+
+    // The timeline signal alone does not make device writes visible to the host.
+    if (dispatch.readBackOnHost) {
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0,
+                             1, &barrier, 0, nullptr, 0, nullptr);
+    }
+}
+
+} // namespace
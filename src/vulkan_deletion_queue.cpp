@@ -0,0 +1,70 @@
+#include <vulkan_renderer.h>
+
+void VulkanDeletionQueue::pushBuffer(VkBuffer buffer) {
+    Entry e;
+    e.type = Type::BUFFER;
+    e.buffer = buffer;
+    entries.push(e);
+}
+
+void VulkanDeletionQueue::pushMemory(VkDeviceMemory memory) {
+    Entry e;
+    e.type = Type::DEVICE_MEMORY;
+    e.memory = memory;
+    entries.push(e);
+}
+
+void VulkanDeletionQueue::pushFramebuffer(VkFramebuffer framebuffer) {
+    Entry e;
+    e.type = Type::FRAMEBUFFER;
+    e.framebuffer = framebuffer;
+    entries.push(e);
+}
+
+void VulkanDeletionQueue::pushImageView(VkImageView imageView) {
+    Entry e;
+    e.type = Type::IMAGE_VIEW;
+    e.imageView = imageView;
+    entries.push(e);
+}
+
+void VulkanDeletionQueue::pushSwapchain(VkSwapchainKHR swapchain) {
+    Entry e;
+    e.type = Type::SWAPCHAIN;
+    e.swapchain = swapchain;
+    entries.push(e);
+}
+
+void VulkanDeletionQueue::pushPipeline(VkPipeline pipeline) {
+    Entry e;
+    e.type = Type::PIPELINE;
+    e.pipeline = pipeline;
+    entries.push(e);
+}
+
+void VulkanDeletionQueue::pushImage(VkImage image) {
+    Entry e;
+    e.type = Type::IMAGE;
+    e.image = image;
+    entries.push(e);
+}
+
+void VulkanDeletionQueue::flush(VulkanDeletionQueue& queue, VkDevice logicalDevice) {
+    // Destroy in push order. Dependent objects are pushed before the objects they depend on, e.g. the image views of a
+    // swapchain before the swapchain itself.
+    for (addr_size i = 0; i < queue.entries.len(); i++) {
+        auto& e = queue.entries[i];
+        switch (e.type) {
+            case Type::BUFFER:        vkDestroyBuffer(logicalDevice, e.buffer, nullptr);             break;
+            case Type::DEVICE_MEMORY: vkFreeMemory(logicalDevice, e.memory, nullptr);                break;
+            case Type::FRAMEBUFFER:   vkDestroyFramebuffer(logicalDevice, e.framebuffer, nullptr);   break;
+            case Type::IMAGE_VIEW:    vkDestroyImageView(logicalDevice, e.imageView, nullptr);       break;
+            case Type::SWAPCHAIN:     vkDestroySwapchainKHR(logicalDevice, e.swapchain, nullptr);    break;
+            case Type::PIPELINE:      vkDestroyPipeline(logicalDevice, e.pipeline, nullptr);         break;
+            case Type::IMAGE:         vkDestroyImage(logicalDevice, e.image, nullptr);               break;
+        }
+    }
+
+    // Keep the capacity, the queue is refilled every time something is recreated.
+    queue.entries.clear();
+}
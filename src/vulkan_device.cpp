@@ -15,6 +15,8 @@ constexpr bool VALIDATION_LAYERS_ENABLED = true;
 constexpr bool VALIDATION_LAYERS_ENABLED = false;
 #endif
 
+bool g_physicalDeviceProps2Enabled = false;
+
 ExtPropsList g_allSupportedInstExts;
 LayerPropsList g_allSupportedInstLayers;
 GPUDeviceList g_allSupportedGPUs;
@@ -50,10 +52,10 @@ VkDevice vulkanCreateLogicalDevice(VulkanDevice& device);
 
 } // namespace
 
-core::expected<VulkanDevice, AppError> VulkanDevice::create(const RendererInitInfo& rendererInitInfo) {
+VulkanDevice VulkanDevice::createInstance(const RendererInitInfo& rendererInitInfo) {
     VulkanDevice device;
 
-    logInfoTagged(RENDERER_TAG, "Creating Device");
+    logInfoTagged(RENDERER_TAG, "Creating Instance");
 
     logVulkanVersion();
     logInstExtPropsList(*getAllSupportedInstExtensions());
@@ -72,6 +74,16 @@ core::expected<VulkanDevice, AppError> VulkanDevice::create(const RendererInitIn
         device.debugMessenger = debugMessenger;
     }
 
+    return device;
+}
+
+core::expected<VulkanDevice, AppError> VulkanDevice::create(const RendererInitInfo& rendererInitInfo,
+                                                            VulkanDevice&& withInstance) {
+    VulkanDevice device = std::move(withInstance);
+    Assert(device.instance != VK_NULL_HANDLE, "The instance must be created first");
+
+    logInfoTagged(RENDERER_TAG, "Creating Device");
+
     // Create a Surface
     VulkanSurface surface;
     Assert(Platform::createVulkanSurface(device.instance, surface.handle).isOk());
@@ -81,7 +93,7 @@ core::expected<VulkanDevice, AppError> VulkanDevice::create(const RendererInitIn
     // Pick a suitable GPU
     device.deviceExtensions.required = rendererInitInfo.backend.vk.requiredDeviceExtensions;
     device.deviceExtensions.optional = rendererInitInfo.backend.vk.optionalDeviceExtensions;
-    device.vSyncOn = rendererInitInfo.vSyncOn;
+    device.pacingMode = rendererInitInfo.pacingMode;
     GPUDeviceList* all = getAllSupportedPhysicalDevices(device.instance);
     core::Expect(pickDevice(all->memView(), device), "Failed to pick a physical device");
 
@@ -98,12 +110,31 @@ core::expected<VulkanDevice, AppError> VulkanDevice::create(const RendererInitIn
         // Retrieve the Present Queue from the new logical device
         vkGetDeviceQueue(device.logicalDevice, u32(device.presentQueue.idx), 0, &device.presentQueue.handle);
         logInfoTagged(RENDERER_TAG, "Present Queue set");
+
+        // Retrieve the Compute Queue from the new logical device
+        vkGetDeviceQueue(device.logicalDevice, u32(device.computeQueue.idx), 0, &device.computeQueue.handle);
+        logInfoTagged(RENDERER_TAG, "Compute Queue set ({})",
+                      device.computeQueue.idx != device.graphicsQueue.idx ? "dedicated" : "shared with graphics");
     }
 
 
     return device;
 }
 
+bool VulkanDevice::findMemoryType(const VulkanDevice& device, u32 typeFilter, VkMemoryPropertyFlags properties,
+                                  u32& outIdx) {
+    VkPhysicalDeviceMemoryProperties memProperties;
+    vkGetPhysicalDeviceMemoryProperties(device.physicalDevice, &memProperties);
+    for (u32 i = 0; i < memProperties.memoryTypeCount; i++) {
+        bool isSupported = (memProperties.memoryTypes[i].propertyFlags & properties) == properties;
+        if ((typeFilter & (1 << i)) && isSupported) {
+            outIdx = i;
+            return true;
+        }
+    }
+    return false;
+}
+
 void VulkanDevice::destroy(VulkanDevice& device) {
     if (device.logicalDevice != VK_NULL_HANDLE) {
         logInfoTagged(RENDERER_TAG, "Destroying Vulkan logical device");
@@ -172,6 +203,10 @@ VkInstance vulkanCreateInstance(const RendererInitInfo& rendererInitInfo) {
             const char* ex = rendererInitInfo.backend.vk.optionalInstanceExtensions[i];
             if (checkSupportForInstExtension(ex)) {
                 extensions.push(ex);
+                if (core::memcmp(ex, core::cstrLen(ex), VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME,
+                                 core::cstrLen(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME)) == 0) {
+                    g_physicalDeviceProps2Enabled = true;
+                }
             }
             else {
                 logWarnTagged(RENDERER_TAG, "Missing optional extension: {}", ex);
@@ -462,7 +497,8 @@ VkDevice vulkanCreateLogicalDevice(VulkanDevice& device) {
     {
         constexpr auto uniqueIdxFn = [](i32 v, addr_size, i32 el) { return v == el; };
         core::pushUnique(uniqueIndices, device.graphicsQueue.idx, uniqueIdxFn);
-        core::pushUnique(uniqueIndices, device.graphicsQueue.idx, uniqueIdxFn);
+        core::pushUnique(uniqueIndices, device.presentQueue.idx, uniqueIdxFn);
+        core::pushUnique(uniqueIndices, device.computeQueue.idx, uniqueIdxFn);
     }
 
     core::ArrStatic<VkDeviceQueueCreateInfo, MAX_QUEUES> queueInfos;
@@ -491,9 +527,68 @@ VkDevice vulkanCreateLogicalDevice(VulkanDevice& device) {
     VkPhysicalDeviceFeatures deviceFeatures {};
     // For example:
     // deviceFeatures.samplerAnisotropy = VK_TRUE;
+    deviceFeatures.fillModeNonSolid = device.physicalDeviceFeatures.fillModeNonSolid; // Optional, wireframe shading.
+    device.fillModeNonSolidEnabled = deviceFeatures.fillModeNonSolid == VK_TRUE;
+
+    // Features of optional extensions. Each one whose extension is active is chained, the chain is queried through
+    // VK_KHR_get_physical_device_properties2 (required on a 1.0 instance) and then passed on to device creation as is,
+    // which enables exactly the supported features.
+    VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures {};
+    presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures {};
+    presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+    VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineFeatures {};
+    timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures {};
+    dynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+    void* featuresChain = nullptr;
+
+    if (device.deviceExtensions.isOptionalActive(VK_KHR_PRESENT_ID_EXTENSION_NAME) &&
+        device.deviceExtensions.isOptionalActive(VK_KHR_PRESENT_WAIT_EXTENSION_NAME)) {
+        presentIdFeatures.pNext = featuresChain;
+        presentWaitFeatures.pNext = &presentIdFeatures;
+        featuresChain = &presentWaitFeatures;
+    }
+    if (device.deviceExtensions.isOptionalActive(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME)) {
+        timelineFeatures.pNext = featuresChain;
+        featuresChain = &timelineFeatures;
+    }
+    // The extension is only usable with all of its dependencies enabled as well.
+    if (device.deviceExtensions.isOptionalActive(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME) &&
+        device.deviceExtensions.isOptionalActive(VK_KHR_DEPTH_STENCIL_RESOLVE_EXTENSION_NAME) &&
+        device.deviceExtensions.isOptionalActive(VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME) &&
+        device.deviceExtensions.isOptionalActive(VK_KHR_MULTIVIEW_EXTENSION_NAME) &&
+        device.deviceExtensions.isOptionalActive(VK_KHR_MAINTENANCE2_EXTENSION_NAME)) {
+        dynamicRenderingFeatures.pNext = featuresChain;
+        featuresChain = &dynamicRenderingFeatures;
+    }
+
+    void* deviceCreatePNext = nullptr;
+    if (g_physicalDeviceProps2Enabled && featuresChain) {
+        auto getFeatures2 = reinterpret_cast<PFN_vkGetPhysicalDeviceFeatures2KHR>(
+            vkGetInstanceProcAddr(device.instance, "vkGetPhysicalDeviceFeatures2KHR"));
+
+        if (getFeatures2) {
+            VkPhysicalDeviceFeatures2KHR features2 {};
+            features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+            features2.pNext = featuresChain;
+            getFeatures2(device.physicalDevice, &features2);
+
+            deviceCreatePNext = featuresChain;
+            device.presentWaitEnabled = presentIdFeatures.presentId && presentWaitFeatures.presentWait;
+            device.timelineSemaphoreEnabled = timelineFeatures.timelineSemaphore;
+            device.dynamicRenderingEnabled = dynamicRenderingFeatures.dynamicRendering;
+        }
+    }
+    logInfoTagged(RENDERER_TAG, "Present wait: {}", device.presentWaitEnabled ? "enabled" : "not supported");
+    logInfoTagged(RENDERER_TAG, "Timeline semaphores: {}",
+                  device.timelineSemaphoreEnabled ? "enabled" : "not supported, falling back to fences");
+    logInfoTagged(RENDERER_TAG, "Dynamic rendering: {}",
+                  device.dynamicRenderingEnabled ? "enabled" : "not supported, falling back to render passes");
 
     VkDeviceCreateInfo deviceCreateInfo {};
     deviceCreateInfo.sType                   = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    deviceCreateInfo.pNext                   = deviceCreatePNext;
     deviceCreateInfo.pQueueCreateInfos       = queueInfos.data();
     deviceCreateInfo.queueCreateInfoCount    = u32(queueInfos.len());
     deviceCreateInfo.pEnabledFeatures        = &deviceFeatures;
@@ -11,6 +11,7 @@ using DeviceExtensions = VulkanDevice::Extensions;
 struct QueueFamilyIndices {
     i32 graphicsIndex = -1;
     i32 presentIndex  = -1;
+    i32 computeIndex  = -1; // A compute only family when there is one, the graphics family otherwise.
 
     constexpr bool hasMinimumSupport() {
         return graphicsIndex >= 0 && presentIndex >= 0;
@@ -29,7 +30,8 @@ u32                                                            getDeviceSutabili
                                                                                         const VulkanDevice& infoDevice,
                                                                                         QueueFamilyIndices& outIndices,
                                                                                         VulkanSurface::CachedCapabilities& outPickedSurfaceCapabilities,
-                                                                                        core::ArrList<bool>& outOptionalExtsActiveList);
+                                                                                        core::ArrList<bool>& outOptionalExtsActiveList,
+                                                                                        FrameArena& scratch);
 
 core::ArrList<VkQueueFamilyProperties>                         getVkQueueFamilyPropsForDevice(VkPhysicalDevice device);
 core::expected<QueueFamilyIndices, AppError>                   findQueueIndices(VkPhysicalDevice device, const VulkanDevice& infoDevice);
@@ -43,10 +45,11 @@ bool                                                           checkRequiredDevi
                                                                                               const core::ArrList<VkExtensionProperties>& supportedExts);
 
 void                                                           logSurfaceCapabilities(const VulkanSurface& surface);
-bool                                                           pickSurfaceFormat(const core::ArrList<VkSurfaceFormatKHR>& formats,
+bool                                                           pickSurfaceFormat(core::Memory<const VkSurfaceFormatKHR> formats,
                                                                                  VkSurfaceFormatKHR& out);
-VkPresentModeKHR                                               pickSurfacePresentMode(const core::ArrList<VkPresentModeKHR>& presentModes, bool vSyncOn);
+VkPresentModeKHR                                               pickSurfacePresentMode(core::Memory<const VkPresentModeKHR> presentModes, PacingMode pacingMode);
 VkExtent2D                                                     pickSurfaceExtent(const VkSurfaceCapabilitiesKHR& capabilities);
+const char*                                                    presentModeToCStr(VkPresentModeKHR mode);
 
 } // namespace
 
@@ -56,7 +59,12 @@ core::expected<AppError> VulkanDevice::pickDevice(core::Memory<const PhysicalDev
 
     logInfoTagged(RENDERER_TAG, "Physical Devices ({}) to pick from:", gpus.len());
 
+    // Scratch space for the surface queries, reused for every device.
+    FrameArena scratch = FrameArena::create(4 * core::CORE_KILOBYTE);
+    defer { FrameArena::destroy(scratch); };
+
     for (addr_size i = 0; i < gpus.len(); i++) {
+        FrameArena::reset(scratch);
         QueueFamilyIndices queueFamilies{};
         VulkanSurface::CachedCapabilities outPickedSurfaceCapabilities;
         core::ArrList<bool> optionalExtsActiveList (out.deviceExtensions.optional.len(), false);
@@ -66,7 +74,8 @@ core::expected<AppError> VulkanDevice::pickDevice(core::Memory<const PhysicalDev
                                                  out,
                                                  queueFamilies,
                                                  outPickedSurfaceCapabilities,
-                                                 optionalExtsActiveList);
+                                                 optionalExtsActiveList,
+                                                 scratch);
 
         if (currScore > maxScore) {
             prefferedIdx = i32(i);
@@ -77,6 +86,7 @@ core::expected<AppError> VulkanDevice::pickDevice(core::Memory<const PhysicalDev
             out.physicalDeviceProps = gpus[addr_size(prefferedIdx)].props;
             out.graphicsQueue.idx = queueFamilies.graphicsIndex;
             out.presentQueue.idx = queueFamilies.presentIndex;
+            out.computeQueue.idx = queueFamilies.computeIndex;
             out.surface.capabilities = std::move(outPickedSurfaceCapabilities);
             out.deviceExtensions.optionalIsActive = std::move(optionalExtsActiveList);
         }
@@ -94,7 +104,8 @@ core::expected<AppError> VulkanDevice::pickDevice(core::Memory<const PhysicalDev
 }
 
 VulkanSurface::Capabilities VulkanSurface::queryCapabilities(const VulkanSurface& surface,
-                                                             VkPhysicalDevice physicalDevice) {
+                                                             VkPhysicalDevice physicalDevice,
+                                                             FrameArena& scratch) {
     VulkanSurface::Capabilities details;
 
     // Basic surface capabilities (min/max number of images in swap chain, min/max width and height of images)
@@ -108,7 +119,7 @@ VulkanSurface::Capabilities VulkanSurface::queryCapabilities(const VulkanSurface
                                                  surface.handle,
                                                  &formatCount,
                                                  nullptr));
-    details.formats.replaceWith(VkSurfaceFormatKHR{}, formatCount);
+    details.formats = FrameArena::allocArr<VkSurfaceFormatKHR>(scratch, formatCount);
     VK_MUST(vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice,
                                                  surface.handle,
                                                  &formatCount,
@@ -120,7 +131,7 @@ VulkanSurface::Capabilities VulkanSurface::queryCapabilities(const VulkanSurface
                                                       surface.handle,
                                                       &presentModeCount,
                                                       nullptr));
-    details.presentModes.replaceWith(VkPresentModeKHR{}, presentModeCount);
+    details.presentModes = FrameArena::allocArr<VkPresentModeKHR>(scratch, presentModeCount);
     VK_MUST(vkGetPhysicalDeviceSurfacePresentModesKHR(physicalDevice,
                                                       surface.handle,
                                                       &presentModeCount,
@@ -131,24 +142,24 @@ VulkanSurface::Capabilities VulkanSurface::queryCapabilities(const VulkanSurface
 
 core::expected<VulkanSurface::CachedCapabilities, AppError> VulkanSurface::pickCapabilities(
     const VulkanSurface::Capabilities& surfaceCapabilities,
-    bool vSyncOn
+    PacingMode pacingMode
 ) {
     const auto& formats = surfaceCapabilities.formats;
     const auto& presentModes = surfaceCapabilities.presentModes;
     const auto& capabilities = surfaceCapabilities.capabilities;
 
-    if (formats.empty()) {
+    if (formats.len() == 0) {
         // No supported formats
         return core::unexpected(createRendErr(RendererError::FAILED_TO_PICK_SUTABLE_SURFACE_FOR_SWAPCHAIN));
     }
-    if (presentModes.empty()) {
+    if (presentModes.len() == 0) {
         // No supported present modes
         return core::unexpected(createRendErr(RendererError::FAILED_TO_PICK_SUTABLE_SURFACE_FOR_SWAPCHAIN));
     }
 
     VulkanSurface::CachedCapabilities ret;
 
-    ret.presentMode = pickSurfacePresentMode(presentModes, vSyncOn);
+    ret.presentMode = pickSurfacePresentMode(presentModes, pacingMode);
     ret.extent = pickSurfaceExtent(capabilities);
 
     ret.imageCount = capabilities.minImageCount + 1;
@@ -166,6 +177,25 @@ core::expected<VulkanSurface::CachedCapabilities, AppError> VulkanSurface::pickC
     return ret;
 }
 
+void VulkanSurface::refreshCapabilities(VulkanSurface& surface, VkPhysicalDevice physicalDevice) {
+    VkSurfaceCapabilitiesKHR capabilities;
+    VK_MUST(vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physicalDevice, surface.handle, &capabilities));
+
+    surface.capabilities.extent = pickSurfaceExtent(capabilities);
+    surface.capabilities.currentTransform = capabilities.currentTransform;
+}
+
+void VulkanSurface::refreshPresentMode(VulkanSurface& surface, VkPhysicalDevice physicalDevice, PacingMode pacingMode,
+                                       FrameArena& scratch) {
+    u32 presentModeCount = 0;
+    VK_MUST(vkGetPhysicalDeviceSurfacePresentModesKHR(physicalDevice, surface.handle, &presentModeCount, nullptr));
+    auto presentModes = FrameArena::allocArr<VkPresentModeKHR>(scratch, presentModeCount);
+    VK_MUST(vkGetPhysicalDeviceSurfacePresentModesKHR(physicalDevice, surface.handle, &presentModeCount,
+                                                      presentModes.data()));
+
+    surface.capabilities.presentMode = pickSurfacePresentMode(presentModes, pacingMode);
+}
+
 namespace  {
 
 /**
@@ -187,7 +217,8 @@ u32 getDeviceSutabilityScore(
     const VulkanDevice& infoDevice,
     QueueFamilyIndices& outIndices,
     VulkanSurface::CachedCapabilities& outPickedSurfaceCapabilities,
-    core::ArrList<bool>& outOptionalExtsActiveList
+    core::ArrList<bool>& outOptionalExtsActiveList,
+    FrameArena& scratch
 ) {
     const auto& device = gpu.handle;
     const auto& props = gpu.props;
@@ -257,8 +288,9 @@ u32 getDeviceSutabilityScore(
 
     // Give a score for the supported Surface features.
     {
-        VulkanSurface::Capabilities surfaceCapabilities = VulkanSurface::queryCapabilities(infoDevice.surface, gpu.handle);
-        auto res = VulkanSurface::pickCapabilities(surfaceCapabilities, infoDevice.vSyncOn);
+        VulkanSurface::Capabilities surfaceCapabilities =
+            VulkanSurface::queryCapabilities(infoDevice.surface, gpu.handle, scratch);
+        auto res = VulkanSurface::pickCapabilities(surfaceCapabilities, infoDevice.pacingMode);
         if (res.hasErr()) {
             // This should be rare.
             logWarnTagged(RENDERER_TAG, "Device surface does not support the required capabilities.");
@@ -337,6 +369,16 @@ core::expected<QueueFamilyIndices, AppError> QueueFamilyIndices::create(
     if (!err.isOk()) return core::unexpected(err);
     if (ret.presentIndex == -1) return ret;
 
+    // A family without graphics support runs compute work asynchronously to the rendering. Devices that have none
+    // (e.g. lavapipe, most integrated GPUs) get the graphics family, which is required to support compute as well.
+    auto findDedicatedComputeQueue = [](const VkQueueFamilyProperties& x, addr_size) {
+        VkQueueFlags flags = x.queueFlags;
+        return (flags & VK_QUEUE_COMPUTE_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT);
+    };
+
+    ret.computeIndex = i32(core::find(vkQueueFamilyProps, findDedicatedComputeQueue));
+    if (ret.computeIndex == -1) ret.computeIndex = ret.graphicsIndex;
+
     return ret;
 }
 
@@ -415,7 +457,7 @@ bool checkRequiredDeviceExtsSupport(core::Memory<const char*> exts, const core::
     return true;
 }
 
-bool pickSurfaceFormat(const core::ArrList<VkSurfaceFormatKHR>& formats, VkSurfaceFormatKHR& out) {
+bool pickSurfaceFormat(core::Memory<const VkSurfaceFormatKHR> formats, VkSurfaceFormatKHR& out) {
     // NOTE:
     //
     // The Vulkan specification mandates that implementations supporting swapchains must support
@@ -438,7 +480,7 @@ bool pickSurfaceFormat(const core::ArrList<VkSurfaceFormatKHR>& formats, VkSurfa
     return false;
 }
 
-VkPresentModeKHR pickSurfacePresentMode(const core::ArrList<VkPresentModeKHR>& presentModes, bool vSyncOn) {
+VkPresentModeKHR pickSurfacePresentMode(core::Memory<const VkPresentModeKHR> presentModes, PacingMode pacingMode) {
     // NOTE: From the Vulkan Tutorial
     //
     // The presentation mode is arguably the most important setting for the swap chain, because it represents the actual
@@ -458,25 +500,55 @@ VkPresentModeKHR pickSurfacePresentMode(const core::ArrList<VkPresentModeKHR>& p
     //   issues than standard vertical sync. This is commonly known as "triple buffering", although the existence of
     //   three buffers alone does not necessarily mean that the framerate is unlocked.
 
-    if (!vSyncOn) {
+    auto isSupported = [&presentModes](VkPresentModeKHR mode) {
         for (addr_size i = 0; i < presentModes.len(); i++) {
-           if (presentModes[i] == VK_PRESENT_MODE_IMMEDIATE_KHR) {
-                return VK_PRESENT_MODE_IMMEDIATE_KHR;
-            }
+            if (presentModes[i] == mode) return true;
         }
+        return false;
+    };
 
-        logWarnTagged(RENDERER_TAG, "Can't turn off VSync - VK_PRESENT_MODE_IMMEDIATE_KHR is not supported.");
+    // FIFO is the only mode that is required to be supported, everything else falls back to it.
+    VkPresentModeKHR preferred[2] = { VK_PRESENT_MODE_FIFO_KHR, VK_PRESENT_MODE_FIFO_KHR };
+    switch (pacingMode) {
+        case PacingMode::UNCAPPED:
+            // Mailbox does not tear and is nearly as fast, when tearing is not available.
+            preferred[0] = VK_PRESENT_MODE_IMMEDIATE_KHR;
+            preferred[1] = VK_PRESENT_MODE_MAILBOX_KHR;
+            break;
+        case PacingMode::LOW_LATENCY:
+            preferred[0] = VK_PRESENT_MODE_MAILBOX_KHR;
+            break;
+        case PacingMode::ADAPTIVE:
+            preferred[0] = VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+            break;
+        case PacingMode::POWER_SAVING: break;
+        case PacingMode::COUNT:        break;
     }
-    else {
-        for (addr_size i = 0; i < presentModes.len(); i++) {
-            if (presentModes[i] == VK_PRESENT_MODE_MAILBOX_KHR) {
-                return VK_PRESENT_MODE_MAILBOX_KHR;
-            }
+
+    VkPresentModeKHR picked = VK_PRESENT_MODE_FIFO_KHR;
+    for (VkPresentModeKHR mode : preferred) {
+        if (isSupported(mode)) {
+            picked = mode;
+            break;
         }
     }
 
-    logInfoTagged(RENDERER_TAG, "Defaulting to VK_PRESENT_MODE_FIFO_KHR");
-    return VK_PRESENT_MODE_FIFO_KHR;
+    if (picked != preferred[0]) {
+        logWarnTagged(RENDERER_TAG, "{} is not supported, falling back to {}",
+                      presentModeToCStr(preferred[0]), presentModeToCStr(picked));
+    }
+    logInfoTagged(RENDERER_TAG, "Present mode for {} pacing: {}", pacingModeToCStr(pacingMode), presentModeToCStr(picked));
+    return picked;
+}
+
+const char* presentModeToCStr(VkPresentModeKHR mode) {
+    switch (mode) {
+        case VK_PRESENT_MODE_IMMEDIATE_KHR:    return "VK_PRESENT_MODE_IMMEDIATE_KHR";
+        case VK_PRESENT_MODE_MAILBOX_KHR:      return "VK_PRESENT_MODE_MAILBOX_KHR";
+        case VK_PRESENT_MODE_FIFO_KHR:         return "VK_PRESENT_MODE_FIFO_KHR";
+        case VK_PRESENT_MODE_FIFO_RELAXED_KHR: return "VK_PRESENT_MODE_FIFO_RELAXED_KHR";
+        default:                               return "unknown";
+    }
 }
 
 VkExtent2D pickSurfaceExtent(const VkSurfaceCapabilitiesKHR& capabilities) {
@@ -0,0 +1,164 @@
+#include <app_logger.h>
+#include <embedded_shaders.h>
+#include <vulkan_renderer.h>
+
+#include <climits>
+
+namespace {
+
+constexpr const char* SHADER_NAME = "mesh_bounds.comp";
+constexpr u32 WORKGROUP_SIZE = 256; // local_size_x in the shader.
+
+// Mirrors the Bounds block in the shader.
+struct OrderedBounds {
+    i32 minX, minY, maxX, maxY;
+};
+
+struct PushConstants {
+    u32 vertexCount;
+    u32 floatsPerVertex;
+};
+
+const VulkanDevice* g_device = nullptr;
+core::StrBuilder g_shaderPath;
+VulkanComputePipeline g_pipeline;
+bool g_failed = false; // The pipeline could not be created, requests are ignored.
+
+VkBuffer g_resultBuffer = VK_NULL_HANDLE;
+VkDeviceMemory g_resultMemory = VK_NULL_HANDLE;
+OrderedBounds* g_result = nullptr; // Persistently mapped.
+u64 g_pendingValue = 0; // Compute timeline value of the request that was not polled yet, 0 when there is none.
+
+bool ensureCreated();
+f32 fromOrderedBits(i32 bits);
+
+} // namespace
+
+void VulkanMeshBounds::init(const VulkanDevice& device, core::StrView shaderPath) {
+    g_device = &device;
+    g_shaderPath.clear();
+    g_shaderPath.append(shaderPath);
+    g_failed = false;
+}
+
+void VulkanMeshBounds::shutdown() {
+    if (!g_device) return;
+
+    wait();
+    VkDevice logicalDevice = g_device->logicalDevice;
+    VulkanComputePipeline::destroy(g_pipeline, logicalDevice);
+    if (g_resultBuffer != VK_NULL_HANDLE) {
+        vkUnmapMemory(logicalDevice, g_resultMemory);
+        vkDestroyBuffer(logicalDevice, g_resultBuffer, nullptr);
+        vkFreeMemory(logicalDevice, g_resultMemory, nullptr);
+    }
+    g_resultBuffer = VK_NULL_HANDLE;
+    g_resultMemory = VK_NULL_HANDLE;
+    g_result = nullptr;
+    g_device = nullptr;
+}
+
+void VulkanMeshBounds::request(const Mesh2D& mesh) {
+    if (mesh.bindingData.len() == 0 || !ensureCreated()) return;
+
+    // The result buffer is shared, the previous job has to be done before it is reset.
+    wait();
+    *g_result = { INT_MAX, INT_MAX, INT_MIN, INT_MIN };
+
+    PushConstants pushConstants;
+    pushConstants.vertexCount = u32(mesh.bindingData.len());
+    pushConstants.floatsPerVertex = u32(sizeof(Mesh2D::MeshBindData) / sizeof(f32));
+
+    u32 groupCount = (pushConstants.vertexCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+    u32 maxGroupCount = g_device->physicalDeviceProps.limits.maxComputeWorkGroupCount[0];
+    if (groupCount > maxGroupCount) groupCount = maxGroupCount;
+
+    VulkanCompute::Dispatch dispatch;
+    dispatch.pipeline = &g_pipeline;
+    dispatch.storageBuffers[0] = mesh.vertexBuffer;
+    dispatch.storageBuffers[1] = g_resultBuffer;
+    dispatch.pushConstants = &pushConstants;
+    dispatch.groupCountX = groupCount;
+    dispatch.readBackOnHost = true;
+    g_pendingValue = VulkanCompute::submit(dispatch);
+}
+
+bool VulkanMeshBounds::poll(Bounds& out) {
+    if (g_pendingValue == 0 || !VulkanCompute::isDone(g_pendingValue)) return false;
+    g_pendingValue = 0;
+
+    out.minX = fromOrderedBits(g_result->minX);
+    out.minY = fromOrderedBits(g_result->minY);
+    out.maxX = fromOrderedBits(g_result->maxX);
+    out.maxY = fromOrderedBits(g_result->maxY);
+    return true;
+}
+
+void VulkanMeshBounds::wait() {
+    // The value stays pending, poll still reports the result.
+    VulkanCompute::wait(g_pendingValue);
+}
+
+namespace {
+
+bool ensureCreated() {
+    if (g_failed) return false;
+    if (g_resultBuffer != VK_NULL_HANDLE) return true;
+    Assert(g_device != nullptr, "Mesh bounds are not initialized");
+
+    VkDevice logicalDevice = g_device->logicalDevice;
+
+    VulkanComputePipeline::CreateFromFileInfo info;
+    info.shaderPath = g_shaderPath.len() > 0 ? g_shaderPath.view() : core::sv(SHADER_NAME);
+    info.storageBuffersCount = 2;
+    info.pushConstantsSize = sizeof(PushConstants);
+    auto res = g_shaderPath.len() > 0
+        ? VulkanComputePipeline::createFromFile(logicalDevice, info)
+        : VulkanComputePipeline::createFromSpirv(logicalDevice, EmbeddedShaders::find(SHADER_NAME), info);
+    if (res.hasErr()) {
+        AppError err = res.err();
+        logErrTagged(RENDERER_TAG, "Failed to create the mesh bounds pipeline, bounds are not computed: {}",
+                     err.toCStr());
+        g_failed = true;
+        return false;
+    }
+    g_pipeline = std::move(res.value());
+
+    // Written by the compute queue and read by the host only, so exclusive to the compute family.
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = sizeof(OrderedBounds);
+    bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    VK_MUST(vkCreateBuffer(logicalDevice, &bufferInfo, nullptr, &g_resultBuffer));
+
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(logicalDevice, g_resultBuffer, &memRequirements);
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = memRequirements.size;
+    if (!VulkanDevice::findMemoryType(*g_device, memRequirements.memoryTypeBits,
+                                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                      allocInfo.memoryTypeIndex)) {
+        Assert(false, "Failed to find memory type");
+    }
+    VK_MUST(vkAllocateMemory(logicalDevice, &allocInfo, nullptr, &g_resultMemory));
+    VK_MUST(vkBindBufferMemory(logicalDevice, g_resultBuffer, g_resultMemory, 0));
+
+    void* mapped;
+    VK_MUST(vkMapMemory(logicalDevice, g_resultMemory, 0, sizeof(OrderedBounds), 0, &mapped));
+    g_result = reinterpret_cast<OrderedBounds*>(mapped);
+
+    return true;
+}
+
+// Inverse of orderedBits in the shader.
+f32 fromOrderedBits(i32 bits) {
+    if (bits < 0) bits ^= 0x7FFFFFFF;
+    f32 ret;
+    core::memcopy(&ret, &bits, sizeof(ret));
+    return ret;
+}
+
+} // namespace
@@ -0,0 +1,343 @@
+#include <app_logger.h>
+#include <vulkan_renderer.h>
+#include <worker_pool.h>
+
+#include <atomic>
+
+namespace {
+
+using State = VulkanPipelineRegistry::State;
+
+enum struct VariantStatus : u8 {
+    COMPILING,
+    READY,
+    FAILED,
+};
+
+struct Variant {
+    u32 key = 0;
+    State state;
+    std::atomic<VariantStatus> status = VariantStatus::COMPILING;
+    VkPipeline pipeline = VK_NULL_HANDLE; // Written by the compile job before the status becomes READY.
+};
+
+VkDevice g_logicalDevice = VK_NULL_HANDLE;
+VkPipelineLayout g_layout = VK_NULL_HANDLE;
+VkRenderPass g_renderPass = VK_NULL_HANDLE;
+VkFormat g_colorFormat = VK_FORMAT_UNDEFINED;
+VkSampleCountFlagBits g_samples = VK_SAMPLE_COUNT_1_BIT;
+VkPipelineCache g_cache = VK_NULL_HANDLE;
+
+// Only changed on the render thread while no compile job is running.
+VkShaderModule g_vertexShaderModule = VK_NULL_HANDLE;
+VkShaderModule g_fragmentShaderModule = VK_NULL_HANDLE;
+VkPipeline g_base = VK_NULL_HANDLE;
+
+WorkerPool g_compilePool;
+bool g_poolStarted = false;
+
+// Entries are only added on the render thread, and never removed while a compile job might be writing to them.
+Variant g_variants[VulkanPipelineRegistry::MAX_VARIANTS];
+u32 g_variantsCount = 0;
+VkPipeline g_lastReturned = VK_NULL_HANDLE;
+
+VkPipeline createVariant(const State& state, VkShaderModule vertexShaderModule, VkShaderModule fragmentShaderModule,
+                         VkPipeline base);
+void compileJob(void* userData);
+void destroyVariants(VulkanDeletionQueue* retireTo);
+
+} // namespace
+
+VulkanPipelineRegistry::State VulkanPipelineRegistry::State::fromShadingMode(ShadingMode mode, bool fillModeNonSolid) {
+    State ret;
+    ret.shadingMode = mode;
+    switch (mode) {
+        case ShadingMode::WIREFRAME:
+            ret.polygonMode = fillModeNonSolid ? VK_POLYGON_MODE_LINE : VK_POLYGON_MODE_FILL;
+            ret.cullMode = VK_CULL_MODE_NONE; // The back edges are part of the wireframe.
+            break;
+        case ShadingMode::XRAY:
+            ret.cullMode = VK_CULL_MODE_NONE; // Every layer adds up.
+            ret.additiveBlend = true;
+            break;
+        case ShadingMode::SHADED:
+        case ShadingMode::NORMALS:
+        case ShadingMode::FACE_COLOR:
+        case ShadingMode::COUNT:
+            break;
+    }
+    return ret;
+}
+
+u32 VulkanPipelineRegistry::State::key() const {
+    // Every field takes a few bits, so equal keys mean equal states.
+    return u32(shadingMode) |
+           (u32(polygonMode) << 8) |
+           (u32(cullMode) << 12) |
+           (u32(additiveBlend) << 16);
+}
+
+void VulkanPipelineRegistry::init(VkDevice logicalDevice, VkPipelineLayout layout, VkRenderPass renderPass,
+                                  VkFormat colorFormat, VkSampleCountFlagBits samples, VkPipelineCache cache) {
+    g_logicalDevice = logicalDevice;
+    g_layout = layout;
+    g_renderPass = renderPass;
+    g_colorFormat = colorFormat;
+    g_samples = samples;
+    g_cache = cache;
+}
+
+void VulkanPipelineRegistry::shutdown() {
+    if (g_poolStarted) {
+        g_compilePool.shutdown();
+        g_poolStarted = false;
+    }
+    destroyVariants(nullptr);
+}
+
+VkPipeline VulkanPipelineRegistry::createBase(VkShaderModule vertexShaderModule, VkShaderModule fragmentShaderModule) {
+    return createVariant(State{}, vertexShaderModule, fragmentShaderModule, VK_NULL_HANDLE);
+}
+
+void VulkanPipelineRegistry::setShaders(VkShaderModule vertexShaderModule, VkShaderModule fragmentShaderModule,
+                                        VkPipeline base, VulkanDeletionQueue& retireTo) {
+    Assert(base != VK_NULL_HANDLE, "The base variant is required");
+
+    // Running jobs still use the previous modules and derive from the previous base.
+    if (g_poolStarted) g_compilePool.waitIdle();
+    destroyVariants(&retireTo);
+
+    g_vertexShaderModule = vertexShaderModule;
+    g_fragmentShaderModule = fragmentShaderModule;
+    g_base = base;
+
+    Variant& v = g_variants[g_variantsCount++];
+    v.state = State{};
+    v.key = v.state.key();
+    v.pipeline = base;
+    v.status.store(VariantStatus::READY, std::memory_order_release);
+    g_lastReturned = base;
+}
+
+VkPipeline VulkanPipelineRegistry::get(const State& state) {
+    u32 key = state.key();
+    for (u32 i = 0; i < g_variantsCount; i++) {
+        Variant& v = g_variants[i];
+        if (v.key != key) continue;
+        if (v.status.load(std::memory_order_acquire) == VariantStatus::READY) {
+            g_lastReturned = v.pipeline;
+        }
+        return g_lastReturned;
+    }
+
+    if (g_variantsCount >= MAX_VARIANTS) {
+        logErrTagged(RENDERER_TAG, "Too many pipeline variants, ignoring key={}", key);
+        return g_lastReturned;
+    }
+
+    if (!g_poolStarted) {
+        g_compilePool.init(COMPILE_THREADS);
+        g_poolStarted = true;
+    }
+
+    Variant& v = g_variants[g_variantsCount++];
+    v.key = key;
+    v.state = state;
+    v.pipeline = VK_NULL_HANDLE;
+    v.status.store(VariantStatus::COMPILING, std::memory_order_relaxed);
+    g_compilePool.submit(compileJob, &v);
+    logInfoTagged(RENDERER_TAG, "Compiling pipeline variant in the background (key={})", key);
+
+    return g_lastReturned;
+}
+
+namespace {
+
+VkPipeline createVariant(const State& state, VkShaderModule vertexShaderModule, VkShaderModule fragmentShaderModule,
+                         VkPipeline base) {
+    // Specialization constant 0 is the shading mode of the fragment shader.
+    i32 shadingMode = i32(state.shadingMode);
+    VkSpecializationMapEntry specializationEntry{};
+    specializationEntry.constantID = 0;
+    specializationEntry.offset = 0;
+    specializationEntry.size = sizeof(shadingMode);
+
+    VkSpecializationInfo specializationInfo{};
+    specializationInfo.mapEntryCount = 1;
+    specializationInfo.pMapEntries = &specializationEntry;
+    specializationInfo.dataSize = sizeof(shadingMode);
+    specializationInfo.pData = &shadingMode;
+
+    VkPipelineShaderStageCreateInfo fragShaderStageCreateInfo{};
+    fragShaderStageCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    fragShaderStageCreateInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    fragShaderStageCreateInfo.module = fragmentShaderModule;
+    fragShaderStageCreateInfo.pName = VulkanShader::SHADERS_ENTRY_FUNCTION;
+    fragShaderStageCreateInfo.pSpecializationInfo = &specializationInfo;
+
+    VkPipelineShaderStageCreateInfo vertShaderStageCreateInfo{};
+    vertShaderStageCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    vertShaderStageCreateInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
+    vertShaderStageCreateInfo.module = vertexShaderModule;
+    vertShaderStageCreateInfo.pName = VulkanShader::SHADERS_ENTRY_FUNCTION;
+
+    auto shaderStagesCreateInfo = core::createArrStatic(
+        vertShaderStageCreateInfo,
+        fragShaderStageCreateInfo
+    );
+
+    auto bindingDescription = Mesh2D::getBindingDescription();
+    auto attributeDescrption = Mesh2D::getAttributeDescriptions();
+
+    VkPipelineVertexInputStateCreateInfo vertexInputCreateInfo{};
+    vertexInputCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertexInputCreateInfo.vertexBindingDescriptionCount = 1;
+    vertexInputCreateInfo.pVertexBindingDescriptions = &bindingDescription;
+    vertexInputCreateInfo.vertexAttributeDescriptionCount = u32(attributeDescrption.len());
+    vertexInputCreateInfo.pVertexAttributeDescriptions = attributeDescrption.data();
+
+    // Create Dynamic state
+    VkDynamicState dynamicStates[] = {
+        VK_DYNAMIC_STATE_VIEWPORT,
+        VK_DYNAMIC_STATE_SCISSOR,
+    };
+    constexpr addr_size dynamicStatesLen = sizeof(dynamicStates) / sizeof(dynamicStates[0]);
+
+    VkPipelineDynamicStateCreateInfo dynamicStateCreateInfo{};
+    dynamicStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicStateCreateInfo.dynamicStateCount = dynamicStatesLen;
+    dynamicStateCreateInfo.pDynamicStates = dynamicStates;
+
+    // Create Input Assembly
+    VkPipelineInputAssemblyStateCreateInfo inputAssemblyCreateInfo{};
+    inputAssemblyCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssemblyCreateInfo.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    inputAssemblyCreateInfo.primitiveRestartEnable = VK_FALSE;
+
+    // Viewport and scissors are dynamic state, only the counts matter here.
+    VkPipelineViewportStateCreateInfo viewportStateCreateInfo{};
+    viewportStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportStateCreateInfo.viewportCount = 1;
+    viewportStateCreateInfo.pViewports = nullptr;
+    viewportStateCreateInfo.scissorCount = 1;
+    viewportStateCreateInfo.pScissors = nullptr;
+
+    // Create Rasterizer
+    VkPipelineRasterizationStateCreateInfo rasterizerCreateInfo{};
+    rasterizerCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizerCreateInfo.depthClampEnable = VK_FALSE;
+    rasterizerCreateInfo.rasterizerDiscardEnable = VK_FALSE;
+    rasterizerCreateInfo.polygonMode = state.polygonMode;
+    rasterizerCreateInfo.lineWidth = 1.0f;
+    rasterizerCreateInfo.cullMode = state.cullMode;
+    rasterizerCreateInfo.frontFace = VK_FRONT_FACE_CLOCKWISE;
+    rasterizerCreateInfo.depthBiasEnable = VK_FALSE;
+    rasterizerCreateInfo.depthBiasConstantFactor = 0.0f;
+    rasterizerCreateInfo.depthBiasClamp = 0.0f;
+    rasterizerCreateInfo.depthBiasSlopeFactor = 0.0f;
+
+    // Create Multisampler
+    VkPipelineMultisampleStateCreateInfo multisamplingCreateInfo{};
+    multisamplingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisamplingCreateInfo.sampleShadingEnable = VK_FALSE;
+    multisamplingCreateInfo.rasterizationSamples = g_samples;
+    multisamplingCreateInfo.minSampleShading = 1.0f;
+    multisamplingCreateInfo.pSampleMask = nullptr;
+    multisamplingCreateInfo.alphaToCoverageEnable = VK_FALSE;
+    multisamplingCreateInfo.alphaToOneEnable = VK_FALSE;
+
+    // Color Blending
+    VkPipelineColorBlendAttachmentState colorBlendAttachmentState{};
+    colorBlendAttachmentState.colorWriteMask = VK_COLOR_COMPONENT_R_BIT |
+                                               VK_COLOR_COMPONENT_G_BIT |
+                                               VK_COLOR_COMPONENT_B_BIT |
+                                               VK_COLOR_COMPONENT_A_BIT;
+    colorBlendAttachmentState.blendEnable = state.additiveBlend ? VK_TRUE : VK_FALSE;
+    colorBlendAttachmentState.srcColorBlendFactor = state.additiveBlend ? VK_BLEND_FACTOR_SRC_ALPHA : VK_BLEND_FACTOR_ONE;
+    colorBlendAttachmentState.dstColorBlendFactor = state.additiveBlend ? VK_BLEND_FACTOR_ONE : VK_BLEND_FACTOR_ZERO;
+    colorBlendAttachmentState.colorBlendOp = VK_BLEND_OP_ADD;
+    colorBlendAttachmentState.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    colorBlendAttachmentState.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+    colorBlendAttachmentState.alphaBlendOp = VK_BLEND_OP_ADD;
+
+    VkPipelineColorBlendStateCreateInfo colorBlendingCreateInfo{};
+    colorBlendingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    colorBlendingCreateInfo.logicOpEnable = VK_FALSE;
+    colorBlendingCreateInfo.logicOp = VK_LOGIC_OP_COPY;
+    colorBlendingCreateInfo.attachmentCount = 1;
+    colorBlendingCreateInfo.pAttachments = &colorBlendAttachmentState;
+    colorBlendingCreateInfo.blendConstants[0] = 0.0f;
+    colorBlendingCreateInfo.blendConstants[1] = 0.0f;
+    colorBlendingCreateInfo.blendConstants[2] = 0.0f;
+    colorBlendingCreateInfo.blendConstants[3] = 0.0f;
+
+    // Creating Graphics Pipeline
+    VkGraphicsPipelineCreateInfo pipelineCreateInfo{};
+    pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineCreateInfo.stageCount = u32(shaderStagesCreateInfo.len());
+    pipelineCreateInfo.pStages = shaderStagesCreateInfo.data();
+    pipelineCreateInfo.pVertexInputState = &vertexInputCreateInfo;
+    pipelineCreateInfo.pInputAssemblyState = &inputAssemblyCreateInfo;
+    pipelineCreateInfo.pViewportState = &viewportStateCreateInfo;
+    pipelineCreateInfo.pRasterizationState = &rasterizerCreateInfo;
+    pipelineCreateInfo.pMultisampleState = &multisamplingCreateInfo;
+    pipelineCreateInfo.pDepthStencilState = nullptr;
+    pipelineCreateInfo.pColorBlendState = &colorBlendingCreateInfo;
+    pipelineCreateInfo.pDynamicState = &dynamicStateCreateInfo;
+    pipelineCreateInfo.layout = g_layout;
+    pipelineCreateInfo.renderPass = g_renderPass;
+    pipelineCreateInfo.subpass = 0;
+    pipelineCreateInfo.basePipelineHandle = base;
+    pipelineCreateInfo.basePipelineIndex = -1;
+    pipelineCreateInfo.flags = base == VK_NULL_HANDLE ? VK_PIPELINE_CREATE_ALLOW_DERIVATIVES_BIT
+                                                      : VK_PIPELINE_CREATE_DERIVATIVE_BIT;
+
+    VkPipelineRenderingCreateInfoKHR renderingCreateInfo{};
+    if (g_renderPass == VK_NULL_HANDLE) {
+        renderingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+        renderingCreateInfo.colorAttachmentCount = 1;
+        renderingCreateInfo.pColorAttachmentFormats = &g_colorFormat;
+        pipelineCreateInfo.pNext = &renderingCreateInfo;
+    }
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    VkResult res = vkCreateGraphicsPipelines(g_logicalDevice,
+                                             g_cache,
+                                             1,
+                                             &pipelineCreateInfo,
+                                             nullptr,
+                                             &pipeline);
+    if (res != VK_SUCCESS) {
+        logErrTagged(RENDERER_TAG, "Failed to create graphics pipeline variant (key={}): {}", state.key(), i32(res));
+        return VK_NULL_HANDLE;
+    }
+    return pipeline;
+}
+
+void compileJob(void* userData) {
+    Variant& v = *reinterpret_cast<Variant*>(userData);
+    v.pipeline = createVariant(v.state, g_vertexShaderModule, g_fragmentShaderModule, g_base);
+    if (v.pipeline == VK_NULL_HANDLE) {
+        // Keeps drawing the fallback. Not retried, the same state would fail the same way.
+        v.status.store(VariantStatus::FAILED, std::memory_order_release);
+        return;
+    }
+    v.status.store(VariantStatus::READY, std::memory_order_release);
+    logInfoTagged(RENDERER_TAG, "Pipeline variant ready (key={})", v.key);
+}
+
+void destroyVariants(VulkanDeletionQueue* retireTo) {
+    // The base is one of the variants.
+    for (u32 i = 0; i < g_variantsCount; i++) {
+        Variant& v = g_variants[i];
+        if (v.pipeline == VK_NULL_HANDLE) continue;
+        if (retireTo) retireTo->pushPipeline(v.pipeline);
+        else          vkDestroyPipeline(g_logicalDevice, v.pipeline, nullptr);
+        v.pipeline = VK_NULL_HANDLE;
+    }
+    g_variantsCount = 0;
+    g_base = VK_NULL_HANDLE;
+    g_lastReturned = VK_NULL_HANDLE;
+}
+
+} // namespace
@@ -0,0 +1,137 @@
+#include <app_logger.h>
+#include <latency_tracker.h>
+#include <vulkan_renderer.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+struct PendingPresent {
+    VkSwapchainKHR swapchain;
+    u64 presentId;
+    u32 generation;
+};
+
+VkDevice g_logicalDevice = VK_NULL_HANDLE;
+PFN_vkWaitForPresentKHR g_waitForPresent = nullptr;
+std::thread g_thread;
+bool g_running = false;
+
+std::mutex g_queueMutex;
+std::condition_variable g_queueCv;
+PendingPresent g_pending[VulkanPresentWaiter::MAX_PENDING];
+u32 g_pendingHead = 0;
+u32 g_pendingCount = 0;
+bool g_stopping = false;
+
+// Held for the duration of every vkWaitForPresentKHR call. Bumping the generation under it guarantees that the retired
+// swapchain is not waited on anymore.
+std::mutex g_waitMutex;
+u32 g_generation = 0;
+
+void waiterLoop();
+
+} // namespace
+
+void VulkanPresentWaiter::start(const VulkanDevice& device) {
+    Assert(!g_running, "Present waiter is already running");
+
+    g_waitForPresent = reinterpret_cast<PFN_vkWaitForPresentKHR>(
+        vkGetDeviceProcAddr(device.logicalDevice, "vkWaitForPresentKHR"));
+    if (!g_waitForPresent) {
+        logWarnTagged(RENDERER_TAG, "vkWaitForPresentKHR is not available, present completion will not be measured");
+        return;
+    }
+
+    g_logicalDevice = device.logicalDevice;
+    g_stopping = false;
+    g_thread = std::thread(waiterLoop);
+    g_running = true;
+}
+
+void VulkanPresentWaiter::stop() {
+    if (!g_running) return;
+
+    {
+        std::lock_guard<std::mutex> lock(g_queueMutex);
+        g_stopping = true;
+    }
+    g_queueCv.notify_one();
+    g_thread.join();
+
+    g_pendingHead = 0;
+    g_pendingCount = 0;
+    g_running = false;
+}
+
+void VulkanPresentWaiter::enqueue(VkSwapchainKHR swapchain, u64 presentId) {
+    if (!g_running) return;
+
+    {
+        std::lock_guard<std::mutex> lock(g_queueMutex);
+        if (g_pendingCount == MAX_PENDING) {
+            // Never block the render thread. The tracker drops frames it never hears back about.
+            return;
+        }
+
+        u32 generation;
+        {
+            std::lock_guard<std::mutex> waitLock(g_waitMutex);
+            generation = g_generation;
+        }
+        g_pending[(g_pendingHead + g_pendingCount) % MAX_PENDING] = { swapchain, presentId, generation };
+        g_pendingCount++;
+    }
+    g_queueCv.notify_one();
+}
+
+void VulkanPresentWaiter::retireSwapchain() {
+    if (!g_running) return;
+
+    std::lock_guard<std::mutex> lock(g_waitMutex);
+    g_generation++;
+}
+
+namespace {
+
+void waiterLoop() {
+    while (true) {
+        PendingPresent next;
+        {
+            std::unique_lock<std::mutex> lock(g_queueMutex);
+            g_queueCv.wait(lock, [] { return g_stopping || g_pendingCount > 0; });
+            if (g_stopping) return;
+
+            next = g_pending[g_pendingHead];
+            g_pendingHead = (g_pendingHead + 1) % VulkanPresentWaiter::MAX_PENDING;
+            g_pendingCount--;
+        }
+
+        // Wait in short slices, so that retiring the swapchain and stopping never wait for a present that might not
+        // happen anymore.
+        while (true) {
+            VkResult vkres;
+            {
+                std::lock_guard<std::mutex> lock(g_waitMutex);
+                if (next.generation != g_generation) break;
+                vkres = g_waitForPresent(g_logicalDevice, next.swapchain, next.presentId,
+                                         VulkanPresentWaiter::WAIT_SLICE_NS);
+            }
+
+            if (vkres == VK_SUCCESS || vkres == VK_SUBOPTIMAL_KHR) {
+                LatencyTracker::framePresentCompleted(next.presentId, inputTimestampNs());
+                break;
+            }
+            if (vkres != VK_TIMEOUT) {
+                break; // Out of date or lost, the present will never complete.
+            }
+
+            std::lock_guard<std::mutex> lock(g_queueMutex);
+            if (g_stopping) return;
+        }
+    }
+}
+
+} // namespace
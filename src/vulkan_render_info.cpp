@@ -1,7 +1,7 @@
 #include <renderer.h>
 #include <vulkan_renderer.h>
 
-RendererInitInfo RendererInitInfo::create(const char* appName, bool vSyncOn) {
+RendererInitInfo RendererInitInfo::create(const char* appName, PacingMode pacingMode) {
 #if defined(STLV_DEBUG) && STLV_DEBUG == 1
     constexpr bool VALIDATION_LAYERS_ENABLED = true;
 #else
@@ -11,7 +11,7 @@ RendererInitInfo RendererInitInfo::create(const char* appName, bool vSyncOn) {
     RendererInitInfo info = {};
     info.appName = appName;
     info.backendType = RendererBackendType::VULKAN;
-    info.vSyncOn = vSyncOn;
+    info.pacingMode = pacingMode;
 
     // Instance Extensions
     {
@@ -50,7 +50,25 @@ RendererInitInfo RendererInitInfo::create(const char* appName, bool vSyncOn) {
             requiredDeviceExts,
             sizeof(requiredDeviceExts) / sizeof(requiredDeviceExts[0])
         };
-        info.backend.vk.optionalDeviceExtensions = {};
+
+        static const char* optionalDeviceExts[] = {
+            // Used by the latency measurement mode to learn when a frame actually reached the screen.
+            VK_KHR_PRESENT_ID_EXTENSION_NAME,
+            VK_KHR_PRESENT_WAIT_EXTENSION_NAME,
+            // Core in Vulkan 1.2. Without it frame synchronization falls back to fences.
+            VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME,
+            // Core in Vulkan 1.3, the rest are its dependencies on a 1.0 instance. Without it the renderer falls back to a
+            // render pass and a framebuffer per swapchain image.
+            VK_KHR_MULTIVIEW_EXTENSION_NAME,
+            VK_KHR_MAINTENANCE2_EXTENSION_NAME,
+            VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME,
+            VK_KHR_DEPTH_STENCIL_RESOLVE_EXTENSION_NAME,
+            VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME,
+        };
+        info.backend.vk.optionalDeviceExtensions = core::Memory<const char*> {
+            optionalDeviceExts,
+            sizeof(optionalDeviceExts) / sizeof(optionalDeviceExts[0])
+        };
     }
 
     // Layers
@@ -1,57 +1,200 @@
 #include <app_logger.h>
+#include <embedded_shaders.h>
+#include <latency_tracker.h>
+#include <memory_tracker.h>
 #include <platform.h>
 #include <renderer.h>
+#include <startup_timeline.h>
+#include <stl_loader.h>
 #include <vulkan_renderer.h>
 
+#include <mutex>
+#include <thread>
+
 namespace {
 
 VulkanContext g_vkctx;
 
+constexpr const char* MESH_VERTEX_SHADER = "mesh_shader.vert";
+constexpr const char* MESH_FRAGMENT_SHADER = "mesh_shader.frag";
+constexpr const char* MESH_BOUNDS_SHADER = "mesh_bounds.comp";
+constexpr const char* BUILD_SHADER_DIR = STLV_ASSETS "/shaders";
+
+// Empty when the embedded shaders are used.
+core::StrBuilder g_vertexShaderPath;
+core::StrBuilder g_fragmentShaderPath;
+core::StrBuilder g_meshBoundsShaderPath;
+
+// Startup work started by beginInit and joined by init.
+const RendererInitInfo* g_beginInitInfo = nullptr;
+std::thread g_instanceThread;
+std::thread g_shaderReadThread;
+VulkanDevice g_instanceOnlyDevice;
+core::ArrList<u8> g_prefetchedVertexShader;
+core::ArrList<u8> g_prefetchedFragmentShader;
+
+// Mesh submitted from a loader thread, picked up by the next frame.
+std::mutex g_pendingMeshMutex;
+Mesh2D g_pendingMesh;
+bool g_hasPendingMesh = false;
+
+// Loaded when the device supports dynamic rendering.
+PFN_vkCmdBeginRenderingKHR g_cmdBeginRendering = nullptr;
+PFN_vkCmdEndRenderingKHR g_cmdEndRendering = nullptr;
+
+// Shaders reloaded from another thread with their base pipeline, picked up by the next frame.
+std::mutex g_pendingShaderMutex;
+VulkanShader g_pendingShader;
+VkPipeline g_pendingBasePipeline = VK_NULL_HANDLE;
+
+void selectShaderSource(const RendererInitInfo& info);
+void buildShaderPath(core::StrBuilder& out, core::StrView dir, const char* name);
+
 // EXPERIMENTAL SECTION BEGIN
 void createRenderPipeline();
 void createFrameBuffers(core::Memory<VkFramebuffer> outFrameBuffers);
 void createCommandBuffers(core::Memory<VkCommandBuffer> cmdBuffers);
-void recordCommandBuffer(VkCommandBuffer cmdBuffer, VkFramebuffer frameBuffer);
+void recordCommandBuffer(VkCommandBuffer cmdBuffer, u32 imageIdx);
+void recordDraws(VkCommandBuffer cmdBuffer);
+void transitionColorImage(VkCommandBuffer cmdBuffer, VkImage image, bool toPresent);
 void createSemaphores(core::Memory<VkSemaphore> outSemaphores);
-void createFences(core::Memory<VkFence> outFences);
-void recreateSwapchain();
+void resizePerImageResources();
+VkSampleCountFlagBits pickSampleCount(u32 requested);
+void createMsaaTarget();
+void retireMsaaTarget(VulkanDeletionQueue& queue);
+bool recreateSwapchain();
 
 void createExampleScene();
+Mesh2D createMeshFromStl(const StlMesh& stlMesh);
+void createVertexBuffer(Mesh2D& mesh);
+u32 findMemoryType(u32 typeFilter, VkMemoryPropertyFlags properties);
+bool tryFindMemoryType(u32 typeFilter, VkMemoryPropertyFlags properties, u32& outIdx);
+void swapInPendingMesh();
+void swapInPendingShaders();
+VulkanDeletionQueue& lastSubmittedDeletionQueue();
 // EXPERIMENTAL SECTION END
 
 }
 
-core::expected<AppError> Renderer::init(const RendererInitInfo& info) {
+void Renderer::beginInit(const RendererInitInfo& info) {
     core::setLoggerTag(VULKAN_VALIDATION_TAG, appLogTagsToCStr(VULKAN_VALIDATION_TAG));
 
-    g_vkctx.device = core::Unpack(VulkanDevice::create(info), "Failed to create a device");
-    g_vkctx.swapchain = core::Unpack(VulkanSwapchain::create(g_vkctx));
+    // The instance does not depend on the window, and loading the driver is one of the slowest steps of startup.
+    g_beginInitInfo = &info;
+    g_instanceThread = std::thread([]() {
+        MemoryScope memScope (MemSubsystem::RENDERER);
+        StartupTimeline::Scope phase ("Vulkan instance");
+        g_instanceOnlyDevice = VulkanDevice::createInstance(*g_beginInitInfo);
+    });
+
+    // Embedded shaders need no I/O. A failed read leaves the list empty and init reads the file again, which reports
+    // the error.
+    selectShaderSource(info);
+    if (g_vertexShaderPath.len() > 0) {
+        g_shaderReadThread = std::thread([]() {
+            MemoryScope memScope (MemSubsystem::RENDERER);
+            StartupTimeline::Scope phase ("Read shader binaries");
+            [[maybe_unused]] auto vertRes = VulkanShaderStage::readFile(g_vertexShaderPath.view(),
+                                                                        g_prefetchedVertexShader);
+            [[maybe_unused]] auto fragRes = VulkanShaderStage::readFile(g_fragmentShaderPath.view(),
+                                                                        g_prefetchedFragmentShader);
+        });
+    }
+}
+
+void Renderer::abortInit() {
+    if (g_instanceThread.joinable()) g_instanceThread.join();
+    if (g_shaderReadThread.joinable()) g_shaderReadThread.join();
+    VulkanDevice::destroy(g_instanceOnlyDevice);
+    g_prefetchedVertexShader.free();
+    g_prefetchedFragmentShader.free();
+}
+
+core::expected<AppError> Renderer::init(const RendererInitInfo& info) {
+    if (g_instanceThread.joinable()) {
+        g_instanceThread.join();
+    }
+    else {
+        core::setLoggerTag(VULKAN_VALIDATION_TAG, appLogTagsToCStr(VULKAN_VALIDATION_TAG));
+        selectShaderSource(info);
+        StartupTimeline::Scope phase ("Vulkan instance");
+        g_instanceOnlyDevice = VulkanDevice::createInstance(info);
+    }
+
+    {
+        StartupTimeline::Scope phase ("Vulkan device and swapchain");
+        g_vkctx.device = core::Unpack(VulkanDevice::create(info, std::move(g_instanceOnlyDevice)),
+                                      "Failed to create a device");
+        g_vkctx.swapchain = core::Unpack(VulkanSwapchain::create(g_vkctx));
+    }
+
+    // Pipelines rebuilt at runtime (shader hot reload) start from what the first build left in the cache.
+    {
+        VkPipelineCacheCreateInfo pipelineCacheCreateInfo{};
+        pipelineCacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        VK_MUST(vkCreatePipelineCache(g_vkctx.device.logicalDevice, &pipelineCacheCreateInfo, nullptr,
+                                      &g_vkctx.pipelineCache));
+    }
+
+    // Command pools and descriptor pools are created on the first compute job, nothing runs compute at startup.
+    VulkanCompute::init(g_vkctx.device);
+    VulkanMeshBounds::init(g_vkctx.device, g_meshBoundsShaderPath.view());
 
     // Create example shader
     {
-        VulkanShader::CreateFromFileInfo shaderCreateInfo = {
-            core::sv(STLV_ASSETS "/shaders/mesh_shader.vert.spirv"),
-            core::sv(STLV_ASSETS "/shaders/mesh_shader.frag.spirv")
-        };
-        g_vkctx.shader = VulkanShader::createGraphicsShaderFromFile(shaderCreateInfo, g_vkctx);
+        if (g_shaderReadThread.joinable()) g_shaderReadThread.join();
+
+        StartupTimeline::Scope phase ("Shader modules");
+        if (g_vertexShaderPath.len() == 0) {
+            g_vkctx.shader = VulkanShader::createGraphicsShaderFromSpirv(EmbeddedShaders::find(MESH_VERTEX_SHADER),
+                                                                         EmbeddedShaders::find(MESH_FRAGMENT_SHADER),
+                                                                         g_vkctx);
+        }
+        else {
+            VulkanShader::CreateFromFileInfo shaderCreateInfo = {
+                g_vertexShaderPath.view(),
+                g_fragmentShaderPath.view()
+            };
+            shaderCreateInfo.vertexShaderBytes = &g_prefetchedVertexShader;
+            shaderCreateInfo.fragmentShaderBytes = &g_prefetchedFragmentShader;
+            g_vkctx.shader = VulkanShader::createGraphicsShaderFromFile(shaderCreateInfo, g_vkctx);
+            g_prefetchedVertexShader.free();
+            g_prefetchedFragmentShader.free();
+        }
     }
 
     // EXPERIMENTAL SECTION BEGIN
     {
-        u32 imageCount = u32(g_vkctx.swapchain.imageViews.len());
-        g_vkctx.maxFramesInFlight = imageCount;
-
+        // Independent of the swapchain image count. The images in flight values keep a frame from rendering to an
+        // image that an earlier frame is still rendering to.
+        u32 framesInFlight = info.framesInFlight;
+        if (framesInFlight < 1) framesInFlight = 1;
+        if (framesInFlight > VulkanContext::MAX_FRAMES_IN_FLIGHT) framesInFlight = VulkanContext::MAX_FRAMES_IN_FLIGHT;
+        g_vkctx.maxFramesInFlight = framesInFlight;
+        logInfoTagged(RENDERER_TAG, "Frames in flight: {}, swapchain images: {}",
+                      g_vkctx.maxFramesInFlight, g_vkctx.swapchain.images.len());
+
+        StartupTimeline::Scope phase ("Pipeline and frame resources");
+        if (g_vkctx.device.dynamicRenderingEnabled) {
+            g_cmdBeginRendering = reinterpret_cast<PFN_vkCmdBeginRenderingKHR>(
+                vkGetDeviceProcAddr(g_vkctx.device.logicalDevice, "vkCmdBeginRenderingKHR"));
+            g_cmdEndRendering = reinterpret_cast<PFN_vkCmdEndRenderingKHR>(
+                vkGetDeviceProcAddr(g_vkctx.device.logicalDevice, "vkCmdEndRenderingKHR"));
+            g_vkctx.useDynamicRendering = g_cmdBeginRendering && g_cmdEndRendering;
+        }
+        g_vkctx.msaaSamples = pickSampleCount(info.msaaSamples);
+        logInfoTagged(RENDERER_TAG, "MSAA: requested {}x, using {}x", info.msaaSamples, u32(g_vkctx.msaaSamples));
         createRenderPipeline();
-        g_vkctx.frameBuffers.replaceWith(VkFramebuffer{}, g_vkctx.maxFramesInFlight);
-        createFrameBuffers(g_vkctx.frameBuffers.mem());
         g_vkctx.cmdBuffers.replaceWith(VkCommandBuffer{}, g_vkctx.maxFramesInFlight);
         createCommandBuffers(g_vkctx.cmdBuffers.mem());
-        g_vkctx.inFlightFences.replaceWith(VkFence{}, g_vkctx.maxFramesInFlight);
-        createFences(g_vkctx.inFlightFences.mem());
+        g_vkctx.graphicsTimeline = VulkanTimeline::create(g_vkctx.device);
         g_vkctx.imageAvailableSemaphores.replaceWith(VkSemaphore{}, g_vkctx.maxFramesInFlight);
         createSemaphores(g_vkctx.imageAvailableSemaphores.mem());
-        g_vkctx.renderFinishedSemaphores.replaceWith(VkSemaphore{}, g_vkctx.maxFramesInFlight);
-        createSemaphores(g_vkctx.renderFinishedSemaphores.mem());
+        for (u32 i = 0; i < g_vkctx.maxFramesInFlight; i++) {
+            g_vkctx.frameArenas[i] = FrameArena::create();
+        }
+
+        resizePerImageResources();
     }
 
     // Prepare scene
@@ -59,6 +202,15 @@ core::expected<AppError> Renderer::init(const RendererInitInfo& info) {
         createExampleScene();
     }
 
+    if (LatencyTracker::isEnabled()) {
+        if (g_vkctx.device.presentWaitEnabled) {
+            VulkanPresentWaiter::start(g_vkctx.device);
+        }
+        else {
+            logWarnTagged(RENDERER_TAG, "Present wait is not supported, only the present call latency is measured");
+        }
+    }
+
     // EXPERIMENTAL SECTION END
 
     return {};
@@ -75,14 +227,35 @@ void Renderer::drawFrame() {
     auto& currentFrame = g_vkctx.currentFrame;
     auto& maxFramesInFlight = g_vkctx.maxFramesInFlight;
     auto& device = g_vkctx.device;
-    auto& inFlightFence = g_vkctx.inFlightFences[currentFrame];
+    auto& graphicsTimeline = g_vkctx.graphicsTimeline;
+    auto& frameTimelineValue = g_vkctx.frameTimelineValues[currentFrame];
     auto& imageAvailableSemaphore = g_vkctx.imageAvailableSemaphores[currentFrame];
-    auto& renderFinishedSemaphore = g_vkctx.renderFinishedSemaphores[currentFrame];
     auto& swapchain = g_vkctx.swapchain;
     auto& graphicsQueue = g_vkctx.device.graphicsQueue;
     auto& presentQueue = g_vkctx.device.presentQueue;
 
-    VK_MUST(vkWaitForFences(device.logicalDevice, 1, &inFlightFence, VK_TRUE, UINT64_MAX));
+    VulkanTimeline::wait(graphicsTimeline, frameTimelineValue);
+
+    VulkanDeletionQueue::flush(g_vkctx.deletionQueues[currentFrame], device.logicalDevice);
+    FrameArena::reset(g_vkctx.frameArenas[currentFrame]);
+    swapInPendingMesh();
+    swapInPendingShaders();
+
+    if (VulkanMeshBounds::Bounds bounds; VulkanMeshBounds::poll(bounds)) {
+        logInfoTagged(RENDERER_TAG, "Mesh bounds: min=({}, {}), max=({}, {})",
+                      f64(bounds.minX), f64(bounds.minY), f64(bounds.maxX), f64(bounds.maxY));
+    }
+
+    // Recreate at most once per frame, no matter how many resize events arrived since the last one.
+    if (g_vkctx.frameBufferResized || g_vkctx.swapchainOutOfDate || g_vkctx.presentModeChanged) {
+        g_vkctx.minimized = !recreateSwapchain();
+        if (g_vkctx.minimized) {
+            return; // Nothing to draw to, the application waits for window events before trying again.
+        }
+        g_vkctx.frameBufferResized = false;
+        g_vkctx.swapchainOutOfDate = false;
+        g_vkctx.presentModeChanged = false;
+    }
 
     // Acquire next image from swapchian
     u32 imageIdx;
@@ -94,40 +267,41 @@ void Renderer::drawFrame() {
                                                VK_NULL_HANDLE,
                                                &imageIdx);
 
-        if (vkres == VK_ERROR_OUT_OF_DATE_KHR || vkres == VK_SUBOPTIMAL_KHR || g_vkctx.frameBufferResized) {
-            g_vkctx.frameBufferResized = false;
-            recreateSwapchain();
+        if (vkres == VK_ERROR_OUT_OF_DATE_KHR) {
+            // The semaphore is not signaled in this case, so the frame can just be skipped.
+            g_vkctx.swapchainOutOfDate = true;
             return;
         }
-
-        Panic(vkres == VK_SUCCESS, "Failed to Acquire next image from swapchain.");
+        if (vkres == VK_SUBOPTIMAL_KHR) {
+            // The image was acquired and the semaphore will be signaled. The image is still presentable, so draw to it
+            // and recreate on the next frame.
+            g_vkctx.swapchainOutOfDate = true;
+        }
+        else {
+            Panic(vkres == VK_SUCCESS, "Failed to Acquire next image from swapchain.");
+        }
     }
 
-    VK_MUST(vkResetFences(device.logicalDevice, 1, &inFlightFence));
+    // With more images than frames in flight, or after a swapchain recreation, the acquired image can still be in use
+    // by a frame other than the one that last used this slot.
+    VulkanTimeline::wait(graphicsTimeline, g_vkctx.imagesInFlight[imageIdx]);
+
+    auto& renderFinishedSemaphore = g_vkctx.renderFinishedSemaphores[imageIdx];
 
     // Record Commands
     {
         auto& cmdBuffer = g_vkctx.cmdBuffers[currentFrame];
-        auto& frameBuffer = g_vkctx.frameBuffers[imageIdx];
         VK_MUST(vkResetCommandBuffer(cmdBuffer, 0));
-        recordCommandBuffer(cmdBuffer, frameBuffer);
-
-        VkSubmitInfo submitInfo{};
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        recordCommandBuffer(cmdBuffer, imageIdx);
 
-        VkSemaphore waitSemaphores[] = { imageAvailableSemaphore };
-        VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-        submitInfo.waitSemaphoreCount = 1;
-        submitInfo.pWaitSemaphores = waitSemaphores;
-        submitInfo.pWaitDstStageMask = waitStages;
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &cmdBuffer;
+        VulkanTimeline::Submit submit;
+        submit.cmdBuffer = cmdBuffer;
+        submit.waitBinary(imageAvailableSemaphore, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+        submit.signalBinary = renderFinishedSemaphore;
 
-        VkSemaphore signalSemaphores[] = { renderFinishedSemaphore };
-        submitInfo.signalSemaphoreCount = 1;
-        submitInfo.pSignalSemaphores = signalSemaphores;
-
-        VK_MUST(vkQueueSubmit(graphicsQueue.handle, 1, &submitInfo, inFlightFence));
+        frameTimelineValue = VulkanTimeline::submit(graphicsTimeline, graphicsQueue.handle, submit);
+        g_vkctx.imagesInFlight[imageIdx] = frameTimelineValue;
+        g_vkctx.lastSubmittedFrame = currentFrame;
     }
 
     // Present
@@ -148,36 +322,83 @@ void Renderer::drawFrame() {
         presentInfo.pImageIndices = &imageIdx;
         presentInfo.pResults = nullptr;
 
+        // Tag the present with an id, so the present wait thread can tell when it reached the screen.
+        u64 presentId = 0;
+        VkPresentIdKHR presentIdInfo{};
+        if (LatencyTracker::isEnabled() && device.presentWaitEnabled) {
+            presentId = ++g_vkctx.lastPresentId;
+            presentIdInfo.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+            presentIdInfo.swapchainCount = swapchainsLen;
+            presentIdInfo.pPresentIds = &presentId;
+            presentInfo.pNext = &presentIdInfo;
+        }
+
         VkResult vkres = vkQueuePresentKHR(presentQueue.handle, &presentInfo);
-        if (vkres == VK_ERROR_OUT_OF_DATE_KHR || vkres == VK_SUBOPTIMAL_KHR || g_vkctx.frameBufferResized) {
-            g_vkctx.frameBufferResized = false;
-            recreateSwapchain();
+        if (vkres == VK_ERROR_OUT_OF_DATE_KHR || vkres == VK_SUBOPTIMAL_KHR) {
+            g_vkctx.swapchainOutOfDate = true;
         }
         else {
             Panic(vkres == VK_SUCCESS, "Failed present image.");
         }
+
+        // An out of date present was discarded, its input is attributed to the next frame that makes it.
+        if (vkres != VK_ERROR_OUT_OF_DATE_KHR && LatencyTracker::framePresented(presentId)) {
+            VulkanPresentWaiter::enqueue(swapchain.handle, presentId);
+        }
+        if (vkres != VK_ERROR_OUT_OF_DATE_KHR) {
+            StartupTimeline::firstFramePresented();
+        }
     }
 
     currentFrame = (currentFrame + 1) % maxFramesInFlight;
 }
 
+bool Renderer::isMinimized() {
+    return g_vkctx.minimized;
+}
+
 void Renderer::resizeTarget(i32 width, i32 height) {
     logInfoTagged(RENDERER_TAG, "Window Resized to (w={}, h={})", width, height);
-    // TODO: I probably need to set this for Windows.
-    // g_vkctx.frameBufferResized = true;
+    // Not every platform reports VK_ERROR_OUT_OF_DATE_KHR on resize (e.g. Windows), so do not rely on it.
+    g_vkctx.frameBufferResized = true;
+}
+
+void Renderer::setShadingMode(ShadingMode mode) {
+    logInfoTagged(RENDERER_TAG, "Shading mode: {}", u32(mode));
+    g_vkctx.shadingMode = mode;
+}
+
+void Renderer::setPacingMode(PacingMode mode) {
+    g_vkctx.device.pacingMode = mode;
+    g_vkctx.presentModeChanged = true;
 }
 
 void Renderer::shutdown() {
+    VulkanPresentWaiter::stop();
     VK_MUST(vkDeviceWaitIdle(g_vkctx.device.logicalDevice));
+    VulkanMeshBounds::shutdown();
+    VulkanCompute::shutdown();
 
     // EXPERIMENTAL SECTION:
     {
         for (addr_size i =0; i < g_vkctx.meshes.len(); i++) {
             Mesh2D::destroy(g_vkctx.device, g_vkctx.meshes[i]);
         }
+        for (u32 i = 0; i < g_vkctx.maxFramesInFlight; i++) {
+            VulkanDeletionQueue::flush(g_vkctx.deletionQueues[i], g_vkctx.device.logicalDevice);
+            FrameArena::destroy(g_vkctx.frameArenas[i]);
+        }
+        if (g_hasPendingMesh) {
+            Mesh2D::destroy(g_vkctx.device, g_pendingMesh);
+            g_hasPendingMesh = false;
+        }
+        if (g_pendingBasePipeline != VK_NULL_HANDLE) {
+            vkDestroyPipeline(g_vkctx.device.logicalDevice, g_pendingBasePipeline, nullptr);
+            VulkanShader::destroy(g_pendingShader, g_vkctx.device.logicalDevice);
+            g_pendingBasePipeline = VK_NULL_HANDLE;
+        }
 
-        for (addr_size i = 0; i < g_vkctx.inFlightFences.len(); i++)
-            vkDestroyFence(g_vkctx.device.logicalDevice, g_vkctx.inFlightFences[i], nullptr);
+        VulkanTimeline::destroy(g_vkctx.graphicsTimeline);
         for (addr_size i = 0; i < g_vkctx.imageAvailableSemaphores.len(); i++)
             vkDestroySemaphore(g_vkctx.device.logicalDevice, g_vkctx.imageAvailableSemaphores[i], nullptr);
         for (addr_size i = 0; i < g_vkctx.renderFinishedSemaphores.len(); i++)
@@ -192,9 +413,14 @@ void Renderer::shutdown() {
         }
         g_vkctx.frameBuffers.clear();
 
-        if (g_vkctx.pipeline != VK_NULL_HANDLE) {
-            logInfoTagged(RENDERER_TAG, "Destroying VkPipeline");
-            vkDestroyPipeline(g_vkctx.device.logicalDevice, g_vkctx.pipeline, nullptr);
+        // Everything was waited for, so the queue can be flushed right away.
+        retireMsaaTarget(g_vkctx.deletionQueues[0]);
+        VulkanDeletionQueue::flush(g_vkctx.deletionQueues[0], g_vkctx.device.logicalDevice);
+
+        VulkanPipelineRegistry::shutdown();
+
+        if (g_vkctx.pipelineCache != VK_NULL_HANDLE) {
+            vkDestroyPipelineCache(g_vkctx.device.logicalDevice, g_vkctx.pipelineCache, nullptr);
         }
 
         if (g_vkctx.pipelineLayout != VK_NULL_HANDLE) {
@@ -214,47 +440,93 @@ void Renderer::shutdown() {
     VulkanDevice::destroy(g_vkctx.device);
 }
 
+void Renderer::submitMesh(const StlMesh& stlMesh) {
+    Mesh2D mesh = createMeshFromStl(stlMesh);
+    createVertexBuffer(mesh);
+
+    std::lock_guard<std::mutex> lock(g_pendingMeshMutex);
+    if (g_hasPendingMesh) {
+        // Replaced before any frame picked it up, so the GPU never used it.
+        Mesh2D::destroy(g_vkctx.device, g_pendingMesh);
+    }
+    g_pendingMesh = std::move(mesh);
+    g_hasPendingMesh = true;
+}
+
+core::expected<AppError> Renderer::submitShaders(core::StrView vertexShaderPath, core::StrView fragmentShaderPath) {
+    VkDevice logicalDevice = g_vkctx.device.logicalDevice;
+
+    auto vertexRes = VulkanShaderStage::createFromFile(logicalDevice, vertexShaderPath, VulkanShaderStage::VERTEX);
+    if (vertexRes.hasErr()) {
+        return core::unexpected(vertexRes.err());
+    }
+    VulkanShader shader;
+    shader.stages.push(std::move(vertexRes.value()));
+
+    auto fragmentRes = VulkanShaderStage::createFromFile(logicalDevice, fragmentShaderPath, VulkanShaderStage::FRAGMENT);
+    if (fragmentRes.hasErr()) {
+        VulkanShader::destroy(shader, logicalDevice);
+        return core::unexpected(fragmentRes.err());
+    }
+    shader.stages.push(std::move(fragmentRes.value()));
+
+    // Building the base here keeps the expensive part off the render thread. The registry keeps the modules for the
+    // variants it compiles later.
+    VkPipeline base = VulkanPipelineRegistry::createBase(shader.stages[0].shaderModule, shader.stages[1].shaderModule);
+    if (base == VK_NULL_HANDLE) {
+        VulkanShader::destroy(shader, logicalDevice);
+        return core::unexpected(createRendErr(RendererError::FAILED_TO_CREATE_VULKAN_GRAPHICS_PIPELINE));
+    }
+
+    std::lock_guard<std::mutex> lock(g_pendingShaderMutex);
+    if (g_pendingBasePipeline != VK_NULL_HANDLE) {
+        // Replaced before any frame picked it up, so the GPU never used it.
+        vkDestroyPipeline(logicalDevice, g_pendingBasePipeline, nullptr);
+        VulkanShader::destroy(g_pendingShader, logicalDevice);
+    }
+    g_pendingShader = std::move(shader);
+    g_pendingBasePipeline = base;
+    return {};
+}
+
 namespace {
 
+void selectShaderSource(const RendererInitInfo& info) {
+    g_vertexShaderPath.clear();
+    g_fragmentShaderPath.clear();
+    g_meshBoundsShaderPath.clear();
+
+    bool embedded = EmbeddedShaders::find(MESH_VERTEX_SHADER).len() > 0 &&
+                    EmbeddedShaders::find(MESH_FRAGMENT_SHADER).len() > 0;
+    if (embedded && !info.shaderDir) {
+        logInfoTagged(RENDERER_TAG, "Using the embedded shaders");
+        return;
+    }
+
+    // The override is for development, the shaders can be rebuilt without relinking the executable.
+    core::StrView dir = core::sv(info.shaderDir ? info.shaderDir : BUILD_SHADER_DIR);
+    buildShaderPath(g_vertexShaderPath, dir, MESH_VERTEX_SHADER);
+    buildShaderPath(g_fragmentShaderPath, dir, MESH_FRAGMENT_SHADER);
+    buildShaderPath(g_meshBoundsShaderPath, dir, MESH_BOUNDS_SHADER);
+    logInfoTagged(RENDERER_TAG, "Loading shaders from: {}", dir.data());
+}
+
+void buildShaderPath(core::StrBuilder& out, core::StrView dir, const char* name) {
+    out.clear();
+    out.append(dir);
+    out.append('/');
+    out.append(core::sv(name));
+    out.append(".spirv"_sv);
+}
+
 void createRenderPipeline() {
     auto& device = g_vkctx.device;
     auto& surface = g_vkctx.device.surface;
-    VkShaderModule vertexShaderModule = g_vkctx.shader.stages[0].shaderModule;
-    VkShaderModule fragmentShaderModule = g_vkctx.shader.stages[1].shaderModule;
     auto& pipelineLayout = g_vkctx.pipelineLayout;
     auto& renderPass = g_vkctx.renderPass;
-    auto& pipeline = g_vkctx.pipeline;
 
-    // Create Pipeline
+    // Create Pipeline Layout
     {
-        VkPipelineShaderStageCreateInfo fragShaderStageCreateInfo{};
-        fragShaderStageCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-        fragShaderStageCreateInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-        fragShaderStageCreateInfo.module = fragmentShaderModule;
-        fragShaderStageCreateInfo.pName = VulkanShader::SHADERS_ENTRY_FUNCTION;
-
-        VkPipelineShaderStageCreateInfo vertShaderStageCreateInfo{};
-        vertShaderStageCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-        vertShaderStageCreateInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-        vertShaderStageCreateInfo.module = vertexShaderModule;
-        vertShaderStageCreateInfo.pName = VulkanShader::SHADERS_ENTRY_FUNCTION;
-
-        auto shaderStagesCreateInfo = core::createArrStatic(
-            vertShaderStageCreateInfo,
-            fragShaderStageCreateInfo
-        );
-
-        // Create Pipeline Layout
-        auto bindingDescription = Mesh2D::getBindingDescription();
-        auto attributeDescrption = Mesh2D::getAttributeDescriptions();
-
-        VkPipelineVertexInputStateCreateInfo vertexInputCreateInfo{};
-        vertexInputCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-        vertexInputCreateInfo.vertexBindingDescriptionCount = 1;
-        vertexInputCreateInfo.pVertexBindingDescriptions = &bindingDescription;
-        vertexInputCreateInfo.vertexAttributeDescriptionCount = u32(attributeDescrption.len());
-        vertexInputCreateInfo.pVertexAttributeDescriptions = attributeDescrption.data();
-
         VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
         pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
         pipelineLayoutCreateInfo.setLayoutCount = 0;
@@ -267,168 +539,81 @@ void createRenderPipeline() {
                                     nullptr,
                                     &pipelineLayout));
         logInfoTagged(RENDERER_TAG, "Pipeline Layout created");
+    }
 
-        // Create Dynamic state
-        VkDynamicState dynamicStates[] = {
-            VK_DYNAMIC_STATE_VIEWPORT,
-            VK_DYNAMIC_STATE_SCISSOR,
-        };
-        constexpr addr_size dynamicStatesLen = sizeof(dynamicStates) / sizeof(dynamicStates[0]);
-
-        VkPipelineDynamicStateCreateInfo dynamicStateCreateInfo{};
-        dynamicStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-        dynamicStateCreateInfo.dynamicStateCount = dynamicStatesLen;
-        dynamicStateCreateInfo.pDynamicStates = dynamicStates;
-
-        // Create Input Assembly
-        VkPipelineInputAssemblyStateCreateInfo inputAssemblyCreateInfo{};
-        inputAssemblyCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-        inputAssemblyCreateInfo.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-        inputAssemblyCreateInfo.primitiveRestartEnable = VK_FALSE;
-
-        // Create Viewports and scissors
-        VkViewport viewport{};
-        viewport.x = 0.0f;
-        viewport.y = 0.0f;
-        viewport.width = f32(surface.capabilities.extent.width);
-        viewport.height = f32(surface.capabilities.extent.height);
-        viewport.minDepth = 0.0f;
-        viewport.maxDepth = 1.0f;
-
-        VkRect2D scissors{};
-        scissors.offset = {0, 0};
-        scissors.extent = surface.capabilities.extent;
-
-        VkPipelineViewportStateCreateInfo viewportStateCreateInfo{};
-        viewportStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-        viewportStateCreateInfo.viewportCount = 1;
-        viewportStateCreateInfo.pViewports = &viewport;
-        viewportStateCreateInfo.scissorCount = 1;
-        viewportStateCreateInfo.pScissors = &scissors;
-
-        // Create Rasterizer
-        VkPipelineRasterizationStateCreateInfo rasterizerCreateInfo{};
-        rasterizerCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-        rasterizerCreateInfo.depthClampEnable = VK_FALSE;
-        rasterizerCreateInfo.rasterizerDiscardEnable = VK_FALSE;
-        rasterizerCreateInfo.polygonMode = VK_POLYGON_MODE_FILL;
-        rasterizerCreateInfo.lineWidth = 1.0f;
-        rasterizerCreateInfo.cullMode = VK_CULL_MODE_BACK_BIT;
-        rasterizerCreateInfo.frontFace = VK_FRONT_FACE_CLOCKWISE;
-        rasterizerCreateInfo.depthBiasEnable = VK_FALSE;
-        rasterizerCreateInfo.depthBiasConstantFactor = 0.0f;
-        rasterizerCreateInfo.depthBiasClamp = 0.0f;
-        rasterizerCreateInfo.depthBiasSlopeFactor = 0.0f;
-
-        // Create Multisampler
-        VkPipelineMultisampleStateCreateInfo multisamplingCreateInfo{};
-        multisamplingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-        multisamplingCreateInfo.sampleShadingEnable = VK_FALSE;
-        multisamplingCreateInfo.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-        multisamplingCreateInfo.minSampleShading = 1.0f;
-        multisamplingCreateInfo.pSampleMask = nullptr;
-        multisamplingCreateInfo.alphaToCoverageEnable = VK_FALSE;
-        multisamplingCreateInfo.alphaToOneEnable = VK_FALSE;
-
-        // Color Blending
-        VkPipelineColorBlendAttachmentState colorBlendAttachmentState{};
-        colorBlendAttachmentState.colorWriteMask = VK_COLOR_COMPONENT_R_BIT |
-                                                   VK_COLOR_COMPONENT_G_BIT |
-                                                   VK_COLOR_COMPONENT_B_BIT |
-                                                   VK_COLOR_COMPONENT_A_BIT;
-        colorBlendAttachmentState.blendEnable = VK_FALSE;
-        colorBlendAttachmentState.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
-        colorBlendAttachmentState.dstColorBlendFactor = VK_BLEND_FACTOR_ZERO;
-        colorBlendAttachmentState.colorBlendOp = VK_BLEND_OP_ADD;
-        colorBlendAttachmentState.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
-        colorBlendAttachmentState.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
-        colorBlendAttachmentState.alphaBlendOp = VK_BLEND_OP_ADD;
-
-        VkPipelineColorBlendStateCreateInfo colorBlendingCreateInfo{};
-        colorBlendingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-        colorBlendingCreateInfo.logicOpEnable = VK_FALSE;
-        colorBlendingCreateInfo.logicOp = VK_LOGIC_OP_COPY;
-        colorBlendingCreateInfo.attachmentCount = 1;
-        colorBlendingCreateInfo.pAttachments = &colorBlendAttachmentState;
-        colorBlendingCreateInfo.blendConstants[0] = 0.0f;
-        colorBlendingCreateInfo.blendConstants[1] = 0.0f;
-        colorBlendingCreateInfo.blendConstants[2] = 0.0f;
-        colorBlendingCreateInfo.blendConstants[3] = 0.0f;
-
-        // Creating Render Pass
-        {
-            VkAttachmentDescription colorAttachment{};
-            colorAttachment.format = surface.capabilities.format.format;
-            colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-            colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-            colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-            colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-            colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-            colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-            colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-            VkAttachmentReference colorAttachmentRef{};
-            colorAttachmentRef.attachment = 0; // array consists of a single VkAttachmentDescription, so its index is 0.
-            colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-            VkSubpassDescription subpass{};
-            subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-            subpass.colorAttachmentCount = 1;
-            subpass.pColorAttachments = &colorAttachmentRef;
-
-            VkRenderPassCreateInfo renderPassCreateInfo{};
-            renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-            renderPassCreateInfo.attachmentCount = 1;
-            renderPassCreateInfo.pAttachments = &colorAttachment;
-            renderPassCreateInfo.subpassCount = 1;
-            renderPassCreateInfo.pSubpasses = &subpass;
-
-            VkSubpassDependency dependency{};
-            dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-            dependency.dstSubpass = 0;
-            dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-            dependency.srcAccessMask = 0;
-            dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-            dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-
-            renderPassCreateInfo.dependencyCount = 1;
-            renderPassCreateInfo.pDependencies = &dependency;
-
-            VK_MUST(vkCreateRenderPass(device.logicalDevice,
-                                       &renderPassCreateInfo,
-                                       nullptr,
-                                       &renderPass));
-            logInfoTagged(RENDERER_TAG, "Render Pass created");
+    // Creating Render Pass, dynamic rendering does without one
+    if (!g_vkctx.useDynamicRendering) {
+        bool msaa = g_vkctx.msaaSamples != VK_SAMPLE_COUNT_1_BIT;
+
+        VkAttachmentDescription colorAttachment{};
+        colorAttachment.format = surface.capabilities.format.format;
+        colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+        colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+        // With MSAA the pass renders to the multisampled image and resolves into the swapchain image at the end of the
+        // subpass. The samples are never stored, on a tiler they do not leave tile memory.
+        VkAttachmentDescription attachments[2] = { colorAttachment, colorAttachment };
+        if (msaa) {
+            attachments[0].samples = g_vkctx.msaaSamples;
+            attachments[0].storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+            attachments[0].finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            attachments[1].loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE; // Fully overwritten by the resolve.
         }
 
-        // Creating Graphics Pipeline
-        VkGraphicsPipelineCreateInfo pipelineCreateInfo{};
-        pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-        pipelineCreateInfo.stageCount = u32(shaderStagesCreateInfo.len());
-        pipelineCreateInfo.pStages = shaderStagesCreateInfo.data();
-        pipelineCreateInfo.pVertexInputState = &vertexInputCreateInfo;
-        pipelineCreateInfo.pInputAssemblyState = &inputAssemblyCreateInfo;
-        pipelineCreateInfo.pViewportState = &viewportStateCreateInfo;
-        pipelineCreateInfo.pRasterizationState = &rasterizerCreateInfo;
-        pipelineCreateInfo.pMultisampleState = &multisamplingCreateInfo;
-        pipelineCreateInfo.pDepthStencilState = nullptr;
-        pipelineCreateInfo.pColorBlendState = &colorBlendingCreateInfo;
-        pipelineCreateInfo.pDynamicState = &dynamicStateCreateInfo;
-        pipelineCreateInfo.layout = pipelineLayout;
-        pipelineCreateInfo.renderPass = renderPass;
-        pipelineCreateInfo.subpass = 0;
-        pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
-        pipelineCreateInfo.basePipelineIndex = -1;
-
-        VK_MUST(vkCreateGraphicsPipelines(device.logicalDevice,
-                                          VK_NULL_HANDLE,
-                                          1,
-                                          &pipelineCreateInfo,
-                                          nullptr,
-                                          &pipeline));
-
-        logInfoTagged(RENDERER_TAG, "Graphics Pipeline created");
+        VkAttachmentReference colorAttachmentRef{};
+        colorAttachmentRef.attachment = 0;
+        colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        VkAttachmentReference resolveAttachmentRef{};
+        resolveAttachmentRef.attachment = 1;
+        resolveAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+        VkSubpassDescription subpass{};
+        subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpass.colorAttachmentCount = 1;
+        subpass.pColorAttachments = &colorAttachmentRef;
+        subpass.pResolveAttachments = msaa ? &resolveAttachmentRef : nullptr;
+
+        VkRenderPassCreateInfo renderPassCreateInfo{};
+        renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        renderPassCreateInfo.attachmentCount = msaa ? 2 : 1;
+        renderPassCreateInfo.pAttachments = attachments;
+        renderPassCreateInfo.subpassCount = 1;
+        renderPassCreateInfo.pSubpasses = &subpass;
+
+        VkSubpassDependency dependency{};
+        dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+        dependency.dstSubpass = 0;
+        dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        // The multisampled image is shared by the frames in flight, the previous frame's writes to it have to finish.
+        dependency.srcAccessMask = msaa ? VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT : 0;
+        dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+        renderPassCreateInfo.dependencyCount = 1;
+        renderPassCreateInfo.pDependencies = &dependency;
+
+        VK_MUST(vkCreateRenderPass(device.logicalDevice,
+                                   &renderPassCreateInfo,
+                                   nullptr,
+                                   &renderPass));
+        logInfoTagged(RENDERER_TAG, "Render Pass created");
     }
+
+    // The other variants are compiled on first use.
+    VulkanPipelineRegistry::init(device.logicalDevice, pipelineLayout, renderPass, surface.capabilities.format.format,
+                                 g_vkctx.msaaSamples, g_vkctx.pipelineCache);
+    VkShaderModule vertexShaderModule = g_vkctx.shader.stages[0].shaderModule;
+    VkShaderModule fragmentShaderModule = g_vkctx.shader.stages[1].shaderModule;
+    VkPipeline base = VulkanPipelineRegistry::createBase(vertexShaderModule, fragmentShaderModule);
+    Panic(base != VK_NULL_HANDLE, "Failed to create the graphics pipeline");
+    VulkanPipelineRegistry::setShaders(vertexShaderModule, fragmentShaderModule, base, lastSubmittedDeletionQueue());
+    logInfoTagged(RENDERER_TAG, "Graphics Pipeline created");
 }
 
 void createFrameBuffers(core::Memory<VkFramebuffer> outFrameBuffers) {
@@ -440,14 +625,17 @@ void createFrameBuffers(core::Memory<VkFramebuffer> outFrameBuffers) {
     Assert(outFrameBuffers.len() == swapchain.imageViews.len(), "Sanity check failed");
 
     for (size_t i = 0; i < swapchain.imageViews.len(); i++) {
+        // Same order as the render pass attachments.
+        bool msaa = g_vkctx.msaaColorView != VK_NULL_HANDLE;
         VkImageView attachments[] = {
-            swapchain.imageViews[i]
+            msaa ? g_vkctx.msaaColorView : swapchain.imageViews[i],
+            swapchain.imageViews[i],
         };
 
         VkFramebufferCreateInfo framebufferInfo{};
         framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
         framebufferInfo.renderPass = renderPass;
-        framebufferInfo.attachmentCount = 1;
+        framebufferInfo.attachmentCount = msaa ? 2 : 1;
         framebufferInfo.pAttachments = attachments;
         framebufferInfo.width = surface.capabilities.extent.width;
         framebufferInfo.height = surface.capabilities.extent.height;
@@ -477,11 +665,9 @@ void createCommandBuffers(core::Memory<VkCommandBuffer> cmdBuffers) {
     VK_MUST(vkAllocateCommandBuffers(device.logicalDevice, &allocInfo, cmdBuffers.data()));
 }
 
-void recordCommandBuffer(VkCommandBuffer cmdBuffer, VkFramebuffer frameBuffer) {
+void recordCommandBuffer(VkCommandBuffer cmdBuffer, u32 imageIdx) {
     auto& renderPass = g_vkctx.renderPass;
-    auto& graphicsPipeline = g_vkctx.pipeline;
     auto& surface = g_vkctx.device.surface;
-    auto& meshes = g_vkctx.meshes;
 
     VkCommandBufferBeginInfo beginInfo{};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -490,53 +676,127 @@ void recordCommandBuffer(VkCommandBuffer cmdBuffer, VkFramebuffer frameBuffer) {
 
     VK_MUST(vkBeginCommandBuffer(cmdBuffer, &beginInfo));
 
-    VkRenderPassBeginInfo renderPassInfo{};
-    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    renderPassInfo.renderPass = renderPass;
-    renderPassInfo.framebuffer = frameBuffer;
-    renderPassInfo.renderArea.offset = {0, 0};
-    renderPassInfo.renderArea.extent = surface.capabilities.extent;
-
     VkClearValue clearValue{};
     clearValue.color = { { 0.3f, 0.6f, 0.9f, 1.0f } };
 
-    renderPassInfo.clearValueCount = 1;
-    renderPassInfo.pClearValues = &clearValue;
+    if (g_vkctx.useDynamicRendering) {
+        // The layout transitions the render pass did are explicit here.
+        VkImage image = g_vkctx.swapchain.images[imageIdx];
+        VkImageView imageView = g_vkctx.swapchain.imageViews[imageIdx];
+        bool msaa = g_vkctx.msaaColorImage != VK_NULL_HANDLE;
+        transitionColorImage(cmdBuffer, image, false);
+        if (msaa) transitionColorImage(cmdBuffer, g_vkctx.msaaColorImage, false);
+
+        VkRenderingAttachmentInfoKHR colorAttachment{};
+        colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+        colorAttachment.imageView = msaa ? g_vkctx.msaaColorView : imageView;
+        colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        colorAttachment.storeOp = msaa ? VK_ATTACHMENT_STORE_OP_DONT_CARE : VK_ATTACHMENT_STORE_OP_STORE;
+        colorAttachment.clearValue = clearValue;
+        if (msaa) {
+            colorAttachment.resolveMode = VK_RESOLVE_MODE_AVERAGE_BIT_KHR;
+            colorAttachment.resolveImageView = imageView;
+            colorAttachment.resolveImageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        }
+
+        VkRenderingInfoKHR renderingInfo{};
+        renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+        renderingInfo.renderArea.offset = {0, 0};
+        renderingInfo.renderArea.extent = surface.capabilities.extent;
+        renderingInfo.layerCount = 1;
+        renderingInfo.colorAttachmentCount = 1;
+        renderingInfo.pColorAttachments = &colorAttachment;
+
+        g_cmdBeginRendering(cmdBuffer, &renderingInfo);
+        recordDraws(cmdBuffer);
+        g_cmdEndRendering(cmdBuffer);
+
+        transitionColorImage(cmdBuffer, image, true);
+    }
+    else {
+        VkRenderPassBeginInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassInfo.renderPass = renderPass;
+        renderPassInfo.framebuffer = g_vkctx.frameBuffers[imageIdx];
+        renderPassInfo.renderArea.offset = {0, 0};
+        renderPassInfo.renderArea.extent = surface.capabilities.extent;
+        renderPassInfo.clearValueCount = 1;
+        renderPassInfo.pClearValues = &clearValue;
 
-    // Begin Render Pass
-    {
         vkCmdBeginRenderPass(cmdBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-        defer { vkCmdEndRenderPass(cmdBuffer); };
-
-        vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
-
-        VkViewport viewport{};
-        viewport.x = 0.0f;
-        viewport.y = 0.0f;
-        viewport.width = f32(surface.capabilities.extent.width);
-        viewport.height = f32(surface.capabilities.extent.height);
-        viewport.minDepth = 0.0f;
-        viewport.maxDepth = 1.0f;
-        vkCmdSetViewport(cmdBuffer, 0, 1, &viewport);
-
-        VkRect2D scissor{};
-        scissor.offset = {0, 0};
-        scissor.extent = surface.capabilities.extent;
-        vkCmdSetScissor(cmdBuffer, 0, 1, &scissor);
-
-        // TODO: record all vertices with one command in bulk.
-        for (addr_size i = 0; i < meshes.len(); i++) {
-            VkBuffer vertexBuffers[] = { meshes[i].vertexBuffer };
-            VkDeviceSize offsets[] = {0};
-
-            vkCmdBindVertexBuffers(cmdBuffer, 0, 1, vertexBuffers, offsets);
-            vkCmdDraw(cmdBuffer, u32(meshes[i].vertexByteSize()), 1, 0, 0);
-        }
+        recordDraws(cmdBuffer);
+        vkCmdEndRenderPass(cmdBuffer);
     }
 
     VK_MUST(vkEndCommandBuffer(cmdBuffer));
 }
 
+void recordDraws(VkCommandBuffer cmdBuffer) {
+    auto& surface = g_vkctx.device.surface;
+    auto& meshes = g_vkctx.meshes;
+
+    VkPipeline graphicsPipeline = VulkanPipelineRegistry::get(
+        VulkanPipelineRegistry::State::fromShadingMode(g_vkctx.shadingMode, g_vkctx.device.fillModeNonSolidEnabled));
+    vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
+
+    VkViewport viewport{};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = f32(surface.capabilities.extent.width);
+    viewport.height = f32(surface.capabilities.extent.height);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(cmdBuffer, 0, 1, &viewport);
+
+    VkRect2D scissor{};
+    scissor.offset = {0, 0};
+    scissor.extent = surface.capabilities.extent;
+    vkCmdSetScissor(cmdBuffer, 0, 1, &scissor);
+
+    // TODO: record all vertices with one command in bulk.
+    for (addr_size i = 0; i < meshes.len(); i++) {
+        VkBuffer vertexBuffers[] = { meshes[i].vertexBuffer };
+        VkDeviceSize offsets[] = {0};
+
+        vkCmdBindVertexBuffers(cmdBuffer, 0, 1, vertexBuffers, offsets);
+        vkCmdDraw(cmdBuffer, u32(meshes[i].vertexCount()), 1, 0, 0);
+    }
+}
+
+void transitionColorImage(VkCommandBuffer cmdBuffer, VkImage image, bool toPresent) {
+    // Same synchronization as the render pass's external dependency. The acquire semaphore is waited for at the color
+    // attachment output stage, so the transition to the attachment layout has to happen in that stage too.
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.layerCount = 1;
+
+    VkPipelineStageFlags srcStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    VkPipelineStageFlags dstStage;
+    if (toPresent) {
+        barrier.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barrier.dstAccessMask = 0;
+        dstStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+    }
+    else {
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED; // Cleared anyway.
+        barrier.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        // The multisampled image is shared by the frames in flight, the previous frame's writes to it have to finish.
+        barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        dstStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    }
+
+    vkCmdPipelineBarrier(cmdBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
 void createSemaphores(core::Memory<VkSemaphore> outSemaphores) {
     auto& device = g_vkctx.device;
 
@@ -547,51 +807,146 @@ void createSemaphores(core::Memory<VkSemaphore> outSemaphores) {
     }
 }
 
-void createFences(core::Memory<VkFence> outFences) {
-    auto& device = g_vkctx.device;
-
-    VkFenceCreateInfo fenceCreateInfo{};
-    fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-    for (addr_size i = 0; i < outFences.len(); i++) {
-        VK_MUST(vkCreateFence(device.logicalDevice, &fenceCreateInfo, nullptr, &outFences[i]));
-    }
-}
+bool recreateSwapchain() {
+    MemoryTracker::restartSteadyState();
 
-void recreateSwapchain() {
     auto& device = g_vkctx.device;
     auto& swapchain = g_vkctx.swapchain;
     auto& surface = g_vkctx.device.surface;
-    bool vSyncOn = device.vSyncOn;
 
-    VK_MUST(vkDeviceWaitIdle(device.logicalDevice));
+    // No waiting for the device here. Frames in flight keep using the old swapchain, framebuffers and image views,
+    // which are destroyed once those frames have finished.
+    // NOTE: Timeline values do not cover the present operation itself. Without VK_EXT_swapchain_maintenance1 there is no
+    //       way to know when it is done, but by the time the frame slot comes around again it has been in practice.
 
-    // Destroy
+    // Only the extent and transform change on resize, there is no need to query formats and present modes again.
+    VulkanSurface::refreshCapabilities(surface, device.physicalDevice);
+    if (g_vkctx.presentModeChanged) {
+        VulkanSurface::refreshPresentMode(surface, device.physicalDevice, device.pacingMode,
+                                          g_vkctx.frameArenas[g_vkctx.currentFrame]);
+    }
+    if (surface.capabilities.extent.width == 0 || surface.capabilities.extent.height == 0) {
+        return false;
+    }
+
+    // Create the new swapchain from the old one, the surface can only have a single non-retired swapchain.
+    VulkanPresentWaiter::retireSwapchain();
+    VulkanSwapchain newSwapchain = core::Unpack(VulkanSwapchain::create(g_vkctx, &swapchain));
+
+    // Retire
     {
+        VulkanDeletionQueue& deletionQueue = lastSubmittedDeletionQueue();
         for (addr_size i = 0; i < g_vkctx.frameBuffers.len(); i++) {
-            vkDestroyFramebuffer(g_vkctx.device.logicalDevice, g_vkctx.frameBuffers[i], nullptr);
+            deletionQueue.pushFramebuffer(g_vkctx.frameBuffers[i]);
         }
-        g_vkctx.frameBuffers.replaceWith(VkFramebuffer{}, g_vkctx.frameBuffers.len());
-        VulkanSwapchain::destroy(swapchain, device);
+        retireMsaaTarget(deletionQueue);
+        VulkanSwapchain::retire(swapchain, deletionQueue);
     }
 
-    // Query Surface Capabilities
+    // Create
     {
-        VulkanSurface::Capabilities capabilities = VulkanSurface::queryCapabilities(surface, device.physicalDevice);
-        surface.capabilities = core::Unpack(VulkanSurface::pickCapabilities(capabilities, vSyncOn),
-                                            "Failed to query for new surface capabilities");
+        swapchain = std::move(newSwapchain);
+        resizePerImageResources();
     }
 
-    // Create
-    {
-        swapchain = core::Unpack(VulkanSwapchain::create(g_vkctx));
+    return true;
+}
+
+void resizePerImageResources() {
+    auto& device = g_vkctx.device;
+    addr_size imageCount = g_vkctx.swapchain.imageViews.len();
+
+    if (g_vkctx.msaaSamples != VK_SAMPLE_COUNT_1_BIT) {
+        createMsaaTarget();
+    }
+    if (!g_vkctx.useDynamicRendering) {
+        g_vkctx.frameBuffers.replaceWith(VkFramebuffer{}, imageCount);
         createFrameBuffers(g_vkctx.frameBuffers.mem());
     }
+
+    // The new images have not been rendered to by any frame.
+    g_vkctx.imagesInFlight.replaceWith(0, imageCount);
+
+    // Semaphores are only ever added. A present of the old swapchain might still be waiting on an existing one, and it
+    // is not signaled again before its image index is acquired again.
+    // NOTE: Same as with the retired swapchain, nothing tracks when that present is done, see recreateSwapchain.
+    VkSemaphoreCreateInfo semaphoreCreateInfo{};
+    semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    while (g_vkctx.renderFinishedSemaphores.len() < imageCount) {
+        VkSemaphore semaphore;
+        VK_MUST(vkCreateSemaphore(device.logicalDevice, &semaphoreCreateInfo, nullptr, &semaphore));
+        g_vkctx.renderFinishedSemaphores.push(semaphore);
+    }
+}
+
+VkSampleCountFlagBits pickSampleCount(u32 requested) {
+    // The highest supported count that is not above the requested one. 1 is always supported.
+    VkSampleCountFlags supported = g_vkctx.device.physicalDeviceProps.limits.framebufferColorSampleCounts;
+    for (u32 samples = 64; samples > 1; samples >>= 1) {
+        if (samples <= requested && (supported & samples)) {
+            return VkSampleCountFlagBits(samples);
+        }
+    }
+    return VK_SAMPLE_COUNT_1_BIT;
+}
+
+void createMsaaTarget() {
+    auto& device = g_vkctx.device;
+    auto& surface = g_vkctx.device.surface;
+
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = surface.capabilities.format.format;
+    imageInfo.extent = { surface.capabilities.extent.width, surface.capabilities.extent.height, 1 };
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = g_vkctx.msaaSamples;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    VK_MUST(vkCreateImage(device.logicalDevice, &imageInfo, nullptr, &g_vkctx.msaaColorImage));
+
+    VkMemoryRequirements memRequirements;
+    vkGetImageMemoryRequirements(device.logicalDevice, g_vkctx.msaaColorImage, &memRequirements);
+
+    // Lazily allocated memory is only committed if the image ever has to leave tile memory. Desktop GPUs do not have
+    // it and get plain device memory.
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = memRequirements.size;
+    if (!tryFindMemoryType(memRequirements.memoryTypeBits,
+                           VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT,
+                           allocInfo.memoryTypeIndex)) {
+        allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    }
+    VK_MUST(vkAllocateMemory(device.logicalDevice, &allocInfo, nullptr, &g_vkctx.msaaColorMemory));
+    VK_MUST(vkBindImageMemory(device.logicalDevice, g_vkctx.msaaColorImage, g_vkctx.msaaColorMemory, 0));
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = g_vkctx.msaaColorImage;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = imageInfo.format;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.layerCount = 1;
+    VK_MUST(vkCreateImageView(device.logicalDevice, &viewInfo, nullptr, &g_vkctx.msaaColorView));
+}
+
+void retireMsaaTarget(VulkanDeletionQueue& queue) {
+    // The view before the image, the image before its memory.
+    if (g_vkctx.msaaColorView != VK_NULL_HANDLE) queue.pushImageView(g_vkctx.msaaColorView);
+    if (g_vkctx.msaaColorImage != VK_NULL_HANDLE) queue.pushImage(g_vkctx.msaaColorImage);
+    if (g_vkctx.msaaColorMemory != VK_NULL_HANDLE) queue.pushMemory(g_vkctx.msaaColorMemory);
+    g_vkctx.msaaColorView = VK_NULL_HANDLE;
+    g_vkctx.msaaColorImage = VK_NULL_HANDLE;
+    g_vkctx.msaaColorMemory = VK_NULL_HANDLE;
 }
 
 void createExampleScene() {
     auto& meshes = g_vkctx.meshes;
-    auto& device = g_vkctx.device;
 
     // Prepare Meshes
     {
@@ -607,53 +962,147 @@ void createExampleScene() {
         quadMesh.bindingData.push({ core::v(-0.98f, -0.98f), core::v(0.0f, 0.0f, 1.0f, 1.0f) });
         quadMesh.bindingData.push({ core::v(0.98f, -0.98f), core::v(0.0f, 1.0f, 0.0f, 1.0f) });
 
-        // Create Vertex Buffer
-        VkBufferCreateInfo vertexBufferInfo{};
-        vertexBufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-        vertexBufferInfo.size = quadMesh.vertexByteSize();
-        vertexBufferInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+        createVertexBuffer(quadMesh);
+        meshes.push(std::move(quadMesh));
+    }
+}
+
+Mesh2D createMeshFromStl(const StlMesh& stlMesh) {
+    // TODO: The pipeline is still 2D, so for now the model is projected onto the XY plane, fitted into the viewport and
+    //       colored by its face normals.
+    Mesh2D mesh;
+    mesh.bindingData.replaceWith(Mesh2D::MeshBindData{}, stlMesh.vertexCount());
+
+    f32 center[2];
+    f32 extent = 0.0f;
+    for (i32 i = 0; i < 2; i++) {
+        center[i] = (stlMesh.boundsMin[i] + stlMesh.boundsMax[i]) * 0.5f;
+        f32 e = stlMesh.boundsMax[i] - stlMesh.boundsMin[i];
+        if (e > extent) extent = e;
+    }
+    f32 scale = extent > 0.0f ? 1.9f / extent : 1.0f;
+
+    const f32* positions = stlMesh.positions.data();
+    const f32* normals = stlMesh.normals.data();
+    for (addr_size t = 0; t < stlMesh.triangleCount(); t++) {
+        const f32* n = normals + t * 3;
+        core::vec4f color = core::v(n[0] < 0 ? -n[0] : n[0],
+                                    n[1] < 0 ? -n[1] : n[1],
+                                    n[2] < 0 ? -n[2] : n[2],
+                                    1.0f);
+
+        for (addr_size v = 0; v < 3; v++) {
+            const f32* p = positions + (t * 3 + v) * 3;
+            auto& bindData = mesh.bindingData[t * 3 + v];
+            bindData.positions = core::v((p[0] - center[0]) * scale, (center[1] - p[1]) * scale);
+            bindData.colors = color;
+        }
+    }
+
+    return mesh;
+}
+
+void createVertexBuffer(Mesh2D& mesh) {
+    auto& device = g_vkctx.device;
+
+    VkBufferCreateInfo vertexBufferInfo{};
+    vertexBufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    vertexBufferInfo.size = mesh.vertexByteSize();
+    // Also read by the mesh bounds job, which can run on a different queue family.
+    vertexBufferInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    u32 queueFamilies[] = { u32(device.graphicsQueue.idx), u32(device.computeQueue.idx) };
+    if (queueFamilies[0] != queueFamilies[1]) {
+        vertexBufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        vertexBufferInfo.queueFamilyIndexCount = 2;
+        vertexBufferInfo.pQueueFamilyIndices = queueFamilies;
+    }
+    else {
         vertexBufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    }
 
-        VK_MUST(vkCreateBuffer(device.logicalDevice, &vertexBufferInfo, nullptr, &quadMesh.vertexBuffer));
+    VK_MUST(vkCreateBuffer(device.logicalDevice, &vertexBufferInfo, nullptr, &mesh.vertexBuffer));
 
-        VkMemoryRequirements memRequirements;
-        vkGetBufferMemoryRequirements(device.logicalDevice, quadMesh.vertexBuffer, &memRequirements);
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(device.logicalDevice, mesh.vertexBuffer, &memRequirements);
 
-        auto findMemoryType = [](u32 typeFilter, VkMemoryPropertyFlags properties) -> u32 {
-            VkPhysicalDeviceMemoryProperties memProperties;
-            vkGetPhysicalDeviceMemoryProperties(g_vkctx.device.physicalDevice, &memProperties);
-            for (u32 i = 0; i < memProperties.memoryTypeCount; i++) {
-                bool isSupported = (memProperties.memoryTypes[i].propertyFlags & properties) == properties;
-                if ((typeFilter & (1 << i)) && isSupported) {
-                    return i;
-                }
-            }
+    VkMemoryAllocateInfo vertexAllocInfo{};
+    vertexAllocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    vertexAllocInfo.allocationSize = memRequirements.size;
+    vertexAllocInfo.memoryTypeIndex = findMemoryType(
+        memRequirements.memoryTypeBits,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+    );
 
-            Assert(false, "Failed to find memory type");
-            return 0;
-        };
+    VK_MUST(vkAllocateMemory(device.logicalDevice, &vertexAllocInfo, nullptr, &mesh.vertexBufferMemory));
+
+    VK_MUST(vkBindBufferMemory(device.logicalDevice, mesh.vertexBuffer, mesh.vertexBufferMemory, 0));
+
+    void* data;
+    VK_MUST(vkMapMemory(device.logicalDevice, mesh.vertexBufferMemory, 0, vertexBufferInfo.size, 0, &data));
+    core::memcopy(reinterpret_cast<char*>(data),
+                  reinterpret_cast<const char*>(mesh.bindingData.data()),
+                  addr_size(vertexBufferInfo.size));
+    vkUnmapMemory(device.logicalDevice, mesh.vertexBufferMemory);
+}
+
+u32 findMemoryType(u32 typeFilter, VkMemoryPropertyFlags properties) {
+    u32 idx = 0;
+    if (!tryFindMemoryType(typeFilter, properties, idx)) {
+        Assert(false, "Failed to find memory type");
+    }
+    return idx;
+}
 
-        VkMemoryAllocateInfo vertexAllocInfo{};
-        vertexAllocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        vertexAllocInfo.allocationSize = memRequirements.size;
-        vertexAllocInfo.memoryTypeIndex = findMemoryType(
-            memRequirements.memoryTypeBits,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-        );
+bool tryFindMemoryType(u32 typeFilter, VkMemoryPropertyFlags properties, u32& outIdx) {
+    return VulkanDevice::findMemoryType(g_vkctx.device, typeFilter, properties, outIdx);
+}
 
-        VK_MUST(vkAllocateMemory(device.logicalDevice, &vertexAllocInfo, nullptr, &quadMesh.vertexBufferMemory));
+void swapInPendingMesh() {
+    // Never wait on a loader thread here. If it is in the middle of submitting, pick the mesh up next frame.
+    std::unique_lock<std::mutex> lock(g_pendingMeshMutex, std::try_to_lock);
+    if (!lock.owns_lock() || !g_hasPendingMesh) {
+        return;
+    }
 
-        vkBindBufferMemory(device.logicalDevice, quadMesh.vertexBuffer, quadMesh.vertexBufferMemory, 0);
+    // The previous frames might still be reading the old meshes, and so might the bounds job. The deletion queue only
+    // covers the graphics timeline, the job is tiny and waited for here.
+    VulkanMeshBounds::wait();
+    VulkanDeletionQueue& deletionQueue = lastSubmittedDeletionQueue();
+    for (addr_size i = 0; i < g_vkctx.meshes.len(); i++) {
+        Mesh2D::retire(deletionQueue, g_vkctx.meshes[i]);
+    }
+    g_vkctx.meshes.clear();
 
-        void* data;
-        vkMapMemory(device.logicalDevice, quadMesh.vertexBufferMemory, 0, vertexBufferInfo.size, 0, &data);
-        core::memcopy(reinterpret_cast<char*>(data),
-                      reinterpret_cast<const char*>(quadMesh.bindingData.data()),
-                      addr_size(vertexBufferInfo.size) * sizeof(quadMesh.bindingData));
-        vkUnmapMemory(device.logicalDevice, quadMesh.vertexBufferMemory);
+    MemoryTracker::restartSteadyState();
+    g_vkctx.meshes.push(std::move(g_pendingMesh));
+    g_pendingMesh = Mesh2D{};
+    g_hasPendingMesh = false;
 
-        meshes.push(std::move(quadMesh));
+    VulkanMeshBounds::request(g_vkctx.meshes[g_vkctx.meshes.len() - 1]);
+}
+
+void swapInPendingShaders() {
+    std::unique_lock<std::mutex> lock(g_pendingShaderMutex, std::try_to_lock);
+    if (!lock.owns_lock() || g_pendingBasePipeline == VK_NULL_HANDLE) {
+        return;
     }
+
+    // The previous frames might still be using the old pipelines. The old modules are not referenced by them, and the
+    // registry has no compile running once setShaders returns.
+    VulkanPipelineRegistry::setShaders(g_pendingShader.stages[0].shaderModule, g_pendingShader.stages[1].shaderModule,
+                                       g_pendingBasePipeline, lastSubmittedDeletionQueue());
+    VulkanShader::destroy(g_vkctx.shader, g_vkctx.device.logicalDevice);
+    g_vkctx.shader = std::move(g_pendingShader);
+    g_pendingShader = VulkanShader{};
+    g_pendingBasePipeline = VK_NULL_HANDLE;
+    logInfoTagged(RENDERER_TAG, "Swapped in the reloaded shaders");
+}
+
+VulkanDeletionQueue& lastSubmittedDeletionQueue() {
+    // The queue is flushed after the next wait for the last submitted frame's timeline value, which covers every frame
+    // that was submitted so far. Using the current frame's queue instead would be wrong when the current frame ends up
+    // not being submitted (e.g. the swapchain is out of date), since its value has already been waited for.
+    return g_vkctx.deletionQueues[g_vkctx.lastSubmittedFrame];
 }
 
 } // namespace
@@ -5,20 +5,35 @@ namespace {
 
 core::AtomicU32 nextShaderId = 1;
 
+bool createShaderModule(VkDevice logicalDevice, const u32* code, addr_size codeSize, VkShaderModule& out);
+
 };
 
-core::expected<VulkanShaderStage, AppError> VulkanShaderStage::createFromFile(VkDevice logicalDevice,
-                                                                              core::StrView path,
-                                                                              Type stageType) {
-    core::ArrList<u8> bytes;
-    if (auto res = core::fileReadEntire(path.data(), bytes); res.hasErr()) {
+core::expected<AppError> VulkanShaderStage::readFile(core::StrView path, core::ArrList<u8>& outBytes) {
+    if (auto res = core::fileReadEntire(path.data(), outBytes); res.hasErr()) {
         char errBuf[core::MAX_SYSTEM_ERR_MSG_SIZE];
         Assert(core::pltErrorDescribe(res.err(), errBuf), "Failed to describe platform error");
         logErrTagged(RENDERER_TAG, "Failed to load shader file, path: {}, reason: {}", path.data(), errBuf);
         return core::unexpected(createPltErr(PlatformError::Type::FAILED_TO_LOAD_SHADER,
                                              "Failed to load shader file"));
     }
+    return {};
+}
 
+core::expected<VulkanShaderStage, AppError> VulkanShaderStage::createFromFile(VkDevice logicalDevice,
+                                                                              core::StrView path,
+                                                                              Type stageType) {
+    core::ArrList<u8> bytes;
+    if (auto res = readFile(path, bytes); res.hasErr()) {
+        return core::unexpected(res.err());
+    }
+    return createFromBytes(logicalDevice, path, std::move(bytes), stageType);
+}
+
+core::expected<VulkanShaderStage, AppError> VulkanShaderStage::createFromBytes(VkDevice logicalDevice,
+                                                                               core::StrView path,
+                                                                               core::ArrList<u8>&& bytes,
+                                                                               Type stageType) {
     VulkanShaderStage ret;
     ret.id = nextShaderId.fetch_add(1);
     ret.stageType = stageType;
@@ -32,18 +47,9 @@ core::expected<VulkanShaderStage, AppError> VulkanShaderStage::createFromFile(Vk
     }
 
     // Create the shader module
-    {
-        VkShaderModuleCreateInfo createInfo{};
-        createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-        createInfo.codeSize = ret.shaderBytesSize;
-        createInfo.pCode = reinterpret_cast<const u32*>(ret.shaderBytes);
-
-        if (
-            VkResult vres = vkCreateShaderModule(logicalDevice, &createInfo, nullptr, &ret.shaderModule);
-            vres != VK_SUCCESS
-        ) {
-            return core::unexpected(createRendErr(RendererError::FAILED_TO_CREATE_VULKAN_SHADER_MODULE));
-        }
+    if (!createShaderModule(logicalDevice, reinterpret_cast<const u32*>(ret.shaderBytes), ret.shaderBytesSize,
+                            ret.shaderModule)) {
+        return core::unexpected(createRendErr(RendererError::FAILED_TO_CREATE_VULKAN_SHADER_MODULE));
     }
 
     logInfoTagged(RENDERER_TAG, "Created Shader Stage: id={}, type={}", ret.id, ret.stageType);
@@ -70,6 +76,21 @@ core::expected<VulkanShaderStage, AppError> VulkanShaderStage::createFromFile(Vk
     return ret;
 }
 
+core::expected<VulkanShaderStage, AppError> VulkanShaderStage::createFromSpirv(VkDevice logicalDevice,
+                                                                               core::Memory<const u32> words,
+                                                                               Type stageType) {
+    VulkanShaderStage ret;
+    ret.id = nextShaderId.fetch_add(1);
+    ret.stageType = stageType;
+
+    if (!createShaderModule(logicalDevice, words.data(), words.len() * sizeof(u32), ret.shaderModule)) {
+        return core::unexpected(createRendErr(RendererError::FAILED_TO_CREATE_VULKAN_SHADER_MODULE));
+    }
+
+    logInfoTagged(RENDERER_TAG, "Created Shader Stage: id={}, type={} (embedded)", ret.id, ret.stageType);
+    return ret;
+}
+
 void VulkanShaderStage::destroy(VulkanShaderStage& stage, VkDevice logicalDevice) {
     logInfoTagged(RENDERER_TAG, "Destroying Shader Stage (id={}, type={})", stage.id, stage.stageType);
 
@@ -102,12 +123,16 @@ VulkanShader VulkanShader::createGraphicsShaderFromFile(const CreateFromFileInfo
     VulkanShader ret;
 
     // Vertex and Fragment stages are required.
-    VulkanShaderStage vertexStage = core::Unpack(VulkanShaderStage::createFromFile(device.logicalDevice,
-                                                                                   info.vertexShaderPath,
-                                                                                   VulkanShaderStage::VERTEX));
-    VulkanShaderStage fragmentStage = core::Unpack(VulkanShaderStage::createFromFile(device.logicalDevice,
-                                                                                     info.fragmetShaderPath,
-                                                                                     VulkanShaderStage::FRAGMENT));
+    auto createStage = [&](core::StrView path, core::ArrList<u8>* prefetched, VulkanShaderStage::Type type) {
+        if (prefetched && !prefetched->empty()) {
+            return VulkanShaderStage::createFromBytes(device.logicalDevice, path, std::move(*prefetched), type);
+        }
+        return VulkanShaderStage::createFromFile(device.logicalDevice, path, type);
+    };
+    VulkanShaderStage vertexStage = core::Unpack(createStage(info.vertexShaderPath, info.vertexShaderBytes,
+                                                             VulkanShaderStage::VERTEX));
+    VulkanShaderStage fragmentStage = core::Unpack(createStage(info.fragmetShaderPath, info.fragmentShaderBytes,
+                                                               VulkanShaderStage::FRAGMENT));
 
     ret.stages.push(vertexStage);
     ret.stages.push(fragmentStage);
@@ -115,6 +140,21 @@ VulkanShader VulkanShader::createGraphicsShaderFromFile(const CreateFromFileInfo
     return ret;
 }
 
+VulkanShader VulkanShader::createGraphicsShaderFromSpirv(core::Memory<const u32> vertexWords,
+                                                         core::Memory<const u32> fragmentWords,
+                                                         const VulkanContext& vkctx) {
+    logInfoTagged(RENDERER_TAG, "Creating a Graphics Shader from embedded SPIR-V:");
+
+    auto& device = vkctx.device;
+
+    VulkanShader ret;
+    ret.stages.push(core::Unpack(VulkanShaderStage::createFromSpirv(device.logicalDevice, vertexWords,
+                                                                   VulkanShaderStage::VERTEX)));
+    ret.stages.push(core::Unpack(VulkanShaderStage::createFromSpirv(device.logicalDevice, fragmentWords,
+                                                                   VulkanShaderStage::FRAGMENT)));
+    return ret;
+}
+
 void VulkanShader::destroy(VulkanShader& shader, VkDevice logicalDevice) {
     for (addr_size i = 0; i < shader.stages.len(); i++) {
         auto& stage = shader.stages[i];
@@ -125,3 +165,17 @@ void VulkanShader::destroy(VulkanShader& shader, VkDevice logicalDevice) {
 
     logInfoTagged(RENDERER_TAG, "Vulkan Shader Destryoed");
 }
+
+namespace {
+
+bool createShaderModule(VkDevice logicalDevice, const u32* code, addr_size codeSize, VkShaderModule& out) {
+    VkShaderModuleCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    createInfo.codeSize = codeSize;
+    createInfo.pCode = code;
+
+    VkResult vres = vkCreateShaderModule(logicalDevice, &createInfo, nullptr, &out);
+    return vres == VK_SUCCESS;
+}
+
+} // namespace
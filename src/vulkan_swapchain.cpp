@@ -61,6 +61,10 @@ core::expected<VulkanSwapchain, AppError> VulkanSwapchain::create(const VulkanCo
         ) {
             return core::unexpected(createRendErr(RendererError::FAILED_TO_GET_SWAPCHAIN_IMAGES));
         }
+        if (finalImageCount > MAX_IMAGES) {
+            logErrTagged(RENDERER_TAG, "Swapchain has {} images, at most {} are supported", finalImageCount, MAX_IMAGES);
+            return core::unexpected(createRendErr(RendererError::FAILED_TO_GET_SWAPCHAIN_IMAGES));
+        }
 
         swapchain.images = core::ArrList<VkImage>(finalImageCount, VkImage{});
 
@@ -129,3 +133,15 @@ void VulkanSwapchain::destroy(VulkanSwapchain& swapchain, const VulkanDevice& de
         vkDestroySwapchainKHR(device.logicalDevice, swapchain.handle, nullptr);
     }
 }
+
+void VulkanSwapchain::retire(VulkanSwapchain& swapchain, VulkanDeletionQueue& queue) {
+    defer { swapchain = {}; };
+
+    for (addr_size i = 0; i < swapchain.imageViews.len(); i++) {
+        queue.pushImageView(swapchain.imageViews[i]);
+    }
+
+    if (swapchain.handle != VK_NULL_HANDLE) {
+        queue.pushSwapchain(swapchain.handle);
+    }
+}
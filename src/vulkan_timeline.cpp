@@ -0,0 +1,217 @@
+#include <app_logger.h>
+#include <vulkan_renderer.h>
+
+namespace {
+
+PFN_vkWaitSemaphoresKHR g_waitSemaphores = nullptr;
+PFN_vkGetSemaphoreCounterValueKHR g_getSemaphoreCounterValue = nullptr;
+
+void submitTimeline(VulkanTimeline& timeline, VkQueue queue, const VulkanTimeline::Submit& submit, u64 value);
+void submitFallback(VulkanTimeline& timeline, VkQueue queue, const VulkanTimeline::Submit& submit, u64 value);
+
+} // namespace
+
+void VulkanTimeline::Submit::waitBinary(VkSemaphore semaphore, VkPipelineStageFlags stage) {
+    Assert(binaryWaitsCount < MAX_WAITS, "Too many binary semaphore waits");
+    binaryWaits[binaryWaitsCount] = semaphore;
+    binaryWaitStages[binaryWaitsCount] = stage;
+    binaryWaitsCount++;
+}
+
+void VulkanTimeline::Submit::waitTimeline(const VulkanTimeline& timeline, u64 value, VkPipelineStageFlags stage) {
+    Assert(timelineWaitsCount < MAX_WAITS, "Too many timeline waits");
+    timelineWaits[timelineWaitsCount] = &timeline;
+    timelineWaitValues[timelineWaitsCount] = value;
+    timelineWaitStages[timelineWaitsCount] = stage;
+    timelineWaitsCount++;
+}
+
+VulkanTimeline VulkanTimeline::create(const VulkanDevice& device) {
+    VulkanTimeline timeline = {};
+    timeline.logicalDevice = device.logicalDevice;
+
+    if (device.timelineSemaphoreEnabled) {
+        g_waitSemaphores = reinterpret_cast<PFN_vkWaitSemaphoresKHR>(
+            vkGetDeviceProcAddr(device.logicalDevice, "vkWaitSemaphoresKHR"));
+        g_getSemaphoreCounterValue = reinterpret_cast<PFN_vkGetSemaphoreCounterValueKHR>(
+            vkGetDeviceProcAddr(device.logicalDevice, "vkGetSemaphoreCounterValueKHR"));
+        Panic(g_waitSemaphores && g_getSemaphoreCounterValue, "Timeline semaphore functions are missing.");
+
+        VkSemaphoreTypeCreateInfoKHR typeCreateInfo{};
+        typeCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+        typeCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+        typeCreateInfo.initialValue = 0;
+
+        VkSemaphoreCreateInfo semaphoreCreateInfo{};
+        semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphoreCreateInfo.pNext = &typeCreateInfo;
+        VK_MUST(vkCreateSemaphore(device.logicalDevice, &semaphoreCreateInfo, nullptr, &timeline.semaphore));
+    }
+    else {
+        VkFenceCreateInfo fenceCreateInfo{};
+        fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        for (u32 i = 0; i < FALLBACK_SLOTS; i++) {
+            VK_MUST(vkCreateFence(device.logicalDevice, &fenceCreateInfo, nullptr, &timeline.fences[i]));
+        }
+    }
+
+    return timeline;
+}
+
+void VulkanTimeline::destroy(VulkanTimeline& timeline) {
+    defer { timeline = {}; };
+
+    if (timeline.logicalDevice == VK_NULL_HANDLE) return;
+
+    if (timeline.semaphore != VK_NULL_HANDLE) {
+        vkDestroySemaphore(timeline.logicalDevice, timeline.semaphore, nullptr);
+    }
+    for (u32 i = 0; i < FALLBACK_SLOTS; i++) {
+        if (timeline.fences[i] != VK_NULL_HANDLE) {
+            vkDestroyFence(timeline.logicalDevice, timeline.fences[i], nullptr);
+        }
+    }
+}
+
+u64 VulkanTimeline::submit(VulkanTimeline& timeline, VkQueue queue, const Submit& submit) {
+    u64 value = timeline.lastSubmitted + 1;
+
+    if (timeline.semaphore != VK_NULL_HANDLE) {
+        submitTimeline(timeline, queue, submit, value);
+    }
+    else {
+        submitFallback(timeline, queue, submit, value);
+    }
+
+    timeline.lastSubmitted = value;
+    return value;
+}
+
+void VulkanTimeline::wait(const VulkanTimeline& timeline, u64 value) {
+    if (isReached(timeline, value)) return;
+
+    Assert(value <= timeline.lastSubmitted, "Waiting for a value that was never submitted");
+
+    if (timeline.semaphore != VK_NULL_HANDLE) {
+        VkSemaphoreWaitInfoKHR waitInfo{};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &timeline.semaphore;
+        waitInfo.pValues = &value;
+        VK_MUST(g_waitSemaphores(timeline.logicalDevice, &waitInfo, UINT64_MAX));
+        return;
+    }
+
+    // Values are submitted in order to a single queue, so waiting for the fence of the value covers everything before
+    // it. A value whose slot was already reused was waited on before the reuse.
+    u32 slot = u32(value % FALLBACK_SLOTS);
+    if (timeline.fenceValues[slot] == value) {
+        VK_MUST(vkWaitForFences(timeline.logicalDevice, 1, &timeline.fences[slot], VK_TRUE, UINT64_MAX));
+    }
+    if (value > timeline.lastCompleted) timeline.lastCompleted = value;
+}
+
+bool VulkanTimeline::isReached(const VulkanTimeline& timeline, u64 value) {
+    if (value <= timeline.lastCompleted) return true;
+
+    if (timeline.semaphore != VK_NULL_HANDLE) {
+        u64 current = 0;
+        VK_MUST(g_getSemaphoreCounterValue(timeline.logicalDevice, timeline.semaphore, &current));
+        timeline.lastCompleted = current;
+        return value <= current;
+    }
+
+    u32 slot = u32(value % FALLBACK_SLOTS);
+    if (timeline.fenceValues[slot] != value) return false; // Never submitted.
+    if (vkGetFenceStatus(timeline.logicalDevice, timeline.fences[slot]) != VK_SUCCESS) return false;
+
+    timeline.lastCompleted = value;
+    return true;
+}
+
+namespace {
+
+void submitTimeline(VulkanTimeline& timeline, VkQueue queue, const VulkanTimeline::Submit& submit, u64 value) {
+    constexpr u32 MAX_WAITS = VulkanTimeline::Submit::MAX_WAITS * 2;
+
+    VkSemaphore waitSemaphores[MAX_WAITS];
+    VkPipelineStageFlags waitStages[MAX_WAITS];
+    u64 waitValues[MAX_WAITS];
+    u32 waitsCount = 0;
+
+    for (u32 i = 0; i < submit.binaryWaitsCount; i++) {
+        waitSemaphores[waitsCount] = submit.binaryWaits[i];
+        waitStages[waitsCount] = submit.binaryWaitStages[i];
+        waitValues[waitsCount] = 0; // Ignored for binary semaphores.
+        waitsCount++;
+    }
+    for (u32 i = 0; i < submit.timelineWaitsCount; i++) {
+        const VulkanTimeline& other = *submit.timelineWaits[i];
+        Assert(other.semaphore != VK_NULL_HANDLE, "Waiting on a timeline in fallback mode");
+        waitSemaphores[waitsCount] = other.semaphore;
+        waitStages[waitsCount] = submit.timelineWaitStages[i];
+        waitValues[waitsCount] = submit.timelineWaitValues[i];
+        waitsCount++;
+    }
+
+    VkSemaphore signalSemaphores[2];
+    u64 signalValues[2];
+    u32 signalsCount = 0;
+    signalSemaphores[signalsCount] = timeline.semaphore;
+    signalValues[signalsCount] = value;
+    signalsCount++;
+    if (submit.signalBinary != VK_NULL_HANDLE) {
+        signalSemaphores[signalsCount] = submit.signalBinary;
+        signalValues[signalsCount] = 0; // Ignored for binary semaphores.
+        signalsCount++;
+    }
+
+    VkTimelineSemaphoreSubmitInfoKHR timelineSubmitInfo{};
+    timelineSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+    timelineSubmitInfo.waitSemaphoreValueCount = waitsCount;
+    timelineSubmitInfo.pWaitSemaphoreValues = waitValues;
+    timelineSubmitInfo.signalSemaphoreValueCount = signalsCount;
+    timelineSubmitInfo.pSignalSemaphoreValues = signalValues;
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineSubmitInfo;
+    submitInfo.waitSemaphoreCount = waitsCount;
+    submitInfo.pWaitSemaphores = waitSemaphores;
+    submitInfo.pWaitDstStageMask = waitStages;
+    submitInfo.commandBufferCount = submit.cmdBuffer != VK_NULL_HANDLE ? 1 : 0;
+    submitInfo.pCommandBuffers = &submit.cmdBuffer;
+    submitInfo.signalSemaphoreCount = signalsCount;
+    submitInfo.pSignalSemaphores = signalSemaphores;
+
+    VK_MUST(vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE));
+}
+
+void submitFallback(VulkanTimeline& timeline, VkQueue queue, const VulkanTimeline::Submit& submit, u64 value) {
+    // There is nothing to wait on the GPU for, so wait for the other queues on the CPU.
+    for (u32 i = 0; i < submit.timelineWaitsCount; i++) {
+        VulkanTimeline::wait(*submit.timelineWaits[i], submit.timelineWaitValues[i]);
+    }
+
+    u32 slot = u32(value % VulkanTimeline::FALLBACK_SLOTS);
+    VkFence& fence = timeline.fences[slot];
+    if (timeline.fenceValues[slot] != 0) {
+        VulkanTimeline::wait(timeline, timeline.fenceValues[slot]);
+        VK_MUST(vkResetFences(timeline.logicalDevice, 1, &fence));
+    }
+    timeline.fenceValues[slot] = value;
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.waitSemaphoreCount = submit.binaryWaitsCount;
+    submitInfo.pWaitSemaphores = submit.binaryWaits;
+    submitInfo.pWaitDstStageMask = submit.binaryWaitStages;
+    submitInfo.commandBufferCount = submit.cmdBuffer != VK_NULL_HANDLE ? 1 : 0;
+    submitInfo.pCommandBuffers = &submit.cmdBuffer;
+    submitInfo.signalSemaphoreCount = submit.signalBinary != VK_NULL_HANDLE ? 1 : 0;
+    submitInfo.pSignalSemaphores = &submit.signalBinary;
+
+    VK_MUST(vkQueueSubmit(queue, 1, &submitInfo, fence));
+}
+
+} // namespace
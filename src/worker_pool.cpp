@@ -0,0 +1,83 @@
+#include <worker_pool.h>
+
+void WorkerPool::init(u32 threadCount) {
+    Assert(m_threadCount == 0, "Worker pool is already initialized");
+
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+        if (threadCount == 0) threadCount = 1;
+    }
+    if (threadCount > MAX_THREADS) threadCount = MAX_THREADS;
+
+    m_head = 0;
+    m_count = 0;
+    m_running = 0;
+    m_stopping = false;
+
+    for (u32 i = 0; i < threadCount; i++) {
+        m_threads[i] = std::thread(workerLoop, this);
+    }
+    m_threadCount = threadCount;
+}
+
+void WorkerPool::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_jobAvailable.notify_all();
+
+    for (u32 i = 0; i < m_threadCount; i++) {
+        m_threads[i].join();
+    }
+    m_threadCount = 0;
+}
+
+void WorkerPool::submit(JobFn fn, void* userData) {
+    Assert(m_threadCount > 0, "Worker pool is not initialized");
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_slotAvailable.wait(lock, [this] { return m_count < MAX_QUEUED_JOBS; });
+
+        u32 tail = (m_head + m_count) % MAX_QUEUED_JOBS;
+        m_jobs[tail] = { fn, userData };
+        m_count++;
+    }
+    m_jobAvailable.notify_one();
+}
+
+void WorkerPool::waitIdle() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] { return m_count == 0 && m_running == 0; });
+}
+
+void WorkerPool::workerLoop(WorkerPool* pool) {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(pool->m_mutex);
+            pool->m_jobAvailable.wait(lock, [pool] { return pool->m_count > 0 || pool->m_stopping; });
+            if (pool->m_count == 0) {
+                // Stopping and nothing left to run.
+                return;
+            }
+
+            job = pool->m_jobs[pool->m_head];
+            pool->m_head = (pool->m_head + 1) % MAX_QUEUED_JOBS;
+            pool->m_count--;
+            pool->m_running++;
+        }
+        pool->m_slotAvailable.notify_one();
+
+        job.fn(job.userData);
+
+        bool idle;
+        {
+            std::lock_guard<std::mutex> lock(pool->m_mutex);
+            pool->m_running--;
+            idle = pool->m_count == 0 && pool->m_running == 0;
+        }
+        if (idle) pool->m_idle.notify_all();
+    }
+}
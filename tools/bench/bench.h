@@ -0,0 +1,26 @@
+#pragma once
+
+#include <basic.h>
+
+#include <chrono>
+#include <cstdlib>
+
+inline f64 benchNowSeconds() {
+    using namespace std::chrono;
+    return duration<f64>(steady_clock::now().time_since_epoch()).count();
+}
+
+// The idx-th positional argument of a bench, or defaultValue when it was not given.
+inline i32 benchParseIntArg(core::Memory<const char*> args, addr_size idx, i32 defaultValue) {
+    if (idx >= args.len()) return defaultValue;
+    return i32(std::strtol(args[idx], nullptr, 10));
+}
+
+i32 runMeshCodecBench(core::Memory<const char*> paths);
+i32 runAsyncIoBench(core::Memory<const char*> paths);
+i32 runFrameArenaBench(core::Memory<const char*> args);
+i32 runLogOverheadBench(core::Memory<const char*> args);
+
+#if defined(USE_X11)
+i32 runX11EventsBench(core::Memory<const char*> args);
+#endif
@@ -0,0 +1,141 @@
+#include "./bench.h"
+
+#include <app_logger.h>
+#include <async_file_reader.h>
+#include <stl_loader.h>
+#include <worker_pool.h>
+
+#include <atomic>
+
+#if defined(OS_LINUX) && OS_LINUX == 1
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace {
+
+struct BenchStats {
+    std::atomic<u64> bytes = 0;
+    std::atomic<u64> triangles = 0;
+    std::atomic<u32> failed = 0;
+};
+
+BenchStats g_stats;
+
+bool evictFromPageCache(core::Memory<const char*> paths);
+void resetStats();
+void logResult(const char* name, f64 seconds);
+
+void parseCompletion(AsyncFileReader::Completion& completion);
+
+} // namespace
+
+i32 runAsyncIoBench(core::Memory<const char*> paths) {
+    if (paths.len() == 0) {
+        logErr("async_io: expected at least one STL file");
+        return -1;
+    }
+
+    bool cold = evictFromPageCache(paths);
+    logInfo("files: {}, page cache: {}", paths.len(), cold ? "cold" : "warm (eviction is not supported)");
+
+    // Baseline: what the loader does today, one blocking read and parse after another.
+    {
+        resetStats();
+        f64 start = benchNowSeconds();
+        for (addr_size i = 0; i < paths.len(); i++) {
+            core::ArrList<u8> bytes;
+            if (auto res = core::fileReadEntire(paths[i], bytes); res.hasErr()) {
+                g_stats.failed++;
+                continue;
+            }
+            g_stats.bytes += bytes.len();
+
+            auto parseRes = StlMesh::parse(bytes.memView());
+            if (parseRes.hasErr()) {
+                g_stats.failed++;
+                continue;
+            }
+            g_stats.triangles += parseRes.value().triangleCount();
+        }
+        logResult("fileReadEntire (sequential)", benchNowSeconds() - start);
+    }
+
+    core::ArrList<AsyncFileReader::ReadRequest> requests (paths.len());
+    for (addr_size i = 0; i < paths.len(); i++) {
+        requests.push({ paths[i], nullptr });
+    }
+
+    WorkerPool parserPool;
+    parserPool.init();
+    defer { parserPool.shutdown(); };
+
+    constexpr AsyncFileReader::Backend backends[] = {
+        AsyncFileReader::Backend::THREAD_POOL,
+        AsyncFileReader::Backend::IO_URING,
+    };
+
+    for (auto backend : backends) {
+        if (cold) evictFromPageCache(paths);
+        resetStats();
+
+        AsyncFileReader::BatchInfo info;
+        info.requests = requests.memView();
+        info.onComplete = parseCompletion;
+        info.parserPool = &parserPool;
+        info.preferredBackend = backend;
+
+        f64 start = benchNowSeconds();
+        AsyncFileReader::Backend used = AsyncFileReader::readBatch(info);
+        logResult(AsyncFileReader::backendToCStr(used), benchNowSeconds() - start);
+    }
+
+    return 0;
+}
+
+namespace {
+
+bool evictFromPageCache(core::Memory<const char*> paths) {
+#if defined(OS_LINUX) && OS_LINUX == 1
+    // Drops the clean pages of each file, which is enough for files that are not being written to.
+    for (addr_size i = 0; i < paths.len(); i++) {
+        i32 fd = ::open(paths[i], O_RDONLY);
+        if (fd < 0) continue;
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        ::close(fd);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void resetStats() {
+    g_stats.bytes = 0;
+    g_stats.triangles = 0;
+    g_stats.failed = 0;
+}
+
+void logResult(const char* name, f64 seconds) {
+    constexpr f64 MB = 1024.0 * 1024.0;
+    logInfo(ANSI_BOLD("{}"), name);
+    logInfo("time: {}ms, throughput: {} MB/s, triangles: {}, failed: {}",
+            seconds * 1000.0, f64(g_stats.bytes.load()) / MB / seconds, g_stats.triangles.load(), g_stats.failed.load());
+}
+
+void parseCompletion(AsyncFileReader::Completion& completion) {
+    if (completion.errCode != 0) {
+        g_stats.failed++;
+        return;
+    }
+    g_stats.bytes += completion.data.len();
+
+    auto res = StlMesh::parse(completion.data.memView());
+    if (res.hasErr()) {
+        g_stats.failed++;
+        return;
+    }
+    g_stats.triangles += res.value().triangleCount();
+}
+
+} // namespace
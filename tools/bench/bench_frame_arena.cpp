@@ -0,0 +1,129 @@
+#include "./bench.h"
+
+#include <app_logger.h>
+#include <frame_arena.h>
+#include <memory_tracker.h>
+
+namespace {
+
+constexpr i32 DEFAULT_FRAMES = 2000;
+constexpr i32 DEFAULT_OBJECTS = 4096;
+constexpr u32 FRAMES_IN_FLIGHT = 2;
+
+// Roughly what a frame builds on the CPU: a draw list and the subset of it that survives culling.
+struct DrawItem {
+    u32 meshIdx;
+    u32 pipelineIdx;
+    f32 depth;
+    f32 radius;
+};
+
+struct FrameResult {
+    f64 seconds;
+    u64 allocations;
+    u64 checksum; // Keeps the work from being optimized away.
+};
+
+FrameResult runHeapFrames(i32 frames, i32 objects);
+FrameResult runArenaFrames(i32 frames, i32 objects);
+u64 buildFrame(core::Memory<DrawItem> drawList, core::Memory<u32> visible, i32 frameIdx);
+void logResult(const char* name, const FrameResult& res, i32 frames);
+
+} // namespace
+
+i32 runFrameArenaBench(core::Memory<const char*> args) {
+    i32 frames = benchParseIntArg(args, 0, DEFAULT_FRAMES);
+    i32 objects = benchParseIntArg(args, 1, DEFAULT_OBJECTS);
+    if (frames <= 0 || objects <= 0) {
+        logErr("frame_arena: frame and object counts must be positive");
+        return -1;
+    }
+
+    logInfo(ANSI_BOLD("frames={}, objects={}"), frames, objects);
+    logResult("heap", runHeapFrames(frames, objects), frames);
+    logResult("arena", runArenaFrames(frames, objects), frames);
+
+    return 0;
+}
+
+namespace {
+
+FrameResult runHeapFrames(i32 frames, i32 objects) {
+    FrameResult res = {};
+    u64 allocStart = MemoryTracker::threadAllocationsCount();
+    f64 start = benchNowSeconds();
+
+    for (i32 f = 0; f < frames; f++) {
+        core::ArrList<DrawItem> drawList (addr_size(objects), DrawItem{});
+        core::ArrList<u32> visible (addr_size(objects), u32(0));
+        res.checksum += buildFrame(drawList.memView(), visible.memView(), f);
+    }
+
+    res.seconds = benchNowSeconds() - start;
+    res.allocations = MemoryTracker::threadAllocationsCount() - allocStart;
+    return res;
+}
+
+FrameResult runArenaFrames(i32 frames, i32 objects) {
+    // Same as the renderer, one arena per frame in flight. Starts small on purpose to show the growth settling.
+    FrameArena arenas[FRAMES_IN_FLIGHT];
+    for (u32 i = 0; i < FRAMES_IN_FLIGHT; i++) {
+        arenas[i] = FrameArena::create(core::CORE_KILOBYTE);
+    }
+    defer {
+        for (u32 i = 0; i < FRAMES_IN_FLIGHT; i++) FrameArena::destroy(arenas[i]);
+    };
+
+    FrameResult res = {};
+    u64 allocStart = MemoryTracker::threadAllocationsCount();
+    u64 steadyAllocStart = 0;
+    f64 start = benchNowSeconds();
+
+    for (i32 f = 0; f < frames; f++) {
+        if (f == i32(FRAMES_IN_FLIGHT) * 2) steadyAllocStart = MemoryTracker::threadAllocationsCount();
+
+        FrameArena& arena = arenas[u32(f) % FRAMES_IN_FLIGHT];
+        FrameArena::reset(arena);
+        auto drawList = FrameArena::allocArr<DrawItem>(arena, addr_size(objects));
+        auto visible = FrameArena::allocArr<u32>(arena, addr_size(objects));
+        res.checksum += buildFrame(drawList, visible, f);
+    }
+
+    res.seconds = benchNowSeconds() - start;
+    res.allocations = MemoryTracker::threadAllocationsCount() - allocStart;
+
+    u64 warmupAllocations = steadyAllocStart - allocStart;
+    logInfo("arena: {} allocations while warming up, {} after", warmupAllocations,
+            res.allocations - warmupAllocations);
+    return res;
+}
+
+u64 buildFrame(core::Memory<DrawItem> drawList, core::Memory<u32> visible, i32 frameIdx) {
+    for (addr_size i = 0; i < drawList.len(); i++) {
+        DrawItem& item = drawList[i];
+        item.meshIdx = u32(i);
+        item.pipelineIdx = u32(i % 5);
+        item.depth = f32((i * 7919 + addr_size(frameIdx)) % 1000) * 0.01f;
+        item.radius = 0.5f;
+    }
+
+    u32 visibleCount = 0;
+    for (addr_size i = 0; i < drawList.len(); i++) {
+        if (drawList[i].depth - drawList[i].radius < 8.0f) {
+            visible[visibleCount++] = u32(i);
+        }
+    }
+
+    u64 checksum = 0;
+    for (u32 i = 0; i < visibleCount; i++) {
+        checksum += drawList[visible[i]].pipelineIdx;
+    }
+    return checksum;
+}
+
+void logResult(const char* name, const FrameResult& res, i32 frames) {
+    logInfo("{}: {}us/frame, {} allocations/frame (checksum={})",
+            name, res.seconds * 1e6 / f64(frames), f64(res.allocations) / f64(frames), res.checksum);
+}
+
+} // namespace
@@ -0,0 +1,105 @@
+#include "./bench.h"
+
+#include <app_logger.h>
+
+namespace {
+
+constexpr i32 DEFAULT_EVENTS = 1000000;
+constexpr i32 REPEATS = 5; // The best run is reported.
+
+// The shape of the mouse move handling in the application: a little work per event and a trace log with an argument
+// that has to be computed.
+struct MoveEvent {
+    i32 x;
+    i32 y;
+    u32 mods;
+};
+
+enum struct Variant : u8 {
+    NO_LOG,
+    RUNTIME_FILTERED, // The level check happens inside the call, after the arguments are evaluated.
+    COMPILE_TIME_FILTERED, // The application's macros.
+};
+
+i64 g_sink = 0;
+
+f64 runEventLoop(core::Memory<const MoveEvent> events, Variant variant);
+const char* modsToCStr(u32 mods);
+
+} // namespace
+
+i32 runLogOverheadBench(core::Memory<const char*> args) {
+    i32 eventsCount = benchParseIntArg(args, 0, DEFAULT_EVENTS);
+    if (eventsCount <= 0) {
+        logErr("log_overhead: event count must be positive");
+        return -1;
+    }
+
+    // Trace is off at runtime in both filtered variants, as it is in a normal run of the application.
+    AsyncLogger::setLevel(AsyncLogger::Level::INFO);
+
+    core::ArrList<MoveEvent> events (addr_size(eventsCount), MoveEvent{});
+    for (i32 i = 0; i < eventsCount; i++) {
+        events[addr_size(i)] = { i % 1920, (i * 7) % 1080, u32(i % 4) };
+    }
+
+    logInfo(ANSI_BOLD("events={}, trace for INPUT_EVENTS compiled in: {}"), eventsCount,
+            appLogIsCompiledIn(AsyncLogger::Level::TRACE, INPUT_EVENTS_TAG));
+
+    struct { const char* name; Variant variant; } variants[] = {
+        { "no log",                Variant::NO_LOG },
+        { "runtime filtered",      Variant::RUNTIME_FILTERED },
+        { "compile time filtered", Variant::COMPILE_TIME_FILTERED },
+    };
+
+    for (auto& v : variants) {
+        f64 best = 0;
+        for (i32 r = 0; r < REPEATS; r++) {
+            f64 t = runEventLoop(events.memView(), v.variant);
+            if (r == 0 || t < best) best = t;
+        }
+        logInfo("{}: {}ns/event", v.name, best * 1e9 / f64(eventsCount));
+    }
+
+    logInfo("(sink={})", g_sink);
+    return 0;
+}
+
+namespace {
+
+f64 runEventLoop(core::Memory<const MoveEvent> events, Variant variant) {
+    f64 start = benchNowSeconds();
+
+    for (addr_size i = 0; i < events.len(); i++) {
+        const MoveEvent& ev = events[i];
+        g_sink += ev.x + ev.y;
+
+        switch (variant) {
+            case Variant::NO_LOG:
+                break;
+            case Variant::RUNTIME_FILTERED:
+                AsyncLogger::log(AsyncLogger::Level::TRACE, INPUT_EVENTS_TAG, "EVENT: MOUSE_MOVE (x={}, y={}, mods={})",
+                                 ev.x, ev.y, modsToCStr(ev.mods));
+                break;
+            case Variant::COMPILE_TIME_FILTERED:
+                logTraceTagged(INPUT_EVENTS_TAG, "EVENT: MOUSE_MOVE (x={}, y={}, mods={})",
+                               ev.x, ev.y, modsToCStr(ev.mods));
+                break;
+        }
+    }
+
+    return benchNowSeconds() - start;
+}
+
+const char* modsToCStr(u32 mods) {
+    // Stands in for keyModifiersToCptr, which builds the string into a static buffer on every call.
+    static char buf[32];
+    constexpr const char* NAMES[] = { "NONE", "SHIFT", "CTRL", "ALT" };
+    const char* name = NAMES[mods & 3];
+    addr_size len = core::cstrLen(name);
+    core::memcopy(buf, name, len + 1);
+    g_sink += i64(len);
+    return buf;
+}
+
+} // namespace
@@ -0,0 +1,72 @@
+#include "./bench.h"
+
+#include <app_logger.h>
+#include <memory_tracker.h>
+
+#include <iostream>
+
+namespace {
+
+struct BenchCommand {
+    const char* name;
+    i32 (*run)(core::Memory<const char*> args);
+    const char* usage;
+};
+
+constexpr BenchCommand BENCH_COMMANDS[] = {
+    { "mesh_codec",   runMeshCodecBench,   "<file.stl>..." },
+    { "async_io",     runAsyncIoBench,     "<file.stl>..." },
+    { "frame_arena",  runFrameArenaBench,  "[frames] [objects]" },
+    { "log_overhead", runLogOverheadBench, "[events]" },
+#if defined(USE_X11)
+    { "x11_events",   runX11EventsBench,   "[burst_size] [bursts]" },
+#endif
+};
+
+void assertHandler(const char* failedExpr, const char* file, i32 line, const char* funcName, const char* errMsg) {
+    std::cout << "[ASSERTION]:\n  [EXPR]: " << failedExpr
+              << "\n  [FUNC]: " << funcName
+              << "\n  [FILE]: " << file << ":" << line
+              << "\n  [MSG]: " << (errMsg ? errMsg : "") << std::endl;
+    throw std::runtime_error("Assertion failed!");
+}
+
+void printUsage() {
+    logInfo("Usage: stlv_bench <command> [args]");
+    for (auto& cmd : BENCH_COMMANDS) {
+        logInfo("\t{} {}", cmd.name, cmd.usage);
+    }
+}
+
+} // namespace
+
+i32 main(i32 argc, const char** argv) {
+    core::LoggerCreateInfo loggerCreateInfo = core::LoggerCreateInfo::createDefault();
+    if (!core::initLogger(loggerCreateInfo)) {
+        std::cout << "Failed to initialize core logger" << std::endl;
+        return -1;
+    }
+    core::setLogLevel(core::LogLevel::L_INFO);
+    core::setLoggerTag(APP_TAG, appLogTagsToCStr(APP_TAG));
+    core::setLoggerTag(LOADER_TAG, appLogTagsToCStr(LOADER_TAG));
+
+    core::initProgramCtx(assertHandler,
+                         &loggerCreateInfo,
+                         core::createAllocatorCtx(&MemoryTracker::allocator()));
+    defer { core::destroyProgramCtx(); };
+
+    if (argc < 2) {
+        printUsage();
+        return -1;
+    }
+
+    core::Memory<const char*> args = { argv + 2, addr_size(argc - 2) };
+    for (auto& cmd : BENCH_COMMANDS) {
+        if (core::memcmp(argv[1], core::cstrLen(argv[1]), cmd.name, core::cstrLen(cmd.name)) == 0) {
+            return cmd.run(args);
+        }
+    }
+
+    printUsage();
+    return -1;
+}
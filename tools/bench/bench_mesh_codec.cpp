@@ -0,0 +1,103 @@
+#include "./bench.h"
+
+#include <app_logger.h>
+#include <mesh_codec.h>
+#include <stl_loader.h>
+
+namespace {
+
+constexpr i32 DECODE_ITERATIONS = 20;
+
+void benchFile(const char* path);
+
+} // namespace
+
+i32 runMeshCodecBench(core::Memory<const char*> paths) {
+    if (paths.len() == 0) {
+        logErr("mesh_codec: expected at least one STL file");
+        return -1;
+    }
+
+    for (addr_size i = 0; i < paths.len(); i++) {
+        benchFile(paths[i]);
+    }
+
+    return 0;
+}
+
+namespace {
+
+void benchFile(const char* path) {
+    logInfo(ANSI_BOLD("{}"), path);
+
+    core::ArrList<u8> fileBytes;
+    if (auto res = core::fileReadEntire(path, fileBytes); res.hasErr()) {
+        logErr("Failed to read file: {}", path);
+        return;
+    }
+
+    f64 parseStart = benchNowSeconds();
+    auto parseRes = StlMesh::parse(fileBytes.memView());
+    f64 parseTime = benchNowSeconds() - parseStart;
+    if (parseRes.hasErr()) {
+        logErr("Failed to parse file: {}", path);
+        return;
+    }
+    StlMesh& mesh = parseRes.value();
+
+    f64 quantizeStart = benchNowSeconds();
+    MeshCodec::QuantizedMesh qmesh = MeshCodec::quantize(mesh);
+    f64 quantizeTime = benchNowSeconds() - quantizeStart;
+
+    // Encode
+    core::ArrList<u8> encodedPositions (MeshCodec::encodePositionsBound(qmesh.vertexCount()), u8(0));
+    core::ArrList<u8> encodedIndices (MeshCodec::encodeIndicesBound(qmesh.indices.len()), u8(0));
+    f64 encodeStart = benchNowSeconds();
+    addr_size positionsSize = MeshCodec::encodePositions(encodedPositions.memView(), qmesh.positions.memView());
+    addr_size indicesSize = MeshCodec::encodeIndices(encodedIndices.memView(), qmesh.indices.memView());
+    f64 encodeTime = benchNowSeconds() - encodeStart;
+    Assert(positionsSize > 0 && indicesSize > 0, "Encode buffers are too small");
+
+    // Decode, keeping the best time to filter out noise from the rest of the system.
+    core::ArrList<u16> decodedPositions (qmesh.positions.len(), u16(0));
+    core::ArrList<u32> decodedIndices (qmesh.indices.len(), u32(0));
+    core::Memory<const u8> positionsView = { encodedPositions.data(), positionsSize };
+    core::Memory<const u8> indicesView = { encodedIndices.data(), indicesSize };
+
+    f64 bestPositionsTime = 1e9;
+    f64 bestIndicesTime = 1e9;
+    for (i32 i = 0; i < DECODE_ITERATIONS; i++) {
+        f64 start = benchNowSeconds();
+        bool ok = MeshCodec::decodePositions(decodedPositions.memView(), positionsView);
+        f64 mid = benchNowSeconds();
+        ok = ok && MeshCodec::decodeIndices(decodedIndices.memView(), indicesView);
+        f64 end = benchNowSeconds();
+        Panic(ok, "Failed to decode");
+
+        if (mid - start < bestPositionsTime) bestPositionsTime = mid - start;
+        if (end - mid < bestIndicesTime) bestIndicesTime = end - mid;
+    }
+
+    Panic(core::memcmp(decodedPositions.data(), qmesh.positions.data(), qmesh.positions.len() * sizeof(u16)) == 0,
+          "Decoded positions do not match");
+    Panic(core::memcmp(decodedIndices.data(), qmesh.indices.data(), qmesh.indices.len() * sizeof(u32)) == 0,
+          "Decoded indices do not match");
+
+    const addr_size rawPositionsSize = qmesh.positions.len() * sizeof(u16);
+    const addr_size rawIndicesSize = qmesh.indices.len() * sizeof(u32);
+    const addr_size encodedSize = positionsSize + indicesSize;
+    constexpr f64 GB = 1024.0 * 1024.0 * 1024.0;
+
+    logInfo("triangles: {}, vertices: {} (welded from {})",
+            mesh.triangleCount(), qmesh.vertexCount(), mesh.vertexCount());
+    logInfo("parse: {}ms, quantize+weld: {}ms, encode: {}ms",
+            parseTime * 1000.0, quantizeTime * 1000.0, encodeTime * 1000.0);
+    logInfo("size: stl={}, quantized={}, encoded={} (positions={}, indices={})",
+            fileBytes.len(), rawPositionsSize + rawIndicesSize, encodedSize, positionsSize, indicesSize);
+    logInfo("ratio: vs stl={}, vs quantized={}",
+            f64(encodedSize) / f64(fileBytes.len()), f64(encodedSize) / f64(rawPositionsSize + rawIndicesSize));
+    logInfo("decode: positions={} GB/s, indices={} GB/s",
+            f64(rawPositionsSize) / GB / bestPositionsTime, f64(rawIndicesSize) / GB / bestIndicesTime);
+}
+
+} // namespace
@@ -0,0 +1,151 @@
+#include "./bench.h"
+
+#include <app_logger.h>
+#include <platform.h>
+
+#include <X11/Xlib.h>
+
+#include <thread>
+
+namespace {
+
+constexpr i32 DEFAULT_BURST_SIZE = 1000;
+constexpr i32 DEFAULT_BURSTS = 20;
+constexpr i32 FRAME_MS = 4; // Simulated frame time between polls.
+constexpr i32 RESIZE_EVERY = 50; // One ConfigureNotify per this many motion events.
+constexpr i32 MARKER_X = 100000; // The last motion event of burst b has x = MARKER_X + b.
+
+struct BurstStats {
+    i32 moves = 0;
+    i32 resizes = 0;
+    i32 lastMarker = -1;
+    u64 totalAgeNs = 0; // Sum over all events of the time between the platform reading and the app consuming them.
+    i32 events = 0;
+};
+
+BurstStats g_burst;
+InputEventQueue g_queue;
+
+void drainQueue();
+void injectBurst(Display* display, Window window, i32 burstIdx, i32 burstSize);
+
+} // namespace
+
+i32 runX11EventsBench(core::Memory<const char*> args) {
+    i32 burstSize = benchParseIntArg(args, 0, DEFAULT_BURST_SIZE);
+    i32 bursts = benchParseIntArg(args, 1, DEFAULT_BURSTS);
+    if (burstSize <= 0 || bursts <= 0) {
+        logErr("x11_events: burst size and count must be positive");
+        return -1;
+    }
+
+    if (auto err = Platform::init("stlv_bench", 800, 600); !err.isOk()) {
+        logErr("Failed to initialize the platform layer: {}", err.toCStr());
+        return -1;
+    }
+    defer { Platform::shutdown(); };
+
+    void* displayPtr = nullptr;
+    unsigned long window = 0;
+    Platform::getX11Handles(displayPtr, window);
+    Display* display = reinterpret_cast<Display*>(displayPtr);
+
+    // Let the window get mapped and drain the startup events.
+    for (i32 i = 0; i < 50; i++) {
+        if (auto err = Platform::pollEvents(g_queue, false); !err.isOk()) return -1;
+        g_queue.clear();
+        std::this_thread::sleep_for(std::chrono::milliseconds(FRAME_MS));
+    }
+
+    f64 totalLatency = 0;
+    f64 maxLatency = 0;
+    i64 totalFrames = 0;
+    i64 totalMoves = 0;
+    i64 totalResizes = 0;
+    u64 totalAgeNs = 0;
+    i64 totalEvents = 0;
+
+    for (i32 b = 0; b < bursts; b++) {
+        g_burst = {};
+
+        f64 start = benchNowSeconds();
+        injectBurst(display, Window(window), b, burstSize);
+
+        // Simulated frame loop, poll once per frame until the last event of the burst was delivered.
+        i32 frames = 0;
+        while (g_burst.lastMarker != b) {
+            frames++;
+            if (auto err = Platform::pollEvents(g_queue, false); !err.isOk()) return -1;
+            drainQueue();
+            if (g_burst.lastMarker == b) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(FRAME_MS));
+        }
+        f64 latency = benchNowSeconds() - start;
+
+        totalLatency += latency;
+        if (latency > maxLatency) maxLatency = latency;
+        totalFrames += frames;
+        totalMoves += g_burst.moves;
+        totalResizes += g_burst.resizes;
+        totalAgeNs += g_burst.totalAgeNs;
+        totalEvents += g_burst.events;
+    }
+
+    logInfo(ANSI_BOLD("x11_events"));
+    logInfo("bursts: {}, events per burst: {} motion + {} configure",
+            bursts, burstSize, burstSize / RESIZE_EVERY);
+    logInfo("input to frame latency: avg={}ms, max={}ms, frames to drain: avg={}",
+            totalLatency / bursts * 1000.0, maxLatency * 1000.0, f64(totalFrames) / bursts);
+    logInfo("events per burst: move={}, resize={}, dropped total: {}",
+            f64(totalMoves) / bursts, f64(totalResizes) / bursts, g_queue.droppedCount());
+    logInfo("queued event age at consumption: avg={}us",
+            totalEvents > 0 ? f64(totalAgeNs) / f64(totalEvents) / 1000.0 : 0.0);
+
+    return 0;
+}
+
+namespace {
+
+void drainQueue() {
+    u64 now = inputTimestampNs();
+    InputEvent ev;
+    while (g_queue.pop(ev)) {
+        g_burst.events++;
+        g_burst.totalAgeNs += now - ev.timestampNs;
+
+        if (ev.type == InputEventType::MOUSE_MOVE) {
+            g_burst.moves++;
+            if (ev.move.x >= MARKER_X) g_burst.lastMarker = ev.move.x - MARKER_X;
+        }
+        else if (ev.type == InputEventType::WINDOW_RESIZE) {
+            g_burst.resizes++;
+        }
+    }
+}
+
+void injectBurst(Display* display, Window window, i32 burstIdx, i32 burstSize) {
+    for (i32 i = 0; i < burstSize; i++) {
+        XEvent ev = {};
+        ev.xmotion.type = MotionNotify;
+        ev.xmotion.display = display;
+        ev.xmotion.window = window;
+        ev.xmotion.x = (i == burstSize - 1) ? MARKER_X + burstIdx : i % 800;
+        ev.xmotion.y = i % 600;
+        XSendEvent(display, window, False, PointerMotionMask, &ev);
+
+        if (i % RESIZE_EVERY == RESIZE_EVERY - 1) {
+            // Alternate the size so that the platform layer does not filter them out as unchanged.
+            XEvent cfg = {};
+            cfg.xconfigure.type = ConfigureNotify;
+            cfg.xconfigure.display = display;
+            cfg.xconfigure.event = window;
+            cfg.xconfigure.window = window;
+            cfg.xconfigure.width = 800 + (i / RESIZE_EVERY) % 2;
+            cfg.xconfigure.height = 600;
+            XSendEvent(display, window, False, StructureNotifyMask, &cfg);
+        }
+    }
+    XFlush(display);
+}
+
+} // namespace